@@ -29,12 +29,17 @@
 #include <tournament.h>
 #include <gamemanager.h>
 #include <sprt.h>
+#include <board/tablebasecache.h>
+#include "tournamentfile.h"
 
 EngineMatch::EngineMatch(Tournament* tournament, QObject* parent)
 	: QObject(parent),
 	  m_tournament(tournament),
 	  m_debug(false),
-	  m_ratingInterval(0)
+	  m_ratingInterval(0),
+	  m_tournamentFile(0),
+	  m_tablesValid(false),
+	  m_roundLength(2)
 {
 	Q_ASSERT(tournament != 0);
 
@@ -44,6 +49,7 @@ EngineMatch::EngineMatch(Tournament* tournament, QObject* parent)
 EngineMatch::~EngineMatch()
 {
 	qDeleteAll(m_books);
+	delete m_tournamentFile;
 }
 
 OpeningBook* EngineMatch::addOpeningBook(const QString& fileName)
@@ -98,31 +104,118 @@ void EngineMatch::setRatingInterval(int interval)
 	m_ratingInterval = interval;
 }
 
-void EngineMatch::setTournamentFile(QString& tournamentFile)
+void EngineMatch::setTournamentFile(TournamentFile* file)
 {
-	m_tournamentFile = tournamentFile;
+	delete m_tournamentFile;
+	m_tournamentFile = file;
 }
 
-void EngineMatch::generateSchedule(QVariantList& pList)
+void EngineMatch::rebuildTables()
 {
-	QVariantMap pMap;
+	m_schedule.clear();
+	m_crossTable.clear();
+	m_crossTableIndex.clear();
+	m_roundLength = 2;
+
+	// The pairings don't change during the tournament, but the names
+	// of the players may, so they're cached as player indexes
+	if (!m_tablesValid) {
+		QHash<QString, int> playerIndex;
+		for (int i = m_tournament->playerCount() - 1; i >= 0; i--)
+			playerIndex[m_tournament->playerAt(i).builder->name()] = i;
+
+		QList< QPair<QString, QString> > pairings = m_tournament->getPairings();
+		m_pairings.clear();
+		m_pairings.reserve(pairings.size());
+		for (int i = 0; i < pairings.size(); i++)
+			m_pairings.append(qMakePair(playerIndex.value(pairings.at(i).first, -1),
+						    playerIndex.value(pairings.at(i).second, -1)));
+		m_pairingNames = pairings;
+	}
 
-	QList< QPair<QString, QString> > pairings = m_tournament->getPairings();
-	if (pairings.isEmpty()) return;
+	for (int i = 0; i < m_tournament->playerCount(); i++)
+		addCrossTableEntry(m_tournament->playerAt(i).builder->name());
 
-	int maxName = 5, maxTerm = 11, maxFen = 9;
+	const QVariantList& pList = m_tournamentFile->matchProgress();
+	m_schedule.resize(pList.size());
 	for (int i = 0; i < pList.size(); i++) {
-		int len;
-		pMap = pList.at(i).toMap();
-		if (pMap.contains("terminationDetails")) {
-			len = pMap["terminationDetails"].toString().length();
-			if (len > maxTerm) maxTerm = len;
+		QVariantMap pMap = pList.at(i).toMap();
+		updateSchedule(i, pMap);
+		addResult(pMap);
+	}
+	m_tablesValid = true;
+}
+
+void EngineMatch::updateSchedule(int index, const QVariantMap& pMap)
+{
+	if (index >= m_schedule.size())
+		m_schedule.resize(index + 1);
+
+	ScheduleEntry& entry = m_schedule[index];
+	entry = ScheduleEntry();
+	if (pMap.isEmpty())
+		return;
+
+	if (pMap.contains("white")) // TODO error check against the pairings
+		entry.whiteName = pMap["white"].toString();
+	if (pMap.contains("black"))
+		entry.blackName = pMap["black"].toString();
+	if (pMap.contains("startTime"))
+		entry.startTime = pMap["startTime"].toString();
+	if (pMap.contains("result")) {
+		QString result = pMap["result"].toString();
+		if (result == "*") {
+			entry.whiteResult = entry.blackResult = result;
+		} else if (result == "1-0") {
+			entry.whiteResult = "1";
+			entry.blackResult = "0";
+		} else if (result == "0-1") {
+			entry.blackResult = "1";
+			entry.whiteResult = "0";
+		} else {
+			entry.whiteResult = entry.blackResult = "1/2";
 		}
-		if (pMap.contains("finalFen")) {
-			len = pMap["finalFen"].toString().length();
-			if (len > maxFen) maxFen = len;
+	}
+	if (pMap.contains("terminationDetails"))
+		entry.termination = pMap["terminationDetails"].toString();
+	if (pMap.contains("gameDuration"))
+		entry.duration = pMap["gameDuration"].toString();
+	if (pMap.contains("finalFen"))
+		entry.finalFen = pMap["finalFen"].toString();
+	if (pMap.contains("ECO"))
+		entry.eco = pMap["ECO"].toString();
+	if (pMap.contains("opening"))
+		entry.opening = pMap["opening"].toString();
+	if (pMap.contains("variation")) {
+		QString variation = pMap["variation"].toString();
+		if (!variation.isEmpty())
+			entry.opening += ", " + variation;
+	}
+	if (pMap.contains("plyCount"))
+		entry.plies = pMap["plyCount"].toString();
+	if (pMap.contains("whiteEval"))
+		entry.whiteEval = pMap["whiteEval"].toString();
+	if (pMap.contains("blackEval")) {
+		entry.blackEval = pMap["blackEval"].toString();
+		if (entry.blackEval.at(0) == '-') {
+			entry.blackEval.remove(0, 1);
+		} else {
+			if (entry.blackEval != "0.00")
+				entry.blackEval = "-" + entry.blackEval;
 		}
 	}
+}
+
+void EngineMatch::generateSchedule()
+{
+	if (m_pairings.isEmpty()) return;
+
+	int maxName = 5, maxTerm = 11, maxFen = 9;
+	for (int i = 0; i < m_schedule.size(); i++) {
+		const ScheduleEntry& entry = m_schedule.at(i);
+		maxTerm = qMax(maxTerm, entry.termination.length());
+		maxFen = qMax(maxFen, entry.finalFen.length());
+	}
 
 	// now check the player list for maxName
 	int playerCount = m_tournament->playerCount();
@@ -131,13 +224,13 @@ void EngineMatch::generateSchedule(QVariantList& pList)
 		if (len > maxName) maxName = len;
 	}
 
-	QString scheduleFile(m_tournamentFile);
+	QString scheduleFile(m_tournamentFile->fileName());
 	QString scheduleText;
 
 	scheduleFile = scheduleFile.remove(".json") + "_schedule.txt";
 
 	scheduleText = QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11 %12 %13 %14\n")
-		.arg("Nr", pairings.size() >= 100 ? 3 : 2)
+		.arg("Nr", m_pairings.size() >= 100 ? 3 : 2)
 		.arg("White", maxName)
 		.arg("", 3)
 		.arg("", -3)
@@ -152,280 +245,206 @@ void EngineMatch::generateSchedule(QVariantList& pList)
 		.arg("FinalFen", -maxFen)
 		.arg("Opening");
 
-	if (!pairings.isEmpty()) {
-		QList< QPair<QString, QString> >::iterator i;
-		int count = 0;
-		for (i = pairings.begin(); i != pairings.end(); ++i, ++count) {
-			QString whiteName, blackName, whiteResult, blackResult, termination, startTime, duration, ECO, finalFen, opening;
-			QString whiteEval, blackEval;
-			QString plies = 0;
-
-			whiteName = i->first;
-			blackName = i->second;
-
-			if (count < pList.size()) {
-				pMap = pList.at(count).toMap();
-				if (!pMap.isEmpty()) {
-					if (pMap.contains("white")) // TODO error check against above
-						whiteName = pMap["white"].toString();
-					if (pMap.contains("black"))
-						blackName = pMap["black"].toString();
-					if (pMap.contains("startTime"))
-						startTime = pMap["startTime"].toString();
-					if (pMap.contains("result")) {
-						QString result = pMap["result"].toString();
-						if (result == "*") {
-							whiteResult = blackResult = result;
-						} else if (result == "1-0") {
-							whiteResult = "1";
-							blackResult = "0";
-						} else if (result == "0-1") {
-							blackResult = "1";
-							whiteResult = "0";
-						} else {
-							whiteResult = blackResult = "1/2";
-						}
-					}
-					if (pMap.contains("terminationDetails"))
-						termination = pMap["terminationDetails"].toString();
-					if (pMap.contains("gameDuration"))
-						duration = pMap["gameDuration"].toString();
-					if (pMap.contains("finalFen"))
-						finalFen = pMap["finalFen"].toString();
-					if (pMap.contains("ECO"))
-						ECO = pMap["ECO"].toString();
-					if (pMap.contains("opening"))
-						opening = pMap["opening"].toString();
-					if (pMap.contains("variation")) {
-						QString variation = pMap["variation"].toString();
-						if (!variation.isEmpty())
-							opening += ", " + variation;
-					}
-					if (pMap.contains("plyCount"))
-						plies = pMap["plyCount"].toString();
-					if (pMap.contains("whiteEval"))
-						whiteEval = pMap["whiteEval"].toString();
-					if (pMap.contains("blackEval")) {
-						blackEval = pMap["blackEval"].toString();
-						if (blackEval.at(0) == '-') {
-							blackEval.remove(0, 1);
-						} else {
-							if (blackEval != "0.00")
-								blackEval = "-" + blackEval;
-						}
-					}
-				}
-			}
-			scheduleText += QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11 %12 %13 %14\n")
-				.arg(QString::number(count+1), pairings.size() >= 100 ? 3 : 2)
-				.arg(whiteName, maxName)
-				.arg(whiteResult, 3)
-				.arg(blackResult, -3)
-				.arg(blackName, -maxName)
-				.arg(termination, -maxTerm)
-				.arg(plies, 3)
-				.arg(whiteEval, 7)
-				.arg(blackEval, -7)
-				.arg(startTime, -22)
-				.arg(duration, 8)
-				.arg(ECO, 3)
-				.arg(finalFen, -maxFen)
-				.arg(opening);
+	const ScheduleEntry emptyEntry;
+	for (int count = 0; count < m_pairings.size(); count++) {
+		const ScheduleEntry& entry = count < m_schedule.size() ?
+			m_schedule.at(count) : emptyEntry;
+		QString whiteName(entry.whiteName);
+		QString blackName(entry.blackName);
+
+		if (whiteName.isEmpty()) {
+			int player = m_pairings.at(count).first;
+			whiteName = player >= 0 ? m_tournament->playerAt(player).builder->name()
+						: m_pairingNames.at(count).first;
 		}
-		QFile output(scheduleFile);
-		if (!output.open(QIODevice::WriteOnly | QIODevice::Text)) {
-			qWarning("cannot open tournament configuration file: %s", qPrintable(scheduleFile));
-		} else {
-			QTextStream out(&output);
-			out.setCodec(QTextCodec::codecForName("latin1")); // otherwise output is converted to ASCII
-			out << scheduleText;
+		if (blackName.isEmpty()) {
+			int player = m_pairings.at(count).second;
+			blackName = player >= 0 ? m_tournament->playerAt(player).builder->name()
+						: m_pairingNames.at(count).second;
 		}
+
+		scheduleText += QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11 %12 %13 %14\n")
+			.arg(QString::number(count+1), m_pairings.size() >= 100 ? 3 : 2)
+			.arg(whiteName, maxName)
+			.arg(entry.whiteResult, 3)
+			.arg(entry.blackResult, -3)
+			.arg(blackName, -maxName)
+			.arg(entry.termination, -maxTerm)
+			.arg(entry.plies, 3)
+			.arg(entry.whiteEval, 7)
+			.arg(entry.blackEval, -7)
+			.arg(entry.startTime, -22)
+			.arg(entry.duration, 8)
+			.arg(entry.eco, 3)
+			.arg(entry.finalFen, -maxFen)
+			.arg(entry.opening);
+	}
+	QFile output(scheduleFile);
+	if (!output.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		qWarning("cannot open tournament configuration file: %s", qPrintable(scheduleFile));
+	} else {
+		QTextStream out(&output);
+		out.setCodec(QTextCodec::codecForName("latin1")); // otherwise output is converted to ASCII
+		out << scheduleText;
 	}
 }
 
-struct CrossTableData
+int EngineMatch::crossTableIndex(const QString& name)
 {
-public:
-
-	CrossTableData(QString engineName, int elo = 0) :
-		m_score(0),
-		m_neustadtlScore(0),
-		m_gamesPlayedAsWhite(0),
-		m_gamesPlayedAsBlack(0),
-		m_winsAsWhite(0),
-		m_winsAsBlack(0)
-	{
-		m_engineName = engineName;
-		m_elo = elo;
-	};
-
-	CrossTableData() :
-	m_score(0),
-	m_neustadtlScore(0),
-	m_elo(0),
-	m_gamesPlayedAsWhite(0),
-	m_gamesPlayedAsBlack(0),
-	m_winsAsWhite(0),
-	m_winsAsBlack(0)
-	{
+	QHash<QString, int>::const_iterator it = m_crossTableIndex.constFind(name);
+	if (it != m_crossTableIndex.constEnd())
+		return it.value();
+
+	// The players may have been renamed after their first game
+	for (int i = 0; i < m_crossTable.size() && i < m_tournament->playerCount(); i++) {
+		if (m_tournament->playerAt(i).builder->name() == name) {
+			m_crossTableIndex.insert(name, i);
+			return i;
+		}
+	}
 
-	};
+	return addCrossTableEntry(name);
+}
 
-	bool isEmpty() { return m_engineName.isEmpty(); }
+int EngineMatch::addCrossTableEntry(const QString& name)
+{
+	int index = m_crossTable.size();
+	CrossTableEntry entry;
+	entry.index = index;
+	entry.name = name;
+	m_crossTable.append(entry);
+	for (int i = 0; i <= index; i++) {
+		CrossTableEntry& ctd = m_crossTable[i];
+		ctd.results.resize(index + 1);
+		ctd.wins.resize(index + 1);
+		ctd.draws.resize(index + 1);
+	}
+	if (!m_crossTableIndex.contains(name))
+		m_crossTableIndex.insert(name, index);
 
-	QString m_engineName;
-	QString m_engineAbbrev;
-	double m_score;
-	double m_neustadtlScore;
-	int m_elo;
-	int m_gamesPlayedAsWhite;
-	int m_gamesPlayedAsBlack;
-	int m_winsAsWhite;
-	int m_winsAsBlack;
-	QMap<QString, QString> m_tableData;
-};
+	return index;
+}
 
-bool sortCrossTableDataByScore(const CrossTableData &s1, const CrossTableData &s2)
+void EngineMatch::addResult(const QVariantMap& pMap)
 {
-	if (s1.m_score == s2.m_score) {
-		if (s1.m_neustadtlScore == s2.m_neustadtlScore) {
-			if (s1.m_gamesPlayedAsBlack == s2.m_gamesPlayedAsBlack) {
-				if ((s1.m_winsAsWhite + s1.m_winsAsBlack) == (s2.m_winsAsWhite + s2.m_winsAsBlack)) {
-					return (s1.m_winsAsBlack > s2.m_winsAsBlack);
+	if (!pMap.contains("white") || !pMap.contains("black") || !pMap.contains("result"))
+		return;
+
+	QString result = pMap["result"].toString();
+	if (result == "*")
+		return; // game in progress or invalid or something
+
+	int white = crossTableIndex(pMap["white"].toString());
+	int black = crossTableIndex(pMap["black"].toString());
+	CrossTableEntry& whiteData = m_crossTable[white];
+	CrossTableEntry& blackData = m_crossTable[black];
+	QString& whiteDataString = whiteData.results[black];
+	QString& blackDataString = blackData.results[white];
+
+	if (result == "1-0") {
+		whiteData.score += 1;
+		whiteData.winsAsWhite++;
+		whiteData.wins[black]++;
+		whiteDataString += "1";
+		blackDataString += "0";
+	} else if (result == "0-1") {
+		blackData.score += 1;
+		blackData.winsAsBlack++;
+		blackData.wins[white]++;
+		whiteDataString += "0";
+		blackDataString += "1";
+	} else if (result == "1/2-1/2") {
+		whiteData.score += 0.5;
+		blackData.score += 0.5;
+		whiteData.draws[black]++;
+		blackData.draws[white]++;
+		whiteDataString += "=";
+		blackDataString += "=";
+	}
+	m_roundLength = qMax(m_roundLength, whiteDataString.length());
+	m_roundLength = qMax(m_roundLength, blackDataString.length());
+	whiteData.gamesPlayedAsWhite++;
+	blackData.gamesPlayedAsBlack++;
+}
+
+bool EngineMatch::sortCrossTableDataByScore(const CrossTableEntry& s1,
+					    const CrossTableEntry& s2)
+{
+	if (s1.score == s2.score) {
+		if (s1.neustadtlScore == s2.neustadtlScore) {
+			if (s1.gamesPlayedAsBlack == s2.gamesPlayedAsBlack) {
+				if ((s1.winsAsWhite + s1.winsAsBlack) == (s2.winsAsWhite + s2.winsAsBlack)) {
+					return (s1.winsAsBlack > s2.winsAsBlack);
 				} else {
-					return (s1.m_winsAsWhite + s1.m_winsAsBlack) > (s2.m_winsAsWhite + s2.m_winsAsBlack);
+					return (s1.winsAsWhite + s1.winsAsBlack) > (s2.winsAsWhite + s2.winsAsBlack);
 				}
 			} else {
-				return s1.m_gamesPlayedAsBlack > s2.m_gamesPlayedAsBlack;
+				return s1.gamesPlayedAsBlack > s2.gamesPlayedAsBlack;
 			}
 		} else {
-			return s1.m_neustadtlScore > s2.m_neustadtlScore;
+			return s1.neustadtlScore > s2.neustadtlScore;
 		}
 	}
-	return s1.m_score > s2.m_score;
+	return s1.score > s2.score;
 }
 
-void EngineMatch::generateCrossTable(QVariantList& pList)
+void EngineMatch::generateCrossTable()
 {
 	int playerCount = m_tournament->playerCount();
-	QMap<QString, CrossTableData> ctMap;
+	int entryCount = m_crossTable.size();
 	QStringList abbrevList;
-	int roundLength = 2;
+	int roundLength = m_roundLength;
 	int maxName = 6;
 
 	// ensure names and abbreviations
-	for (int i = 0; i < playerCount; i++) {
-		CrossTableData ctd(m_tournament->playerAt(i).builder->name(), m_tournament->playerAt(i).builder->rating());
-		if (ctd.m_engineName.length() > maxName) maxName = ctd.m_engineName.length();
+	for (int i = 0; i < entryCount; i++) {
+		CrossTableEntry& ctd = m_crossTable[i];
+		if (i < playerCount) {
+			ctd.name = m_tournament->playerAt(i).builder->name();
+			ctd.elo = m_tournament->playerAt(i).builder->rating();
+		}
+		if (ctd.name.length() > maxName) maxName = ctd.name.length();
+		if (ctd.name.isEmpty()) continue;
 
 		int n = 1;
 		QString abbrev;
-		abbrev.append(ctd.m_engineName.at(0).toUpper()).append(ctd.m_engineName.length() > n ? ctd.m_engineName.at(n++).toLower() : ' ');
+		abbrev.append(ctd.name.at(0).toUpper()).append(ctd.name.length() > n ? ctd.name.at(n++).toLower() : ' ');
 		while (abbrevList.contains(abbrev)) {
-			abbrev[1] = ctd.m_engineName.length() > n ? ctd.m_engineName.at(n++).toLower() : ' ';
+			abbrev[1] = ctd.name.length() > n ? ctd.name.at(n++).toLower() : ' ';
 		}
-		ctd.m_engineAbbrev = abbrev;
+		ctd.abbrev = abbrev;
 		abbrevList.append(abbrev);
-		ctMap.insert(ctd.m_engineName, ctd);
 	}
 
-	// calculate scores and crosstable strings
-	for (int i = 0; i < pList.size(); i++) {
-		QVariantMap pMap = pList.at(i).toMap();
-		if (pMap.contains("white") && pMap.contains("black") && pMap.contains("result")) {
-			QString whiteName = pMap["white"].toString();
-			QString blackName = pMap["black"].toString();
-			QString result = pMap["result"].toString();
-			CrossTableData& whiteData = ctMap[whiteName];
-			CrossTableData& blackData = ctMap[blackName];
-			QString& whiteDataString = whiteData.m_tableData[blackName];
-			QString& blackDataString = blackData.m_tableData[whiteName];
-
-			if (result == "*") {
-				continue; // game in progress or invalid or something
-			}
-			if (result == "1-0") {
-				whiteData.m_score += 1;
-				whiteData.m_winsAsWhite++;
-				whiteDataString += "1";
-				blackDataString += "0";
-			} else if (result == "0-1") {
-				blackData.m_score += 1;
-				blackData.m_winsAsBlack++;
-				whiteDataString += "0";
-				blackDataString += "1";
-			} else if (result == "1/2-1/2") {
-				whiteData.m_score += 0.5;
-				blackData.m_score += 0.5;
-				whiteDataString += "=";
-				blackDataString += "=";
-			}
-			if (whiteDataString.length() > roundLength) roundLength = whiteDataString.length();
-			if (blackDataString.length() > roundLength) roundLength = blackDataString.length();
-			whiteData.m_gamesPlayedAsWhite++;
-			blackData.m_gamesPlayedAsBlack++;
-		}
-	}
 	// calculate SB
-	QMapIterator<QString, CrossTableData> ct(ctMap);
 	double largestSB = 0;
 	double largestScore = 0;
-	while (ct.hasNext()) {
-		ct.next();
-		CrossTableData& ctd = ctMap[ct.key()];
-		QMapIterator<QString, QString> td(ctd.m_tableData);
+	for (int i = 0; i < entryCount; i++) {
+		CrossTableEntry& ctd = m_crossTable[i];
 		double sb = 0;
-		while (td.hasNext()) {
-			td.next();
-			QString::ConstIterator c = td.value().begin();
-			while (c != td.value().end()) {
-				if (*c == QChar('1')) {
-					sb += ctMap[td.key()].m_score;
-				} else if (*c == QChar('=')) {
-					sb += ctMap[td.key()].m_score / 2.;
-				}
-				c++;
-			}
-		}
-		ctd.m_neustadtlScore = sb;
-		if (ctd.m_neustadtlScore > largestSB) largestSB = ctd.m_neustadtlScore;
-		if (ctd.m_score > largestScore) largestScore = ctd.m_score;
+		for (int j = 0; j < entryCount; j++)
+			sb += (ctd.wins.at(j) + ctd.draws.at(j) / 2.) * m_crossTable.at(j).score;
+		ctd.neustadtlScore = sb;
+		if (ctd.neustadtlScore > largestSB) largestSB = ctd.neustadtlScore;
+		if (ctd.score > largestScore) largestScore = ctd.score;
 	}
 
-	if (playerCount == 2) {
-		roundLength = 2;
-		QVariantMap pMap = pList.at(0).toMap();
-		if (pMap.contains("white") && pMap.contains("black")) {
-			QString whiteName = pMap["white"].toString();
-			QString blackName = pMap["black"].toString();
-			CrossTableData& whiteData = ctMap[whiteName];
-			CrossTableData& blackData = ctMap[blackName];
-			QString& whiteDataString = whiteData.m_tableData[blackName];
-			QString& blackDataString = blackData.m_tableData[whiteName];
-			int whiteWin = 0;
-			int whiteLose = 0;
-			int whiteDraw = 0;
-
-			for (int i = 0; i < whiteDataString.length(); i++) {
-				if (whiteDataString[i] == '1')
-					whiteWin++;
-				else if (whiteDataString[i] == '0')
-					whiteLose++;
-				else
-					whiteDraw++;
-			}
-			whiteDataString = QString("+ %1 = %2 - %3")
-				.arg(whiteWin)
-				.arg(whiteDraw)
-				.arg(whiteLose);
-			blackDataString = QString("+ %1 = %2 - %3")
-				.arg(whiteLose)
-				.arg(whiteDraw)
-				.arg(whiteWin);
-
-			if (whiteDataString.length() > roundLength) roundLength = whiteDataString.length();
-			if (blackDataString.length() > roundLength) roundLength = blackDataString.length();
-		}
+	// with two players the results are summed up
+	QVector<QString> matchResults;
+	if (playerCount == 2 && entryCount == 2) {
+		int whiteWin = m_crossTable.at(0).wins.at(1);
+		int whiteLose = m_crossTable.at(1).wins.at(0);
+		int whiteDraw = m_crossTable.at(0).draws.at(1);
+
+		matchResults.append(QString("+ %1 = %2 - %3")
+			.arg(whiteWin)
+			.arg(whiteDraw)
+			.arg(whiteLose));
+		matchResults.append(QString("+ %1 = %2 - %3")
+			.arg(whiteLose)
+			.arg(whiteDraw)
+			.arg(whiteWin));
+		roundLength = qMax(matchResults.at(0).length(), matchResults.at(1).length());
 	}
 
 	int maxScore = largestScore >= 100 ? 5 : largestScore >= 10 ? 4 : 3;
@@ -441,35 +460,38 @@ void EngineMatch::generateCrossTable(QVariantList& pList)
 
 	QString crossTableBodyText;
 
-	QList<CrossTableData> list = ctMap.values();
+	QList<CrossTableEntry> list = m_crossTable.toList();
 	qSort(list.begin(), list.end(), sortCrossTableDataByScore);
-	QList<CrossTableData>::iterator i;
+	QList<CrossTableEntry>::const_iterator i;
 	int count = 1;
-	for (i = list.begin(); i != list.end(); ++i, ++count) {
-		crossTableHeaderText += QString(" %1").arg(i->m_engineAbbrev, -roundLength);
+	for (i = list.constBegin(); i != list.constEnd(); ++i, ++count) {
+		crossTableHeaderText += QString(" %1").arg(i->abbrev, -roundLength);
 
 		crossTableBodyText += QString("%1 %2 %3 %4 %5 %6")
 			.arg(count, 2)
-			.arg(i->m_engineName, -maxName)
-			.arg(i->m_elo, 4)
-			.arg(i->m_score, maxScore, 'f', 1)
-			.arg(i->m_gamesPlayedAsWhite + i->m_gamesPlayedAsBlack, maxGames)
-			.arg(i->m_neustadtlScore, maxSB, 'f', 2);
-
-		QList<CrossTableData>::iterator j;
-		for (j = list.begin(); j != list.end(); ++j) {
-			if (j->m_engineName == i->m_engineName) {
+			.arg(i->name, -maxName)
+			.arg(i->elo, 4)
+			.arg(i->score, maxScore, 'f', 1)
+			.arg(i->gamesPlayedAsWhite + i->gamesPlayedAsBlack, maxGames)
+			.arg(i->neustadtlScore, maxSB, 'f', 2);
+
+		QList<CrossTableEntry>::const_iterator j;
+		for (j = list.constBegin(); j != list.constEnd(); ++j) {
+			if (j->index == i->index) {
 				crossTableBodyText += " ";
 				int rl = roundLength;
 				while(rl--) crossTableBodyText += "\u00B7";
-			} else crossTableBodyText += QString(" %1").arg(i->m_tableData[j->m_engineName], -roundLength);
+			} else if (!matchResults.isEmpty())
+				crossTableBodyText += QString(" %1").arg(matchResults.at(i->index), -roundLength);
+			else
+				crossTableBodyText += QString(" %1").arg(i->results.at(j->index), -roundLength);
 		}
 		crossTableBodyText += "\n";
 	}
 
 	QString crossTableText = crossTableHeaderText + "\n\n" + crossTableBodyText;
 
-	QString crossTableFile(m_tournamentFile);
+	QString crossTableFile(m_tournamentFile->fileName());
 	crossTableFile = crossTableFile.remove(".json") + "_crosstable.txt";
 
 	QFile output(crossTableFile);
@@ -492,33 +514,11 @@ void EngineMatch::onGameStarted(ChessGame* game, int number)
 		   qPrintable(game->player(Chess::Side::White)->name()),
 		   qPrintable(game->player(Chess::Side::Black)->name()));
 
-	if (!m_tournamentFile.isEmpty()) {
-		QVariantMap tfMap;
-		if (QFile::exists(m_tournamentFile)) {
-			QFile input(m_tournamentFile);
-			if (!input.open(QIODevice::ReadOnly | QIODevice::Text)) {
-				qWarning("cannot open tournament configuration file: %s", qPrintable(m_tournamentFile));
-				return;
-			}
-
-			QTextStream stream(&input);
-			JsonParser jsonParser(stream);
-			tfMap = jsonParser.parse().toMap();
-		}
-
-		QVariantList pList;
-		if (!tfMap.isEmpty()) {
-			if (tfMap.contains("matchProgress")) {
-				pList = tfMap["matchProgress"].toList();
-				int length = pList.length();
-				if (length >= number) {
-					qWarning("game %d already exists, deleting", number);
-					while(length-- >= number) {
-						pList.removeLast();
-					}
-				}
-			}
-		}
+	if (m_tournamentFile != 0) {
+		// replacing old games requires recounting the results
+		bool replacesGames = m_tournamentFile->matchProgress().length() >= number;
+		if (replacesGames)
+			qWarning("game %d already exists, deleting", number);
 
 		QVariantMap pMap;
 		pMap.insert("index", number);
@@ -528,20 +528,15 @@ void EngineMatch::onGameStarted(ChessGame* game, int number)
 		pMap.insert("startTime", qdt.toString("HH:mm:ss' on 'yyyy.MM.dd"));
 		pMap.insert("result", "*");
 		pMap.insert("terminationDetails", "in progress");
-		pList.append(pMap);
-		tfMap.insert("matchProgress", pList);
-		{
-			QFile output(m_tournamentFile);
-			if (!output.open(QIODevice::WriteOnly | QIODevice::Text)) {
-				qWarning("cannot open tournament configuration file: %s", qPrintable(m_tournamentFile));
-			} else {
-				QTextStream out(&output);
-				JsonSerializer serializer(tfMap);
-				serializer.serialize(out);
-			}
-		}
-		generateSchedule(pList);
-		generateCrossTable(pList);
+		if (!m_tournamentFile->setGame(pMap))
+			qWarning("cannot write tournament configuration file: %s", qPrintable(m_tournamentFile->fileName()));
+
+		if (!m_tablesValid || replacesGames)
+			rebuildTables();
+		else
+			updateSchedule(m_tournamentFile->matchProgress().size() - 1, pMap);
+		generateSchedule();
+		generateCrossTable();
 	}
 }
 
@@ -556,94 +551,71 @@ void EngineMatch::onGameFinished(ChessGame* game, int number)
 		   qPrintable(game->player(Chess::Side::Black)->name()),
 		   qPrintable(result.toVerboseString()));
 
-		if (!m_tournamentFile.isEmpty()) {
-			QVariantMap tfMap;
-
-			if (QFile::exists(m_tournamentFile)) {
-			QFile input(m_tournamentFile);
-			if (!input.open(QIODevice::ReadOnly | QIODevice::Text)) {
-				qWarning("cannot open tournament configuration file: %s", qPrintable(m_tournamentFile));
-			} else {
-				QTextStream stream(&input);
-				JsonParser jsonParser(stream);
-				tfMap = jsonParser.parse().toMap();
-			}
-
-			QVariantMap pMap;
-			QVariantList pList;
-
-			if (!tfMap.isEmpty()) {
-				if (tfMap.contains("matchProgress")) {
-					pList = tfMap["matchProgress"].toList();
-					int length = pList.length();
-					if (length < number) {
-						qWarning("game %d doesn't exist", number);
-					} else
-						pMap = pList.at(number-1).toMap();
-				}
+	if (m_tournamentFile != 0) {
+		QVariantMap pMap;
+		if (m_tournamentFile->matchProgress().length() < number)
+			qWarning("game %d doesn't exist", number);
+		else
+			pMap = m_tournamentFile->matchProgress().at(number-1).toMap();
+
+		if (!pMap.isEmpty()) {
+			pMap.insert("result", result.toShortString());
+			pMap.insert("terminationDetails", result.shortDescription());
+			PgnGame *pgn = game->pgn();
+			if (pgn) {
+				const EcoInfo eco = pgn->eco();
+				QString val;
+				val = eco.ecoCode();
+				if (!val.isEmpty()) pMap.insert("ECO", val);
+				val = eco.opening();
+				if (!val.isEmpty()) pMap.insert("opening", val);
+				val = eco.variation();
+				if (!val.isEmpty()) pMap.insert("variation", val);
+				// TODO: after TCEC is over, change this to moveCount, since that's what it is
+				pMap.insert("plyCount", qRound(game->moves().size() / 2.));
 			}
+			pMap.insert("finalFen", game->board()->fenString());
 
-			if (!pMap.isEmpty()) {
-				pMap.insert("result", result.toShortString());
-				pMap.insert("terminationDetails", result.shortDescription());
-				PgnGame *pgn = game->pgn();
-				if (pgn) {
-					const EcoInfo eco = pgn->eco();
-					QString val;
-					val = eco.ecoCode();
-					if (!val.isEmpty()) pMap.insert("ECO", val);
-					val = eco.opening();
-					if (!val.isEmpty()) pMap.insert("opening", val);
-					val = eco.variation();
-					if (!val.isEmpty()) pMap.insert("variation", val);
-					// TODO: after TCEC is over, change this to moveCount, since that's what it is
-					pMap.insert("plyCount", qRound(game->moves().size() / 2.));
-				}
-				pMap.insert("finalFen", game->board()->fenString());
+			MoveEvaluation eval;
+			QString sScore;
+			Chess::Side sides[] = { Chess::Side::White, Chess::Side::Black, Chess::Side::NoSide };
 
-				MoveEvaluation eval;
+			for (int i = 0; sides[i] != Chess::Side::NoSide; i++) {
+				Chess::Side side = sides[i];
+				MoveEvaluation eval = game->player(side)->evaluation();
+				int score = eval.score();
+				int absScore = qAbs(score);
 				QString sScore;
-				Chess::Side sides[] = { Chess::Side::White, Chess::Side::Black, Chess::Side::NoSide };
-
-				for (int i = 0; sides[i] != Chess::Side::NoSide; i++) {
-					Chess::Side side = sides[i];
-					MoveEvaluation eval = game->player(side)->evaluation();
-					int score = eval.score();
-					int absScore = qAbs(score);
-					QString sScore;
-
-					// Detect mate-in-n scores
-					if (absScore > 9900
-					&&	(absScore = 1000 - (absScore % 1000)) < 100)
-					{
-						if (score < 0)
-							sScore = "-";
-						sScore += "M" + QString::number(absScore);
-					}
-					else
-						sScore = QString::number(double(score) / 100.0, 'f', 2);
-
-					if (side == Chess::Side::White)
-						pMap.insert("whiteEval", sScore);
-					else
-						pMap.insert("blackEval", sScore);
+
+				// Detect mate-in-n scores
+				if (absScore > 9900
+				&&	(absScore = 1000 - (absScore % 1000)) < 100)
+				{
+					if (score < 0)
+						sScore = "-";
+					sScore += "M" + QString::number(absScore);
 				}
+				else
+					sScore = QString::number(double(score) / 100.0, 'f', 2);
+
+				if (side == Chess::Side::White)
+					pMap.insert("whiteEval", sScore);
+				else
+					pMap.insert("blackEval", sScore);
+			}
 
-				pMap.insert("gameDuration", game->gameDuration());
-				pList.replace(number-1, pMap);
-				tfMap.insert("matchProgress", pList);
+			pMap.insert("gameDuration", game->gameDuration());
+			if (!m_tournamentFile->setGame(pMap))
+				qWarning("cannot write tournament configuration file: %s", qPrintable(m_tournamentFile->fileName()));
 
-				QFile output(m_tournamentFile);
-				if (!output.open(QIODevice::WriteOnly | QIODevice::Text)) {
-					qWarning("cannot open tournament configuration file: %s", qPrintable(m_tournamentFile));
-				} else {
-					QTextStream out(&output);
-					JsonSerializer serializer(tfMap);
-					serializer.serialize(out);
-				}
-				generateSchedule(pList);
-				generateCrossTable(pList);
+			if (!m_tablesValid)
+				rebuildTables();
+			else {
+				updateSchedule(number - 1, pMap);
+				addResult(pMap);
 			}
+			generateSchedule();
+			generateCrossTable();
 		}
 	}
 
@@ -689,6 +661,16 @@ void EngineMatch::onTournamentFinished()
 		}
 	}
 
+	const TablebaseCache* tbCache = m_tournament->tablebaseCache();
+	if (tbCache->hits() + tbCache->misses() > 0)
+		qDebug("Tablebase cache: %llu hits, %llu misses",
+		       (unsigned long long)tbCache->hits(),
+		       (unsigned long long)tbCache->misses());
+
+	// Compact the journal so that the JSON file is complete
+	if (m_tournamentFile != 0 && !m_tournamentFile->save())
+		qWarning("cannot write tournament configuration file: %s", qPrintable(m_tournamentFile->fileName()));
+
 	qDebug("Finished match");
 	connect(m_tournament->gameManager(), SIGNAL(finished()),
 		this, SIGNAL(finished()));
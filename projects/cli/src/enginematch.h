@@ -20,6 +20,9 @@
 
 #include <QObject>
 #include <QMap>
+#include <QHash>
+#include <QVector>
+#include <QPair>
 #include <QString>
 #include <QElapsedTimer>
 #include <QtGlobal>
@@ -33,6 +36,7 @@
 class ChessGame;
 class OpeningBook;
 class Tournament;
+class TournamentFile;
 
 
 class EngineMatch : public QObject
@@ -46,7 +50,7 @@ class EngineMatch : public QObject
 		OpeningBook* addOpeningBook(const QString& fileName);
 		void setDebugMode(bool debug);
 		void setRatingInterval(int interval);
-		void setTournamentFile(QString &tournamentFile);
+		void setTournamentFile(TournamentFile* file);
 
 		void start();
 		void stop();
@@ -61,16 +65,77 @@ class EngineMatch : public QObject
 		void print(const QString& msg);
 
 	private:
+		struct ScheduleEntry
+		{
+			QString whiteName;
+			QString blackName;
+			QString whiteResult;
+			QString blackResult;
+			QString termination;
+			QString plies;
+			QString whiteEval;
+			QString blackEval;
+			QString startTime;
+			QString duration;
+			QString eco;
+			QString finalFen;
+			QString opening;
+		};
+		struct CrossTableEntry
+		{
+			CrossTableEntry()
+				: index(0),
+				  elo(0),
+				  score(0),
+				  neustadtlScore(0),
+				  gamesPlayedAsWhite(0),
+				  gamesPlayedAsBlack(0),
+				  winsAsWhite(0),
+				  winsAsBlack(0)
+			{
+			}
+
+			int index;
+			QString name;
+			QString abbrev;
+			int elo;
+			double score;
+			double neustadtlScore;
+			int gamesPlayedAsWhite;
+			int gamesPlayedAsBlack;
+			int winsAsWhite;
+			int winsAsBlack;
+			// Results, wins and draws against each opponent by index
+			QVector<QString> results;
+			QVector<int> wins;
+			QVector<int> draws;
+		};
+
+		static bool sortCrossTableDataByScore(const CrossTableEntry& s1,
+						      const CrossTableEntry& s2);
+
 		void printRanking();
-		void generateSchedule(QVariantList& pList);
-		void generateCrossTable(QVariantList& pList);
+		void rebuildTables();
+		void updateSchedule(int index, const QVariantMap& pMap);
+		int crossTableIndex(const QString& name);
+		int addCrossTableEntry(const QString& name);
+		void addResult(const QVariantMap& pMap);
+		void generateSchedule();
+		void generateCrossTable();
 
 		Tournament* m_tournament;
 		bool m_debug;
 		int m_ratingInterval;
 		QMap<QString, OpeningBook*> m_books;
 		QElapsedTimer m_startTime;
-		QString m_tournamentFile;
+		TournamentFile* m_tournamentFile;
+		bool m_tablesValid;
+		QVector< QPair<int, int> > m_pairings;
+		QList< QPair<QString, QString> > m_pairingNames;
+		QVector<ScheduleEntry> m_schedule;
+		QVector<CrossTableEntry> m_crossTable;
+		QHash<QString, int> m_crossTableIndex;
+		int m_roundLength;
 };
 
 #endif // ENGINEMATCH_H
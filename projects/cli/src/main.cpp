@@ -43,6 +43,7 @@
 #include "cutechesscoreapp.h"
 #include "matchparser.h"
 #include "enginematch.h"
+#include "tournamentfile.h"
 
 void sigintHandler(int param);
 
@@ -286,6 +287,17 @@ static bool parseEngine(const QStringList& args, EngineData& data)
 		{
 			data.config.setWhiteEvalPov(true);
 		}
+		else if (name == "infointerval")
+		{
+			bool ok = false;
+			int interval = val.toInt(&ok);
+			if (!ok || interval < 0)
+			{
+				qWarning() << "Invalid info interval:" << val;
+				return false;
+			}
+			data.config.setInfoInterval(interval);
+		}
 		else if (name == "depth")
 		{
 			if (val.toInt() <= 0)
@@ -324,6 +336,7 @@ static EngineMatch* parseMatch(const QStringList& args, QObject* parent)
 	parser.addOption("-each", QVariant::StringList, 1);
 	parser.addOption("-variant", QVariant::String, 1, 1);
 	parser.addOption("-concurrency", QVariant::Int, 1, 1);
+	parser.addOption("-threadpool", QVariant::Int, 1, 1);
 	parser.addOption("-draw", QVariant::StringList);
 	parser.addOption("-resign", QVariant::StringList);
 	parser.addOption("-tb", QVariant::String, 1, 1);
@@ -339,6 +352,7 @@ static EngineMatch* parseMatch(const QStringList& args, QObject* parent)
 	parser.addOption("-openings", QVariant::StringList);
 	parser.addOption("-pgnout", QVariant::StringList, 1, 2);
 	parser.addOption("-livepgnout", QVariant::StringList, 1, 2);
+	parser.addOption("-pgnflush", QVariant::Int, 1, 1);
 	parser.addOption("-repeat", QVariant::Bool, 0, 0);
 	parser.addOption("-recover", QVariant::Bool, 0, 0);
 	parser.addOption("-site", QVariant::String, 1, 1);
@@ -358,24 +372,24 @@ static EngineMatch* parseMatch(const QStringList& args, QObject* parent)
 	bool wantsDebug = parser.takeOption("-debug").toBool();
 
 	QString tournamentFile = parser.takeOption("-tournamentfile").toString();
+	TournamentFile* tFile = 0;
 	bool usingTournamentFile = false;
 
 	if (!tournamentFile.isEmpty()) {
 		if (!tournamentFile.endsWith(".json"))
 			tournamentFile.append(".json");
-		if (QFile::exists(tournamentFile)) {
-			QFile input(tournamentFile);
-			if (!input.open(QIODevice::ReadOnly | QIODevice::Text)) {
-				qWarning("cannot open tournament configuration file: %s", qPrintable(tournamentFile));
-				return 0;
-			}
-
-			QTextStream stream(&input);
-			JsonParser jsonParser(stream);
+		tFile = new TournamentFile(tournamentFile);
+		if (tFile->exists()) {
 			// we don't want to use the tournament file at all unless wantResume == true
 			wantsResume = parser.takeOption("-resume").toBool();
 			if (wantsResume) {
-				tfMap = jsonParser.parse().toMap();
+				// the snapshot is updated with the games in the journal
+				if (!tFile->load()) {
+					qWarning("cannot open tournament configuration file: %s", qPrintable(tournamentFile));
+					delete tFile;
+					return 0;
+				}
+				tfMap = tFile->data();
 				if (tfMap.contains("tournamentSettings"))
 					tMap = tfMap["tournamentSettings"].toMap();
 				if (tfMap.contains("engineSettings"))
@@ -427,7 +441,7 @@ static EngineMatch* parseMatch(const QStringList& args, QObject* parent)
 	}
 
 	EngineMatch* match = new EngineMatch(tournament, parent);
-	if (!tournamentFile.isEmpty()) match->setTournamentFile(tournamentFile);
+	if (tFile != 0) match->setTournamentFile(tFile);
 
 	GameAdjudicator adjudicator;
 	MatchParser::Option openingsOption = {"", QVariant()};
@@ -460,6 +474,8 @@ static EngineMatch* parseMatch(const QStringList& args, QObject* parent)
 			else
 				tournament->setPgnOutput(tMap["pgnOutput"].toString());
 		}
+		if (tMap.contains("pgnFlushInterval"))
+			tournament->setPgnFlushInterval(tMap["pgnFlushInterval"].toInt());
 		if (tMap.contains("livePgnOutput")) {
 			if (tMap.contains("livePgnOutMode"))
 				tournament->setLivePgnOutput(tMap["livePgnOutput"].toString(), (PgnGame::PgnMode)tMap["livePgnOutMode"].toInt());
@@ -473,6 +489,8 @@ static EngineMatch* parseMatch(const QStringList& args, QObject* parent)
 
 		if (tMap.contains("concurrency"))
 			manager->setConcurrency(tMap["concurrency"].toInt());
+		if (tMap.contains("workerThreads"))
+			manager->setWorkerThreadCount(tMap["workerThreads"].toInt());
 		if (tMap.contains("drawAdjudication")) {
 			QVariantMap dMap = tMap["drawAdjudication"].toMap();
 			if (dMap.contains("movenumber") &&
@@ -597,6 +615,13 @@ static EngineMatch* parseMatch(const QStringList& args, QObject* parent)
 					tMap.insert("concurrency", value.toInt());
 				}
 			}
+			else if (name == "-threadpool") {
+				ok = value.toInt() > 0;
+				if (ok) {
+					manager->setWorkerThreadCount(value.toInt());
+					tMap.insert("workerThreads", value.toInt());
+				}
+			}
 			// Threshold for draw adjudication
 			else if (name == "-draw") {
 				QMap<QString, QString> params =
@@ -721,6 +746,11 @@ static EngineMatch* parseMatch(const QStringList& args, QObject* parent)
 					tMap.insert("pgnOutMode", mode);
 				}
 			}
+			// Maximum time to buffer the games before writing them
+			else if (name == "-pgnflush") {
+				tournament->setPgnFlushInterval(value.toInt());
+				tMap.insert("pgnFlushInterval", value.toInt());
+			}
 			else if (name == "-livepgnout") {
 				PgnGame::PgnMode mode = PgnGame::Verbose;
 				QStringList list = value.toStringList();
@@ -867,13 +897,7 @@ static EngineMatch* parseMatch(const QStringList& args, QObject* parent)
 		return 0;
 	}
 
-	if (!tournamentFile.isEmpty() && !tMap.isEmpty()) {
-		QFile output(tournamentFile);
-		if (!output.open(QIODevice::WriteOnly | QIODevice::Text)) {
-			qWarning("cannot open tournament configuration file: %s", qPrintable(tournamentFile));
-			return 0;
-		}
-
+	if (tFile != 0 && !tMap.isEmpty()) {
 		if (!wantsResume || !tMap.contains("eventDate")) {
 			QString eventDate = QDate::currentDate().toString("yyyy.MM.dd");
 			tournament->setEventDate(eventDate);
@@ -884,9 +908,11 @@ static EngineMatch* parseMatch(const QStringList& args, QObject* parent)
 		eMap.insert("engines", eList);
 		tfMap.insert("engineSettings", eMap);
 
-		QTextStream out(&output);
-		JsonSerializer serializer(tfMap);
-		serializer.serialize(out);
+		tFile->setData(tfMap);
+		if (!tFile->save()) {
+			qWarning("cannot open tournament configuration file: %s", qPrintable(tournamentFile));
+			return 0;
+		}
 	}
 
 	tournament->setAdjudicator(adjudicator);
@@ -1,8 +1,10 @@
 DEPENDPATH += $$PWD
 HEADERS += $$PWD/enginematch.h \
     $$PWD/cutechesscoreapp.h \
-    $$PWD/matchparser.h
+    $$PWD/matchparser.h \
+    $$PWD/tournamentfile.h
 SOURCES += $$PWD/main.cpp \
     $$PWD/cutechesscoreapp.cpp \
     $$PWD/enginematch.cpp \
-    $$PWD/matchparser.cpp
+    $$PWD/matchparser.cpp \
+    $$PWD/tournamentfile.cpp
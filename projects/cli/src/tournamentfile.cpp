@@ -0,0 +1,204 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tournamentfile.h"
+#include <jsonreader.h>
+#include <jsonwriter.h>
+#if QT_VERSION >= 0x050100
+#include <QSaveFile>
+#else
+#include <QTemporaryFile>
+#endif
+
+namespace {
+
+// The journal is compacted when it holds more records than this or
+// than there are games in the tournament, whichever is larger
+const int s_minJournalRecords = 64;
+
+QString journalFileName(const QString& fileName)
+{
+	QString name(fileName);
+	if (name.endsWith(".json"))
+		name.chop(5);
+	return name + "_journal.txt";
+}
+
+} // anonymous namespace
+
+TournamentFile::TournamentFile(const QString& fileName)
+	: m_fileName(fileName),
+	  m_journal(journalFileName(fileName)),
+	  m_sequence(0),
+	  m_journalRecords(0)
+{
+}
+
+QString TournamentFile::fileName() const
+{
+	return m_fileName;
+}
+
+bool TournamentFile::exists() const
+{
+	return QFile::exists(m_fileName) || m_journal.exists();
+}
+
+bool TournamentFile::load()
+{
+	m_journal.close();
+	m_data.clear();
+	m_progress.clear();
+	m_sequence = 0;
+	m_journalRecords = 0;
+
+	if (QFile::exists(m_fileName))
+	{
+		QFile input(m_fileName);
+		if (!input.open(QIODevice::ReadOnly | QIODevice::Text))
+			return false;
+
+		JsonReader reader(input.readAll());
+		m_data = reader.parse().toMap();
+		m_progress = m_data.take("matchProgress").toList();
+		m_sequence = m_data.take("journalSequence").toInt();
+	}
+
+	if (!m_journal.open(QIODevice::ReadOnly | QIODevice::Text))
+		return true;
+
+	// Records that are already in the snapshot are skipped. Replay
+	// stops at the first record that can't be parsed, which is
+	// one that was being written when the program was interrupted.
+	JsonReader reader(m_journal.readAll());
+	forever
+	{
+		const QVariantMap record = reader.parse().toMap();
+		if (reader.hasError() || record.isEmpty())
+			break;
+
+		int sequence = record["sequence"].toInt();
+		if (sequence <= m_sequence)
+			continue;
+
+		applyGame(record["game"].toMap());
+		m_sequence = sequence;
+		m_journalRecords++;
+	}
+	m_journal.close();
+
+	return true;
+}
+
+bool TournamentFile::save()
+{
+	QVariantMap map(data());
+	map.insert("journalSequence", m_sequence);
+
+	QByteArray bytes;
+	JsonWriter writer(map);
+	if (!writer.serialize(bytes))
+		return false;
+
+#if QT_VERSION >= 0x050100
+	QSaveFile output(m_fileName);
+	if (!output.open(QIODevice::WriteOnly | QIODevice::Text)
+	||  output.write(bytes) != bytes.size()
+	||  !output.commit())
+		return false;
+#else
+	// Concurrent writers each get their own temporary file
+	QTemporaryFile output(m_fileName + ".XXXXXX");
+	if (!output.open()
+	||  output.write(bytes) != bytes.size())
+		return false;
+	output.close();
+	if (output.error() != QFile::NoError)
+		return false;
+	QFile::remove(m_fileName);
+	if (!output.rename(m_fileName))
+		return false;
+	output.setAutoRemove(false);
+#endif
+
+	// The snapshot is complete, so the journal can go. If this fails
+	// the records are skipped by their sequence numbers anyway.
+	m_journal.close();
+	m_journal.remove();
+	m_journalRecords = 0;
+
+	return true;
+}
+
+QVariantMap TournamentFile::data() const
+{
+	QVariantMap map(m_data);
+	if (!m_progress.isEmpty())
+		map.insert("matchProgress", m_progress);
+	return map;
+}
+
+void TournamentFile::setData(const QVariantMap& data)
+{
+	m_data = data;
+	m_progress = m_data.take("matchProgress").toList();
+	m_data.remove("journalSequence");
+}
+
+const QVariantList& TournamentFile::matchProgress() const
+{
+	return m_progress;
+}
+
+bool TournamentFile::setGame(const QVariantMap& game)
+{
+	applyGame(game);
+
+	if (++m_journalRecords > qMax(s_minJournalRecords, m_progress.size()))
+		return save();
+
+	QVariantMap record;
+	record.insert("sequence", ++m_sequence);
+	record.insert("game", game);
+
+	QByteArray bytes;
+	JsonWriter writer(record);
+	if (!writer.serialize(bytes))
+		return false;
+
+	// Each record is appended with a single write
+	if (!m_journal.isOpen()
+	&&  !m_journal.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+		return false;
+	return m_journal.write(bytes) == bytes.size() && m_journal.flush();
+}
+
+void TournamentFile::applyGame(const QVariantMap& game)
+{
+	int index = game["index"].toInt();
+	if (index < 1)
+		return;
+
+	if (game["result"] == "*")
+	{
+		while (m_progress.size() >= index)
+			m_progress.removeLast();
+		m_progress.append(game);
+	}
+	else if (index <= m_progress.size())
+		m_progress.replace(index - 1, game);
+}
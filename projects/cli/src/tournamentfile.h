@@ -0,0 +1,93 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TOURNAMENTFILE_H
+#define TOURNAMENTFILE_H
+
+#include <QString>
+#include <QVariant>
+#include <QFile>
+
+
+/*!
+ * \brief The state of a tournament, kept in a JSON file.
+ *
+ * The tournament settings and the progress of the games are kept in
+ * memory. Changes to single games are appended to a journal file next
+ * to the JSON file instead of rewriting the whole JSON file, and the
+ * journal is periodically compacted into a new snapshot of the JSON
+ * file. The snapshot is written to a temporary file first and then
+ * renamed, so an interrupted write never corrupts the previous state.
+ *
+ * load() reads the snapshot and replays the journal on top of it.
+ */
+class TournamentFile
+{
+	public:
+		/*! Creates a new tournament file object for \a fileName. */
+		TournamentFile(const QString& fileName);
+
+		/*! Returns the name of the JSON file. */
+		QString fileName() const;
+		/*! Returns true if the tournament has been saved before. */
+		bool exists() const;
+
+		/*!
+		 * Reads the snapshot and replays the journal.
+		 *
+		 * A partially written record at the end of the journal is
+		 * ignored. Returns false if the snapshot can't be read.
+		 */
+		bool load();
+		/*!
+		 * Writes a snapshot of the tournament and clears the journal.
+		 *
+		 * Returns true if successful; otherwise returns false.
+		 */
+		bool save();
+
+		/*! Returns the tournament data, including "matchProgress". */
+		QVariantMap data() const;
+		/*! Sets the tournament data to \a data. */
+		void setData(const QVariantMap& data);
+
+		/*! Returns the list of games in "matchProgress". */
+		const QVariantList& matchProgress() const;
+		/*!
+		 * Stores \a game, a "matchProgress" entry, and appends it
+		 * to the journal.
+		 *
+		 * A game in progress (result "*") replaces the games starting
+		 * from its index. A finished game replaces the entry at its
+		 * index.
+		 *
+		 * Returns true if successful; otherwise returns false.
+		 */
+		bool setGame(const QVariantMap& game);
+
+	private:
+		void applyGame(const QVariantMap& game);
+
+		QString m_fileName;
+		QFile m_journal;
+		QVariantMap m_data;
+		QVariantList m_progress;
+		int m_sequence;
+		int m_journalRecords;
+};
+
+#endif // TOURNAMENTFILE_H
@@ -103,7 +103,7 @@ void MoveList::setGame(ChessGame* game, PgnGame* pgn)
 	{
 		const PgnGame::MoveData& md = pgn->moves().at(m_moveCount);
 		insertHtmlMove(htmlMove(m_moveCount, m_startingSide,
-					md.moveString, md.comment));
+					md.moveString, pgn->moveComment(m_moveCount)));
 	}
 
 	if (m_game != 0)
@@ -22,6 +22,8 @@
 
 #include <pgnstream.h>
 #include <pgngameentry.h>
+#include <parallelpgnreader.h>
+#include <pgnindex.h>
 #include "pgndatabase.h"
 
 PgnImporter::PgnImporter(const QString& fileName, QObject* parent)
@@ -60,27 +62,48 @@ void PgnImporter::run()
 		return;
 	}
 
-	PgnStream pgnStream(&file);
-	QList<const PgnGameEntry*> games;
+	// Only the games that aren't in the index file have to be read
+	PgnIndex index(m_fileName);
+	index.load();
+	numReadGames = index.count();
 
-	forever
+	PgnStream pgnStream(&file);
+	if (index.scanPos() < file.size()
+	&&  pgnStream.seek(index.scanPos(), index.scanLineNumber()))
 	{
-		PgnGameEntry* game = new PgnGameEntry;
-		if (m_abort || !game->read(pgnStream))
+		// The reader reads ahead, so the stream may already be
+		// past the last game that was indexed
+		qint64 pos;
+		qint64 lineNumber;
 		{
-			delete game;
-			break;
+			ParallelPgnReader reader(pgnStream,
+						 ParallelPgnReader::GameEntries);
+			forever
+			{
+				PgnGameEntry* game = new PgnGameEntry;
+				if (m_abort || !reader.readEntry(*game))
+				{
+					delete game;
+					break;
+				}
+
+				index.addEntry(game);
+				numReadGames++;
+
+				if (numReadGames % updateInterval == 0)
+					emit databaseReadStatus(startTime, numReadGames,
+					    game->pos());
+			}
+			pos = reader.pos();
+			lineNumber = reader.lineNumber();
 		}
 
-		games << game;
-		numReadGames++;
-
-		if (numReadGames % updateInterval == 0)
-			emit databaseReadStatus(startTime, numReadGames,
-			    pgnStream.pos());
+		if (!m_abort)
+			index.save(pos, lineNumber);
 	}
+
 	PgnDatabase* db = new PgnDatabase(m_fileName);
-	db->setEntries(games);
+	db->setEntries(index.takeEntries());
 	db->setLastModified(fileInfo.lastModified());
 
 	emit databaseRead(db);
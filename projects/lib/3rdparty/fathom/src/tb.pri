@@ -10,3 +10,4 @@ SOURCES += $$PWD/tbprobe.c
 HEADERS += $$PWD/tbprobe.h \
 	$$PWD/tbconfig.h \
 	$$PWD/tbcore.h
+unix:LIBS += -lpthread
@@ -77,15 +77,29 @@ static struct TBEntry_pawn TB_pawn[TBMAX_PAWN];
 
 static struct TBHashEntry TB_hash[1 << TBHASHBITS][HSHMAX];
 
-#define DTZ_ENTRIES 64
-
-static struct DTZTableEntry DTZ_table[DTZ_ENTRIES];
-
 static void init_indices(void);
 static uint64_t calc_key_from_pcs(int *pcs, int mirror);
 static void free_wdl_entry(struct TBEntry *entry);
 static void free_dtz_entry(struct TBEntry *entry);
 
+// Every WDL entry owns the DTZ entry of the same material signature.
+// DTZ entries are loaded on first use and stay mapped until the
+// tablebases are re-initialized, so probes never have to evict (and
+// free) a table that another thread may still be reading.
+static struct TBEntry **dtz_entry(struct TBEntry *entry)
+{
+  if (entry->has_pawns)
+    return &((struct TBEntry_pawn *)entry)->dtz;
+  return &((struct TBEntry_piece *)entry)->dtz;
+}
+
+static ubyte *dtz_ready(struct TBEntry *entry)
+{
+  if (entry->has_pawns)
+    return &((struct TBEntry_pawn *)entry)->dtz_ready;
+  return &((struct TBEntry_piece *)entry)->dtz_ready;
+}
+
 /* A replacement for strncpy().
    Uses NUL termination even when the string has to be truncated.  */
 static size_t safe_strncpy(char *dst, const char *src, size_t size)
@@ -299,6 +313,8 @@ static void init_tb(char *str)
   }
   entry->key = key;
   entry->ready = 0;
+  *dtz_entry(entry) = NULL;
+  *dtz_ready(entry) = 0;
   entry->num = 0;
   for (i = 0; i < 16; i++)
     entry->num += pcs[i];
@@ -346,14 +362,15 @@ void init_tablebases(const char *path)
     for (i = 0; i < TBnum_piece; i++) {
       entry = (struct TBEntry *)&TB_piece[i];
       free_wdl_entry(entry);
+      if (*dtz_entry(entry))
+	free_dtz_entry(*dtz_entry(entry));
     }
     for (i = 0; i < TBnum_pawn; i++) {
       entry = (struct TBEntry *)&TB_pawn[i];
       free_wdl_entry(entry);
+      if (*dtz_entry(entry))
+	free_dtz_entry(*dtz_entry(entry));
     }
-    for (i = 0; i < DTZ_ENTRIES; i++)
-      if (DTZ_table[i].entry)
-	free_dtz_entry(DTZ_table[i].entry);
   } else {
     init_indices();
     initialized = 1;
@@ -391,9 +408,6 @@ void init_tablebases(const char *path)
       TB_hash[i][j].ptr = NULL;
     }
 
-  for (i = 0; i < DTZ_ENTRIES; i++)
-    DTZ_table[i].entry = NULL;
-
   for (i = 1; i < 6; i++) {
     snprintf(str, 16, "K%cvK", pchr[i]);
     init_tb(str);
@@ -1633,26 +1647,16 @@ static ubyte decompress_pairs(struct PairsData *d, uint64 idx)
   return *(sympat + 3 * sym);
 }
 
-void load_dtz_table(char *str, uint64 key1, uint64 key2)
+static struct TBEntry *load_dtz_table(char *str, struct TBEntry *ptr)
 {
-  int i;
-  struct TBEntry *ptr, *ptr3;
-  struct TBHashEntry *ptr2;
-
-  DTZ_table[0].key1 = key1;
-  DTZ_table[0].key2 = key2;
-  DTZ_table[0].entry = NULL;
-
-  // find corresponding WDL entry
-  ptr2 = TB_hash[key1 >> (64 - TBHASHBITS)];
-  for (i = 0; i < HSHMAX; i++)
-    if (ptr2[i].key == key1) break;
-  if (i == HSHMAX) return;
-  ptr = ptr2[i].ptr;
+  struct TBEntry *ptr3;
 
-  ptr3 = (struct TBEntry *)malloc(ptr->has_pawns
+  // Zeroed, so that free_dtz_entry() only frees what was set up
+  ptr3 = (struct TBEntry *)calloc(1, ptr->has_pawns
 				? sizeof(struct DTZEntry_pawn)
 				: sizeof(struct DTZEntry_piece));
+  if (!ptr3)
+    return NULL;
 
   ptr3->data = map_file(str, DTZSUFFIX, &ptr3->mapping);
   ptr3->key = ptr->key;
@@ -1667,10 +1671,11 @@ void load_dtz_table(char *str, uint64 key1, uint64 key2)
     struct DTZEntry_piece *entry = (struct DTZEntry_piece *)ptr3;
     entry->enc_type = ((struct TBEntry_piece *)ptr)->enc_type;
   }
-  if (!init_table_dtz(ptr3))
-    free(ptr3);
-  else
-    DTZ_table[0].entry = ptr3;
+  if (!init_table_dtz(ptr3)) {
+    free_dtz_entry(ptr3);
+    return NULL;
+  }
+  return ptr3;
 }
 
 static void free_wdl_entry(struct TBEntry *entry)
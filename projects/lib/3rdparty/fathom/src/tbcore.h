@@ -36,6 +36,31 @@
 #define UNLOCK(x)       /* NOP */
 #endif
 
+/* Tables are loaded lazily and published with a "ready" flag. The flag
+   is stored with release and read with acquire semantics, so a thread
+   that sees it set also sees the fully initialized table. */
+#if defined(__GNUC__)
+#define TB_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define TB_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#elif defined(_MSC_VER)
+static __inline unsigned char tb_load_acquire(const unsigned char *p)
+{
+  unsigned char v = *(const volatile unsigned char *)p;
+  MemoryBarrier();
+  return v;
+}
+static __inline void tb_store_release(unsigned char *p, unsigned char v)
+{
+  MemoryBarrier();
+  *(volatile unsigned char *)p = v;
+}
+#define TB_LOAD_ACQUIRE(p) tb_load_acquire(p)
+#define TB_STORE_RELEASE(p, v) tb_store_release((p), (v))
+#else
+#define TB_LOAD_ACQUIRE(p) (*(p))
+#define TB_STORE_RELEASE(p, v) (*(p) = (v))
+#endif
+
 #define WDLSUFFIX ".rtbw"
 #define DTZSUFFIX ".rtbz"
 #define WDLDIR "RTBWDIR"
@@ -101,6 +126,8 @@ struct TBEntry_piece {
   int factor[2][TBPIECES];
   ubyte pieces[2][TBPIECES];
   ubyte norm[2][TBPIECES];
+  struct TBEntry *dtz;
+  ubyte dtz_ready;
 };
 
 struct TBEntry_pawn {
@@ -118,6 +145,8 @@ struct TBEntry_pawn {
     ubyte pieces[2][TBPIECES];
     ubyte norm[2][TBPIECES];
   } file[4];
+  struct TBEntry *dtz;
+  ubyte dtz_ready;
 };
 
 struct DTZEntry_piece {
@@ -163,11 +192,5 @@ struct TBHashEntry {
   struct TBEntry *ptr;
 };
 
-struct DTZTableEntry {
-  uint64 key1;
-  uint64 key2;
-  struct TBEntry *entry;
-};
-
 #endif
 
@@ -114,6 +114,10 @@ struct pos
 static bool do_move(struct pos *pos, const struct pos *pos0, uint16_t move);
 static int probe_dtz(const struct pos *pos, int *success);
 
+#ifndef TB_NO_THREADS
+#define TB_HAVE_THREADS
+#endif
+
 unsigned TB_LARGEST = 0;
 #include "tbcore.c"
 
@@ -703,7 +707,7 @@ static int probe_wdl_table(const struct pos *pos, int *success)
     }
 
     ptr = ptr2[i].ptr;
-    if (!ptr->ready)
+    if (!TB_LOAD_ACQUIRE(&ptr->ready))
     {
         LOCK(TB_MUTEX);
         if (!ptr->ready)
@@ -717,13 +721,7 @@ static int probe_wdl_table(const struct pos *pos, int *success)
                 UNLOCK(TB_MUTEX);
                 return 0;
             }
-            // Memory barrier to ensure ptr->ready = 1 is not reordered.
-#ifdef __GNUC__
-            __asm__ __volatile__ ("" ::: "memory");
-#elif defined(_MSC_VER)
-            MemoryBarrier();
-#endif
-            ptr->ready = 1;
+            TB_STORE_RELEASE(&ptr->ready, 1);
         }
         UNLOCK(TB_MUTEX);
     }
@@ -808,48 +806,35 @@ static int probe_dtz_table(const struct pos *pos, int wdl, int *success)
     // Obtain the position's material signature key.
     uint64_t key = calc_key(pos, false);
 
-    if (DTZ_table[0].key1 != key && DTZ_table[0].key2 != key)
+    struct TBHashEntry *ptr2 = TB_hash[key >> (64 - TBHASHBITS)];
+    for (i = 0; i < HSHMAX; i++)
     {
-        for (i = 1; i < DTZ_ENTRIES; i++)
-        {
-            if (DTZ_table[i].key1 == key)
-                break;
-        }
-        if (i < DTZ_ENTRIES)
-        {
-            struct DTZTableEntry table_entry = DTZ_table[i];
-            for (; i > 0; i--)
-                DTZ_table[i] = DTZ_table[i - 1];
-            DTZ_table[0] = table_entry;
-        }
-        else
+        if (ptr2[i].key == key)
+            break;
+    }
+    if (i == HSHMAX)
+    {
+        *success = 0;
+        return 0;
+    }
+
+    // Load the DTZ table once; afterwards it is only ever read, so
+    // concurrent probes need no locking.
+    struct TBEntry *wdl_ptr = ptr2[i].ptr;
+    if (!TB_LOAD_ACQUIRE(dtz_ready(wdl_ptr)))
+    {
+        LOCK(TB_MUTEX);
+        if (!*dtz_ready(wdl_ptr))
         {
-            struct TBHashEntry *ptr2 = TB_hash[key >> (64 - TBHASHBITS)];
-            for (i = 0; i < HSHMAX; i++)
-            {
-                if (ptr2[i].key == key)
-                    break;
-            }
-            if (i == HSHMAX)
-            {
-                *success = 0;
-                return 0;
-            }
-            ptr = ptr2[i].ptr;
             char str[16];
-            int mirror = (ptr->key != key);
-            prt_str(pos, str, mirror);
-            if (DTZ_table[DTZ_ENTRIES - 1].entry)
-                free_dtz_entry(DTZ_table[DTZ_ENTRIES-1].entry);
-            for (i = DTZ_ENTRIES - 1; i > 0; i--)
-                DTZ_table[i] = DTZ_table[i - 1];
-            uint64_t key1 = calc_key(pos, mirror);
-            uint64_t key2 = calc_key(pos, !mirror);
-            load_dtz_table(str, key1, key2);
+            prt_str(pos, str, wdl_ptr->key != key);
+            *dtz_entry(wdl_ptr) = load_dtz_table(str, wdl_ptr);
+            TB_STORE_RELEASE(dtz_ready(wdl_ptr), 1);
         }
+        UNLOCK(TB_MUTEX);
     }
 
-    ptr = DTZ_table[0].entry;
+    ptr = *dtz_entry(wdl_ptr);
     if (!ptr)
     {
         *success = 0;
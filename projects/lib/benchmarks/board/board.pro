@@ -0,0 +1,4 @@
+include(../benchmarks.pri)
+
+TARGET = tst_board
+SOURCES += tst_board.cpp
@@ -0,0 +1,167 @@
+#include <QtTest/QtTest>
+#include <board/board.h>
+#include <board/boardfactory.h>
+#include <mersenne.h>
+
+
+class tst_Board: public QObject
+{
+	Q_OBJECT
+
+	public:
+		tst_Board();
+
+	private slots:
+		void repetition_data() const;
+		void repetition();
+		void sanStrings_data() const;
+		void sanStrings();
+		void sanRoundTrip();
+
+		void cleanupTestCase();
+
+	private:
+		Chess::Board* m_board;
+};
+
+tst_Board::tst_Board()
+	: m_board(Chess::BoardFactory::create("standard"))
+{
+}
+
+void tst_Board::cleanupTestCase()
+{
+	delete m_board;
+}
+
+/*
+ * Plays a game of random moves from the starting position. After the
+ * early captures the game turns into a long shuffle of the remaining
+ * pieces, which is the worst case for repetition detection.
+ */
+static QVector<Chess::Move> randomGame(Chess::Board* board,
+					int maxPlies,
+					int seed = 1)
+{
+	QVector<Chess::Move> game;
+
+	Mersenne::initialize(seed);
+	board->reset();
+	while (game.size() < maxPlies)
+	{
+		const QVector<Chess::Move> moves(board->legalMoves());
+		if (moves.isEmpty())
+			break;
+
+		const Chess::Move& move = moves.at(Mersenne::random() % moves.size());
+		board->makeMove(move);
+		game.append(move);
+	}
+	board->reset();
+
+	return game;
+}
+
+void tst_Board::repetition_data() const
+{
+	QTest::addColumn<int>("plies");
+
+	QTest::newRow("100 plies") << 100;
+	QTest::newRow("400 plies") << 400;
+	QTest::newRow("1000 plies") << 1000;
+}
+
+void tst_Board::repetition()
+{
+	QFETCH(int, plies);
+
+	const QVector<Chess::Move> game(randomGame(m_board, plies));
+
+	// Query the repetitions at every ply like ChessGame does when
+	// it adjudicates the game and probes the opening book
+	int repeats = 0;
+	QBENCHMARK
+	{
+		repeats = 0;
+		m_board->reset();
+		foreach (const Chess::Move& move, game)
+		{
+			repeats += m_board->isRepetition(move);
+			m_board->makeMove(move);
+			repeats += m_board->repeatCount();
+		}
+	}
+
+	qDebug("%s: %d moves, %d repetitions", QTest::currentDataTag(),
+	       game.size(), repeats);
+}
+
+void tst_Board::sanStrings_data() const
+{
+	QTest::addColumn<QString>("fen");
+
+	QTest::newRow("startpos")
+		<< "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+	QTest::newRow("castling")
+		<< "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+	QTest::newRow("checks")
+		<< "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8";
+	QTest::newRow("middlegame")
+		<< "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10";
+}
+
+void tst_Board::sanStrings()
+{
+	QFETCH(QString, fen);
+
+	QVERIFY(m_board->setFenString(fen));
+	const QVector<Chess::Move> moves(m_board->legalMoves());
+
+	QBENCHMARK
+	{
+		foreach (const Chess::Move& move, moves)
+			m_board->moveString(move, Chess::Board::StandardAlgebraic);
+	}
+}
+
+void tst_Board::sanRoundTrip()
+{
+	// A corpus of random games that cover all kinds of moves:
+	// captures, promotions, castling, checks and mates
+	QVector< QVector<Chess::Move> > games;
+	int moveCount = 0;
+	for (int i = 1; i <= 200; i++)
+	{
+		games.append(randomGame(m_board, 300, i));
+		moveCount += games.last().size();
+	}
+
+	qint64 elapsed = 0;
+	int runs = 0;
+	QElapsedTimer timer;
+
+	QBENCHMARK
+	{
+		timer.start();
+		foreach (const QVector<Chess::Move>& game, games)
+		{
+			m_board->reset();
+			foreach (const Chess::Move& move, game)
+			{
+				const QString str(m_board->moveString(
+					move, Chess::Board::StandardAlgebraic));
+				QVERIFY(m_board->moveFromString(str) == move);
+				m_board->makeMove(move);
+			}
+		}
+		elapsed += timer.nsecsElapsed();
+		runs++;
+	}
+
+	if (elapsed > 0)
+		qDebug("%d moves: %.0f round-trips/s", moveCount,
+		       double(moveCount) * runs / (elapsed / 1e9));
+}
+
+QTEST_MAIN(tst_Board)
+#include "tst_board.moc"
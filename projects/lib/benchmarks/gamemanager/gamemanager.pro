@@ -0,0 +1,4 @@
+include(../benchmarks.pri)
+
+TARGET = tst_gamemanager
+SOURCES += tst_gamemanager.cpp
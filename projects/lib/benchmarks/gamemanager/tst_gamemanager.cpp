@@ -0,0 +1,223 @@
+#include <QtTest/QtTest>
+#include <gamemanager.h>
+#include <chessgame.h>
+#include <chessplayer.h>
+#include <playerbuilder.h>
+#include <pgngame.h>
+#include <timecontrol.h>
+#include <board/board.h>
+#include <board/boardfactory.h>
+
+namespace {
+
+// The loser resigns after this many plies
+const int s_gamePlies = 40;
+const int s_builderCount = 16;
+const int s_gameCount = 256;
+
+} // anonymous namespace
+
+
+/*
+ * A player that replies to every move with its first legal move,
+ * so the benchmark measures scheduling instead of thinking.
+ */
+class InstantPlayer : public ChessPlayer
+{
+	Q_OBJECT
+
+	public:
+		InstantPlayer(QObject* parent = 0)
+			: ChessPlayer(parent)
+		{
+			setState(Idle);
+		}
+
+		virtual void endGame(const Chess::Result& result)
+		{
+			ChessPlayer::endGame(result);
+			setState(Idle);
+		}
+		virtual void makeMove(const Chess::Move& move)
+		{
+			Q_UNUSED(move);
+		}
+		virtual bool supportsVariant(const QString& variant) const
+		{
+			Q_UNUSED(variant);
+			return true;
+		}
+		virtual bool isHuman() const
+		{
+			return false;
+		}
+
+	protected:
+		virtual void startGame()
+		{
+		}
+		virtual void startThinking()
+		{
+			QMetaObject::invokeMethod(this, "playMove",
+						  Qt::QueuedConnection);
+		}
+
+	private slots:
+		void playMove()
+		{
+			if (state() != Thinking)
+				return;
+
+			if (board()->plyCount() >= s_gamePlies)
+				forfeit(Chess::Result::Resignation);
+			else
+				emitMove(board()->legalMoves().first());
+		}
+};
+
+class InstantBuilder : public PlayerBuilder
+{
+	public:
+		InstantBuilder(const QString& name)
+			: PlayerBuilder(name)
+		{
+		}
+
+		virtual ChessPlayer* create(QObject* receiver,
+					    const char* method,
+					    QObject* parent,
+					    QString* error) const
+		{
+			Q_UNUSED(receiver);
+			Q_UNUSED(method);
+			Q_UNUSED(error);
+
+			ChessPlayer* player = new InstantPlayer(parent);
+			player->setName(name());
+			return player;
+		}
+};
+
+/*
+ * Queues a round robin style sequence of games and waits until
+ * all of them have been played and destroyed.
+ */
+class GameRunner : public QObject
+{
+	Q_OBJECT
+
+	public:
+		GameRunner(GameManager* manager,
+			   const QList<PlayerBuilder*>& builders)
+			: m_manager(manager),
+			  m_builders(builders),
+			  m_destroyedGames(0)
+		{
+			connect(m_manager, SIGNAL(gameDestroyed(ChessGame*)),
+				this, SLOT(onGameDestroyed()));
+		}
+
+		void run(int games)
+		{
+			m_destroyedGames = 0;
+			for (int i = 0; i < games; i++)
+			{
+				int n = m_builders.size();
+				int white = i % n;
+				int black = (white + 1 + (i / n) % (n - 1)) % n;
+
+				ChessGame* game = new ChessGame(
+					Chess::BoardFactory::create("standard"),
+					new PgnGame());
+				game->setTimeControl(TimeControl("inf"));
+				connect(game, SIGNAL(finished(ChessGame*)),
+					this, SLOT(onGameFinished(ChessGame*)));
+				m_manager->newGame(game,
+						   m_builders.at(white),
+						   m_builders.at(black),
+						   GameManager::Enqueue,
+						   GameManager::ReusePlayers);
+			}
+
+			while (m_destroyedGames < games)
+				QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+		}
+
+	private slots:
+		void onGameFinished(ChessGame* game)
+		{
+			delete game->pgn();
+			game->deleteLater();
+		}
+		void onGameDestroyed()
+		{
+			m_destroyedGames++;
+		}
+
+	private:
+		GameManager* m_manager;
+		QList<PlayerBuilder*> m_builders;
+		int m_destroyedGames;
+};
+
+class tst_GameManager: public QObject
+{
+	Q_OBJECT
+
+	private slots:
+		void gamesPerSecond_data() const;
+		void gamesPerSecond();
+};
+
+void tst_GameManager::gamesPerSecond_data() const
+{
+	QTest::addColumn<int>("concurrency");
+	QTest::addColumn<int>("workerThreads");
+
+	QTest::newRow("8 games, thread per game") << 8 << 0;
+	QTest::newRow("8 games, 2 threads") << 8 << 2;
+	QTest::newRow("64 games, thread per game") << 64 << 0;
+	QTest::newRow("64 games, 4 threads") << 64 << 4;
+}
+
+void tst_GameManager::gamesPerSecond()
+{
+	QFETCH(int, concurrency);
+	QFETCH(int, workerThreads);
+
+	QList<PlayerBuilder*> builders;
+	for (int i = 0; i < s_builderCount; i++)
+		builders << new InstantBuilder(QString("Player %1").arg(i));
+
+	qint64 elapsed = 0;
+	int runs = 0;
+	QElapsedTimer timer;
+
+	QBENCHMARK
+	{
+		timer.start();
+
+		GameManager manager;
+		manager.setConcurrency(concurrency);
+		manager.setWorkerThreadCount(workerThreads);
+
+		GameRunner runner(&manager, builders);
+		runner.run(s_gameCount);
+
+		QSignalSpy spy(&manager, SIGNAL(finished()));
+		manager.finish();
+		QTRY_COMPARE(spy.count(), 1);
+
+		elapsed += timer.nsecsElapsed();
+		runs++;
+	}
+
+	if (elapsed > 0)
+		qDebug("%s: %.1f games/s", QTest::currentDataTag(),
+		       double(s_gameCount) * runs / (elapsed / 1e9));
+
+	qDeleteAll(builders);
+}
+
+QTEST_MAIN(tst_GameManager)
+#include "tst_gamemanager.moc"
@@ -0,0 +1,299 @@
+#include <QtTest/QtTest>
+#include <pgnstream.h>
+#include <pgngame.h>
+#include <uciengine.h>
+#include <engineconfiguration.h>
+#include <timecontrol.h>
+#include <board/board.h>
+
+
+/*!
+ * A device that plays the part of an UCI engine which does nothing
+ * but completes the handshake. Everything written to it is counted
+ * and discarded, and replay() feeds recorded output to the engine.
+ */
+class UciDevice : public QIODevice
+{
+	Q_OBJECT
+
+	public:
+		UciDevice()
+			: m_bytesWritten(0)
+		{
+			open(QIODevice::ReadWrite);
+		}
+
+		void replay(const QByteArray& data)
+		{
+			m_output.append(data);
+			QMetaObject::invokeMethod(this, "readyRead",
+						  Qt::QueuedConnection);
+		}
+
+		qint64 totalBytesWritten() const
+		{
+			return m_bytesWritten;
+		}
+		void resetBytesWritten()
+		{
+			m_bytesWritten = 0;
+		}
+
+		virtual bool isSequential() const
+		{
+			return true;
+		}
+		virtual qint64 bytesAvailable() const
+		{
+			return m_output.size() + QIODevice::bytesAvailable();
+		}
+		virtual bool canReadLine() const
+		{
+			return m_output.contains('\n') || QIODevice::canReadLine();
+		}
+
+	protected:
+		virtual qint64 readData(char* data, qint64 maxSize)
+		{
+			qint64 size = qMin(maxSize, qint64(m_output.size()));
+			memcpy(data, m_output.constData(), size);
+			m_output.remove(0, size);
+			return size;
+		}
+		virtual qint64 writeData(const char* data, qint64 maxSize)
+		{
+			m_bytesWritten += maxSize;
+
+			QByteArray line(data, maxSize);
+			if (line == "uci\n")
+				reply("uciok\n");
+			else if (line == "isready\n")
+				reply("readyok\n");
+			return maxSize;
+		}
+
+	private:
+		void reply(const char* str)
+		{
+			replay(QByteArray(str));
+		}
+
+		QByteArray m_output;
+		qint64 m_bytesWritten;
+};
+
+/*! Counts the debug messages it receives. */
+class DebugReceiver : public QObject
+{
+	Q_OBJECT
+
+	public:
+		DebugReceiver()
+			: m_count(0)
+		{
+		}
+
+		int count() const
+		{
+			return m_count;
+		}
+
+	public slots:
+		void onDebugMessage(const QString& message)
+		{
+			Q_UNUSED(message);
+			m_count++;
+		}
+
+	private:
+		int m_count;
+};
+
+class tst_UciEngine: public QObject
+{
+	Q_OBJECT
+	
+	private slots:
+		void makeMove_data() const;
+		void makeMove();
+		void infoFlood_data() const;
+		void infoFlood();
+};
+
+static const char s_game[] =
+	"[Event \"?\"]\n"
+	"[Site \"Linares\"]\n"
+	"[Date \"1993.??.??\"]\n"
+	"[Round \"0.12\"]\n"
+	"[White \"Karpov,An\"]\n"
+	"[Black \"Kramnik,V\"]\n"
+	"[Result \"1/2-1/2\"]\n"
+	"[ECO \"B13\"]\n\n"
+	"1. c4 c6 2. e4 d5 3. exd5 cxd5 4. d4 Nf6 5. Nc3 Nc6 6. Nf3 Bg4 7. cxd5\n"
+	"Nxd5 8. Qb3 Bxf3 9. gxf3 e6 10. Qxb7 Nxd4 11. Bb5+ Nxb5 12. Qc6+ Ke7\n"
+	"13. Qxb5 Qd7 14. Nxd5+ Qxd5 15. Bg5+ f6 16. Qxd5 exd5 17. Be3 Ke6\n"
+	"18. O-O-O Bb4 19. Rd3 Rhd8 20. a3 Rac8+ 21. Kb1 Bc5 22. Re1 Kd6 23. Rg1\n"
+	"g6 24. Rgd1 Ke6 25. Re1 Bxe3 26. Rdxe3+ Kf5 27. Re7 Kf4 28. R1e3 a5\n"
+	"29. h3 h5 30. R7e6 Kg5 31. Ra6 d4 32. f4+ Kf5 33. Rxa5+ Kxf4 34. Rd3 Ke4\n"
+	"35. Rd2 g5 36. Ra6 f5 37. Re6+ Kf3 38. Re5 Kf4 39. Re6 h4 40. Rd3 g4\n"
+	"41. Rh6 Kg5 42. Rh7 Rc6 43. a4 Rd5 44. a5 Rcd6 45. Ra7 gxh3 46. Rg7+ Kf4\n"
+	"47. Rh7 Ke4 48. Rxh3 Rxa5 49. Kc2 Rb5 50. Re7+ Kf4 51. Rxh4+ Kf3\n"
+	"52. Rh3+ Kxf2 53. Rd3 Rc6+ 54. Kb1 Rb4 55. b3 f4 56. Re4 Rf6 57. Kb2 f3\n"
+	"58. Ka3 Rbb6 59. Rdxd4 Rg6 60. Rd2+ Kg3 61. Re3 Rbe6 62. Rc3 Ra6+\n"
+	"63. Kb2 Rg4 64. Rd8 Rf6 65. Rd2 Rgf4 66. Ka3 Kg4 67. Rf2 Ra6+ 68. Kb2\n"
+	"Rh6 69. Ka3 Rh1 70. Rd3 Kg3 71. Rc2 Rhh4 72. Re3 Rh2 73. Rc8 Kg2\n"
+	"74. Rg8+ Kf1 75. b4 f2 76. Rb3 Rhh4 77. Rgg3 Rd4 78. Ka4 Rhe4 79. Ka5\n"
+	"Rd2 80. Rh3 Ke2 81. Rh2 Ra2+ 82. Kb6 Re6+ 83. Kc5 Rc2+ 84. Kb5 Rh6\n"
+	"85. Rg2 Rf6 86. Rh2 Rh6 87. Rg2 Kf1 88. Rg5 Rf6 89. Rc5 Rd2 90. Rc6 Rf4\n"
+	"91. Rc1+ Kg2 92. Rbb1 Rf8 93. Ka5 Ra2+ 94. Kb6 Rf6+ 95. Kc5 Rf5+ 96. Kb6\n"
+	"Re2 97. b5 Re6+ 98. Ka5 Rfe5 99. Ka4 Re4+ 1/2-1/2\n";
+
+
+// Output of a search recorded from an engine that reports every
+// root move it searches
+static const char s_infoLines[] =
+	"info depth 21 seldepth 30 multipv 1 score cp 27 nodes 4117359 nps 1925832 hashfull 812 tbhits 0 time 2138 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7 b5f1 c6e5 e1e5 e8g8 d2d4 e7f6 e5e1\n"
+	"info depth 22 currmove e2e4 currmovenumber 1\n"
+	"info depth 22 currmove d2d4 currmovenumber 2\n"
+	"info depth 22 currmove g1f3 currmovenumber 3\n"
+	"info depth 22 currmove c2c4 currmovenumber 4\n"
+	"info depth 22 currmove e2e3 currmovenumber 5\n"
+	"info depth 22 currmove b1c3 currmovenumber 6\n"
+	"info depth 22 seldepth 31 multipv 1 score cp 31 lowerbound nodes 5092342 nps 1931082 hashfull 856 tbhits 0 time 2637 pv e2e4\n"
+	"info depth 22 currmove e2e4 currmovenumber 1\n"
+	"info depth 22 seldepth 31 multipv 1 score cp 24 nodes 5470101 nps 1932896 hashfull 871 tbhits 0 time 2830 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4 f1e1 e4d6 f3e5 f8e7 b5f1 c6e5 e1e5 e8g8 d2d4 e7f6 e5e1 f8e8 c2c3\n"
+	"info depth 22 currmove d2d4 currmovenumber 2\n"
+	"info depth 22 currmove g1f3 currmovenumber 3\n"
+	"info depth 22 currmove c2c4 currmovenumber 4\n"
+	"info nodes 5512034 nps 1933347 hashfull 874 tbhits 0 time 2851\n"
+	"info string NNUE evaluation using nn-5af11540bbfe.nnue enabled\n"
+	"info depth 23 currmove e2e4 currmovenumber 1\n";
+
+void tst_UciEngine::makeMove_data() const
+{
+	QTest::addColumn<bool>("fenAfterIrreversible");
+
+	QTest::newRow("moves") << false;
+	QTest::newRow("fen") << true;
+}
+
+void tst_UciEngine::makeMove()
+{
+	QFETCH(bool, fenAfterIrreversible);
+
+	QByteArray pgnData(s_game);
+	PgnStream stream(&pgnData);
+	PgnGame pgn;
+	QVERIFY(pgn.read(stream));
+
+	EngineConfiguration config("Mock", "mock", "uci");
+	config.setFenAfterIrreversible(fenAfterIrreversible);
+
+	UciEngine engine;
+	UciEngine opponent;
+	UciDevice* device = new UciDevice;
+	engine.setDevice(device);
+	engine.applyConfiguration(config);
+	engine.setTimeControl(TimeControl("inf"));
+	engine.start();
+	QTRY_VERIFY(engine.state() == ChessPlayer::Idle && engine.isReady());
+
+	Chess::Board* board = pgn.createBoard();
+	QVERIFY(board != 0);
+
+	// Replay the game the way ChessGame plays it: the engine finds
+	// its own moves with "bestmove" and is sent only the opponent's
+	// moves, before they're made on the board
+	qint64 bytes = 0;
+	QBENCHMARK
+	{
+		board->setFenString(board->defaultFenString());
+		engine.newGame(Chess::Side::White, &opponent, board);
+		device->resetBytesWritten();
+
+		foreach (const PgnGame::MoveData& md, pgn.moves())
+		{
+			Chess::Move move(board->moveFromGenericMove(md.move));
+			if (board->sideToMove() == engine.side())
+			{
+				QString moveString(board->moveString(
+					move, Chess::Board::LongAlgebraic));
+				engine.go();
+				device->replay("bestmove " + moveString.toLatin1() + "\n");
+				while (engine.state() == ChessPlayer::Thinking)
+					QCoreApplication::processEvents();
+			}
+			else
+				engine.makeMove(move);
+			board->makeMove(move);
+		}
+		bytes = device->totalBytesWritten();
+
+		engine.endGame(Chess::Result());
+		while (engine.state() != ChessPlayer::Idle)
+			QCoreApplication::processEvents();
+	}
+	qDebug("%s: %lld bytes sent per game",
+	       QTest::currentDataTag(), bytes);
+
+	delete board;
+}
+
+void tst_UciEngine::infoFlood_data() const
+{
+	QTest::addColumn<bool>("debug");
+	QTest::addColumn<int>("infoInterval");
+
+	QTest::newRow("no receiver") << false << 0;
+	QTest::newRow("debug receiver") << true << 0;
+	QTest::newRow("coalesced") << false << 1000;
+}
+
+void tst_UciEngine::infoFlood()
+{
+	QFETCH(bool, debug);
+	QFETCH(int, infoInterval);
+
+	EngineConfiguration config("Mock", "mock", "uci");
+	config.setInfoInterval(infoInterval);
+
+	UciEngine engine;
+	UciDevice* device = new UciDevice;
+	engine.setDevice(device);
+	engine.applyConfiguration(config);
+	engine.start();
+	QTRY_VERIFY(engine.state() == ChessPlayer::Idle && engine.isReady());
+
+	DebugReceiver receiver;
+	if (debug)
+		connect(&engine, SIGNAL(debugMessage(QString)),
+			&receiver, SLOT(onDebugMessage(QString)));
+
+	QByteArray flood;
+	for (int i = 0; i < 1000; i++)
+		flood += s_infoLines;
+	const int lines = flood.count('\n');
+
+	qint64 elapsed = 0;
+	int runs = 0;
+	QElapsedTimer timer;
+
+	QBENCHMARK
+	{
+		timer.start();
+		device->replay(flood);
+		while (device->bytesAvailable() > 0)
+			QCoreApplication::processEvents();
+		elapsed += timer.nsecsElapsed();
+		runs++;
+	}
+
+	if (debug)
+		QCOMPARE(receiver.count(), lines * runs);
+	if (elapsed > 0)
+		qDebug("%s: %.0f lines/s", QTest::currentDataTag(),
+		       double(lines) * runs / (elapsed / 1e9));
+}
+
+QTEST_MAIN(tst_UciEngine)
+#include "tst_uciengine.moc"
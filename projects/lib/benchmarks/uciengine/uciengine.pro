@@ -0,0 +1,4 @@
+include(../benchmarks.pri)
+
+TARGET = tst_uciengine
+SOURCES += tst_uciengine.cpp
@@ -0,0 +1,565 @@
+/*
+    Copyright (c) 2010 Ilari Pihlajisto
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "jsonreader.h"
+#include <QVector>
+#include <climits>
+#include <cstring>
+
+namespace {
+
+inline bool isSpace(char c)
+{
+	return c == ' ' || c == '\n' || c == '\t' || c == '\r'
+	    || c == '\f' || c == '\v';
+}
+
+inline bool isTokenEnd(char c)
+{
+	return isSpace(c) || c == ',' || c == ']' || c == '}';
+}
+
+inline int hexValue(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+/*
+ * A handler that builds a QVariant tree, used by JsonReader::parse().
+ * Each open object or array is kept on a stack until it's closed.
+ */
+class VariantBuilder : public JsonHandler
+{
+	public:
+		virtual bool beginObject()
+		{
+			m_stack.append(Node(true));
+			return true;
+		}
+
+		virtual bool endObject()
+		{
+			QVariant map(m_stack.last().map);
+			m_stack.removeLast();
+			return value(map);
+		}
+
+		virtual bool beginArray()
+		{
+			m_stack.append(Node(false));
+			return true;
+		}
+
+		virtual bool endArray()
+		{
+			QVariant list(m_stack.last().list);
+			m_stack.removeLast();
+			return value(list);
+		}
+
+		virtual bool key(const QString& name)
+		{
+			m_stack.last().key = name;
+			return true;
+		}
+
+		virtual bool value(const QVariant& value)
+		{
+			if (m_stack.isEmpty())
+				m_result = value;
+			else
+			{
+				Node& node = m_stack.last();
+				if (node.isObject)
+					node.map.insert(node.key, value);
+				else
+					node.list.append(value);
+			}
+			return true;
+		}
+
+		QVariant result() const
+		{
+			return m_result;
+		}
+
+	private:
+		struct Node
+		{
+			Node(bool object = false)
+				: isObject(object) {}
+
+			bool isObject;
+			QString key;
+			QVariantMap map;
+			QVariantList list;
+		};
+
+		QVector<Node> m_stack;
+		QVariant m_result;
+};
+
+} // anonymous namespace
+
+
+JsonHandler::~JsonHandler()
+{
+}
+
+bool JsonHandler::beginObject()
+{
+	return true;
+}
+
+bool JsonHandler::endObject()
+{
+	return true;
+}
+
+bool JsonHandler::beginArray()
+{
+	return true;
+}
+
+bool JsonHandler::endArray()
+{
+	return true;
+}
+
+bool JsonHandler::key(const QString& name)
+{
+	Q_UNUSED(name);
+	return true;
+}
+
+bool JsonHandler::value(const QVariant& value)
+{
+	Q_UNUSED(value);
+	return true;
+}
+
+
+JsonReader::JsonReader(const QByteArray& data)
+	: m_error(false),
+	  m_currentLine(1),
+	  m_errorLine(0),
+	  m_data(data),
+	  m_pos(m_data.constData()),
+	  m_end(m_pos + m_data.size()),
+	  m_tokenStart(m_pos)
+{
+}
+
+bool JsonReader::hasError() const
+{
+	return m_error;
+}
+
+QString JsonReader::errorString() const
+{
+	return m_errorString;
+}
+
+qint64 JsonReader::errorLineNumber() const
+{
+	return m_errorLine;
+}
+
+void JsonReader::setError(const QString& message)
+{
+	if (m_error)
+		return;
+
+	m_error = true;
+	m_errorString = message;
+	m_errorLine = m_currentLine;
+}
+
+bool JsonReader::checkHandler(bool ok)
+{
+	if (!ok)
+		setError(tr("Parsing aborted by the handler"));
+	return ok;
+}
+
+QString JsonReader::tokenString(Token type) const
+{
+	switch (type)
+	{
+	case JsonComma: return ",";
+	case JsonColon: return ":";
+	case JsonBeginObject: return "{";
+	case JsonEndObject: return "}";
+	case JsonBeginArray: return "[";
+	case JsonEndArray: return "]";
+	case JsonTrue: return "true";
+	case JsonFalse: return "false";
+	case JsonNull: return "null";
+	case JsonNumber:
+		return QString::fromUtf8(m_tokenStart, int(m_pos - m_tokenStart));
+	case JsonString:
+		if (m_string.isEmpty())
+			return tr("(empty string)");
+		return m_string;
+	default: return QString();
+	}
+}
+
+QVariant JsonReader::parse()
+{
+	VariantBuilder builder;
+	if (!parse(&builder))
+		return QVariant();
+	return builder.result();
+}
+
+bool JsonReader::parse(JsonHandler* handler)
+{
+	Q_ASSERT(handler != 0);
+
+	if (m_error)
+		return false;
+	return parseValue(handler, parseToken());
+}
+
+JsonReader::Token JsonReader::parseToken()
+{
+	while (m_pos != m_end && isSpace(*m_pos))
+	{
+		if (*m_pos == '\n')
+			m_currentLine++;
+		++m_pos;
+	}
+	if (m_pos == m_end)
+	{
+		setError(tr("Reached EOF unexpectedly"));
+		return JsonError;
+	}
+
+	m_tokenStart = m_pos;
+	switch (*m_pos++)
+	{
+	case ',': return JsonComma;
+	case ':': return JsonColon;
+	case '{': return JsonBeginObject;
+	case '}': return JsonEndObject;
+	case '[': return JsonBeginArray;
+	case ']': return JsonEndArray;
+	case '\"':
+		return parseString() ? JsonString : JsonError;
+	default:
+		break;
+	}
+
+	while (m_pos != m_end && !isTokenEnd(*m_pos))
+		++m_pos;
+
+	const int size = int(m_pos - m_tokenStart);
+	if (size == 4 && !std::memcmp(m_tokenStart, "true", 4))
+		return JsonTrue;
+	if (size == 5 && !std::memcmp(m_tokenStart, "false", 5))
+		return JsonFalse;
+	if (size == 4 && !std::memcmp(m_tokenStart, "null", 4))
+		return JsonNull;
+	if ((*m_tokenStart >= '0' && *m_tokenStart <= '9')
+	||  *m_tokenStart == '-')
+		return JsonNumber;
+
+	setError(tr("Unknown token: %1")
+		 .arg(QString::fromUtf8(m_tokenStart, size)));
+	return JsonError;
+}
+
+bool JsonReader::parseString()
+{
+	m_string.clear();
+
+	// Unescaped runs of bytes are decoded in one go
+	const char* run = m_pos;
+	while (m_pos != m_end)
+	{
+		const char c = *m_pos;
+		if (c != '\"' && c != '\\')
+		{
+			if (c == '\n')
+				m_currentLine++;
+			++m_pos;
+			continue;
+		}
+
+		if (m_pos != run)
+			m_string += QString::fromUtf8(run, int(m_pos - run));
+		if (c == '\"')
+		{
+			++m_pos;
+			return true;
+		}
+
+		if (++m_pos == m_end)
+			break;
+		switch (*m_pos++)
+		{
+		case '\"':
+			m_string += QChar('\"');
+			break;
+		case '\\':
+			m_string += QChar('\\');
+			break;
+		case '/':
+			m_string += QChar('/');
+			break;
+		case 'b':
+			m_string += QChar('\b');
+			break;
+		case 'f':
+			m_string += QChar('\f');
+			break;
+		case 'n':
+			m_string += QChar('\n');
+			break;
+		case 'r':
+			m_string += QChar('\r');
+			break;
+		case 't':
+			m_string += QChar('\t');
+			break;
+		case 'u':
+			{
+				if (m_end - m_pos < 4)
+				{
+					m_pos = m_end;
+					break;
+				}
+
+				ushort code = 0;
+				for (int i = 0; i < 4; i++)
+				{
+					int digit = hexValue(m_pos[i]);
+					if (digit == -1)
+					{
+						setError(tr("Invalid unicode value: \\u%1")
+							 .arg(QString::fromUtf8(m_pos, 4)));
+						return false;
+					}
+					code = ushort(code * 16 + digit);
+				}
+				m_pos += 4;
+				m_string += QChar(code);
+			}
+			break;
+		default:
+			setError(tr("Unknown escape sequence: \\%1")
+				 .arg(QString::fromUtf8(m_pos - 1, 1)));
+			return false;
+		}
+		run = m_pos;
+	}
+
+	setError(tr("Reached EOF unexpectedly"));
+	return false;
+}
+
+QVariant JsonReader::numberValue()
+{
+	const int size = int(m_pos - m_tokenStart);
+	const char* p = m_tokenStart;
+	const bool negative = (*p == '-');
+	if (negative)
+		++p;
+
+	bool isInteger = (p != m_pos);
+	for (const char* q = p; q != m_pos; ++q)
+	{
+		if (*q < '0' || *q > '9')
+		{
+			isInteger = false;
+			break;
+		}
+	}
+
+	if (!isInteger)
+	{
+		const QByteArray token(m_tokenStart, size);
+		bool ok = false;
+		double val = 0.0;
+		if (token.contains('.') || token.contains('e') || token.contains('E'))
+			val = token.toDouble(&ok);
+		if (!ok)
+		{
+			setError(tr("Invalid number: %1")
+				 .arg(QString::fromUtf8(m_tokenStart, size)));
+			return QVariant();
+		}
+		return val;
+	}
+
+	// Accumulate the magnitude and check for overflow before
+	// each step. The limit of a negative number is one larger.
+	const quint64 limit = negative ? Q_UINT64_C(9223372036854775808)
+				       : Q_UINT64_C(9223372036854775807);
+	quint64 magnitude = 0;
+	for (; p != m_pos; ++p)
+	{
+		const int digit = *p - '0';
+		if (magnitude > (limit - digit) / 10)
+		{
+			setError(tr("Invalid integer: %1")
+				 .arg(QString::fromUtf8(m_tokenStart, size)));
+			return QVariant();
+		}
+		magnitude = magnitude * 10 + digit;
+	}
+
+	qint64 val = qint64(magnitude);
+	if (negative && magnitude != 0)
+		val = -qint64(magnitude - 1) - 1;
+
+	if (val >= INT_MIN && val <= INT_MAX)
+		return int(val);
+	return qlonglong(val);
+}
+
+bool JsonReader::parseValue(JsonHandler* handler, Token type)
+{
+	switch (type)
+	{
+	case JsonError:
+		return false;
+	case JsonBeginObject:
+		return parseObject(handler);
+	case JsonBeginArray:
+		return parseArray(handler);
+	case JsonTrue:
+		return checkHandler(handler->value(QVariant(true)));
+	case JsonFalse:
+		return checkHandler(handler->value(QVariant(false)));
+	case JsonNull:
+		return checkHandler(handler->value(QVariant()));
+	case JsonNumber:
+		{
+			const QVariant val(numberValue());
+			if (m_error)
+				return false;
+			return checkHandler(handler->value(val));
+		}
+	case JsonString:
+		return checkHandler(handler->value(QVariant(m_string)));
+	default:
+		setError(tr("Invalid value: %1").arg(tokenString(type)));
+		return false;
+	}
+}
+
+bool JsonReader::parseObject(JsonHandler* handler)
+{
+	if (!checkHandler(handler->beginObject()))
+		return false;
+
+	Token t = parseToken();
+	if (t == JsonEndObject)
+		return checkHandler(handler->endObject());
+
+	forever
+	{
+		if (t != JsonString)
+		{
+			if (t != JsonError)
+				setError(tr("Invalid key: %1").arg(tokenString(t)));
+			return false;
+		}
+		if (!checkHandler(handler->key(m_string)))
+			return false;
+
+		t = parseToken();
+		if (t != JsonColon)
+		{
+			if (t != JsonError)
+				setError(tr("Expected colon instead of: %1")
+					 .arg(tokenString(t)));
+			return false;
+		}
+
+		if (!parseValue(handler, parseToken()))
+			return false;
+
+		t = parseToken();
+		if (t == JsonEndObject)
+			return checkHandler(handler->endObject());
+		if (t != JsonComma)
+		{
+			if (t != JsonError)
+				setError(tr("Expected comma or closing bracket instead of: %1")
+					 .arg(tokenString(t)));
+			return false;
+		}
+
+		t = parseToken();
+		if (t == JsonEndObject)
+		{
+			setError(tr("Expected more key/value pairs"));
+			return false;
+		}
+	}
+}
+
+bool JsonReader::parseArray(JsonHandler* handler)
+{
+	if (!checkHandler(handler->beginArray()))
+		return false;
+
+	Token t = parseToken();
+	if (t == JsonEndArray)
+		return checkHandler(handler->endArray());
+
+	forever
+	{
+		if (!parseValue(handler, t))
+			return false;
+
+		t = parseToken();
+		if (t == JsonEndArray)
+			return checkHandler(handler->endArray());
+		if (t != JsonComma)
+		{
+			if (t != JsonError)
+				setError(tr("Expected comma or closing bracket instead of: %1")
+					 .arg(tokenString(t)));
+			return false;
+		}
+
+		t = parseToken();
+		if (t == JsonEndArray)
+		{
+			setError(tr("Expected more array items"));
+			return false;
+		}
+	}
+}
@@ -0,0 +1,157 @@
+/*
+    Copyright (c) 2010 Ilari Pihlajisto
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef JSONREADER_H
+#define JSONREADER_H
+
+#include <QVariant>
+#include <QByteArray>
+#include <QCoreApplication>
+
+
+/*!
+ * \brief Receives the contents of a JSON document from a JsonReader.
+ *
+ * The reader calls the handler's functions in document order, so
+ * large arrays can be processed one element at a time instead of
+ * building a QVariant tree of the whole document. Returning false
+ * from any of the functions aborts parsing.
+ *
+ * The default implementations do nothing and return true.
+ * \sa JsonReader
+ */
+class LIB_EXPORT JsonHandler
+{
+	public:
+		/*! Destroys the handler. */
+		virtual ~JsonHandler();
+
+		/*! Called at the beginning of a JSON object. */
+		virtual bool beginObject();
+		/*! Called at the end of a JSON object. */
+		virtual bool endObject();
+		/*! Called at the beginning of a JSON array. */
+		virtual bool beginArray();
+		/*! Called at the end of a JSON array. */
+		virtual bool endArray();
+		/*!
+		 * Called before the value of an object member with
+		 * \a name as its key.
+		 */
+		virtual bool key(const QString& name);
+		/*!
+		 * Called for each JSON null, boolean, number and string.
+		 *
+		 * \a value has the same type that JsonParser would give it.
+		 */
+		virtual bool value(const QVariant& value);
+};
+
+/*!
+ * \brief A JSON parser for UTF-8 encoded byte buffers.
+ *
+ * JsonReader does the same job as JsonParser but works directly on
+ * the bytes of the document instead of pulling it character by
+ * character from a text stream, which makes it much faster on big
+ * files. The data can either be converted into a QVariant or passed
+ * to a JsonHandler as it is parsed.
+ *
+ * Like JsonParser, the reader continues from where the previous
+ * value ended, so a buffer of consecutive JSON values can be read
+ * by calling parse() repeatedly.
+ *
+ * JSON specification: http://json.org/
+ * \sa JsonParser, JsonWriter
+ */
+class LIB_EXPORT JsonReader
+{
+	Q_DECLARE_TR_FUNCTIONS(JsonReader)
+
+	public:
+		/*! Creates a new reader that reads UTF-8 encoded \a data. */
+		JsonReader(const QByteArray& data);
+
+		/*!
+		 * Parses the next JSON value and returns it.
+		 *
+		 * Returns a null QVariant object if a parsing error occurs.
+		 * Use hasError() to check for errors.
+		 */
+		QVariant parse();
+		/*!
+		 * Parses the next JSON value and passes it to \a handler.
+		 *
+		 * Returns false if a parsing error occurs or if the handler
+		 * aborts parsing; otherwise returns true.
+		 */
+		bool parse(JsonHandler* handler);
+
+		/*! Returns true if a parsing error occured. */
+		bool hasError() const;
+		/*! Returns a detailed description of the error. */
+		QString errorString() const;
+		/*! Returns the line number on which the error occured. */
+		qint64 errorLineNumber() const;
+
+	private:
+		enum Token
+		{
+			JsonError,
+			JsonComma,
+			JsonColon,
+			JsonBeginObject,
+			JsonEndObject,
+			JsonBeginArray,
+			JsonEndArray,
+			JsonTrue,
+			JsonFalse,
+			JsonNull,
+			JsonNumber,
+			JsonString
+		};
+
+		QString tokenString(Token type) const;
+
+		Token parseToken();
+		bool parseString();
+		bool parseValue(JsonHandler* handler, Token type);
+		bool parseObject(JsonHandler* handler);
+		bool parseArray(JsonHandler* handler);
+		QVariant numberValue();
+		bool checkHandler(bool ok);
+		void setError(const QString& message);
+
+		bool m_error;
+		qint64 m_currentLine;
+		qint64 m_errorLine;
+		QString m_errorString;
+		const QByteArray m_data;
+		const char* m_pos;
+		const char* m_end;
+		const char* m_tokenStart;
+		QString m_string;
+};
+
+#endif // JSONREADER_H
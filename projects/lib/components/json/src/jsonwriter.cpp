@@ -0,0 +1,198 @@
+/*
+    Copyright (c) 2010 Ilari Pihlajisto
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "jsonwriter.h"
+
+namespace {
+
+inline void appendIndent(QByteArray& out, int indentLevel)
+{
+	for (int i = 0; i < indentLevel; i++)
+		out += '\t';
+}
+
+void appendString(QByteArray& out, const QString& source)
+{
+	static const char hexDigits[] = "0123456789abcdef";
+
+	out += '\"';
+	const QChar* c = source.constData();
+	const QChar* end = c + source.size();
+	for (; c != end; ++c)
+	{
+		const ushort code = c->unicode();
+		switch (code)
+		{
+		case '\"':
+			out += "\\\"";
+			break;
+		case '\\':
+			out += "\\\\";
+			break;
+		case '\b':
+			out += "\\b";
+			break;
+		case '\f':
+			out += "\\f";
+			break;
+		case '\n':
+			out += "\\n";
+			break;
+		case '\r':
+			out += "\\r";
+			break;
+		case '\t':
+			out += "\\t";
+			break;
+		default:
+			if (code >= 128)
+			{
+				out += "\\u";
+				out += hexDigits[(code >> 12) & 0xf];
+				out += hexDigits[(code >> 8) & 0xf];
+				out += hexDigits[(code >> 4) & 0xf];
+				out += hexDigits[code & 0xf];
+			}
+			else
+				out += char(code);
+			break;
+		}
+	}
+	out += '\"';
+}
+
+} // anonymous namespace
+
+
+JsonWriter::JsonWriter(const QVariant& data)
+	: m_error(false),
+	  m_data(data)
+{
+}
+
+bool JsonWriter::hasError() const
+{
+	return m_error;
+}
+
+QString JsonWriter::errorString() const
+{
+	return m_errorString;
+}
+
+void JsonWriter::setError(const QString& message)
+{
+	if (m_error)
+		return;
+	m_error = true;
+	m_errorString = message;
+}
+
+bool JsonWriter::serializeNode(QByteArray& out,
+			       const QVariant& node,
+			       int indentLevel)
+{
+	switch (node.type())
+	{
+	case QVariant::Invalid:
+		out += "null";
+		break;
+	case QVariant::Bool:
+		out += node.toBool() ? "true" : "false";
+		break;
+	case QVariant::Int:
+		out += QByteArray::number(node.toInt());
+		break;
+	case QVariant::LongLong:
+		out += QByteArray::number(node.toLongLong());
+		break;
+	case QVariant::Map:
+		{
+			out += "{\n";
+
+			const QVariantMap map(node.toMap());
+			QVariantMap::const_iterator it;
+			for (it = map.constBegin(); it != map.constEnd(); ++it)
+			{
+				appendIndent(out, indentLevel + 1);
+				appendString(out, it.key());
+				out += " : ";
+				if (!serializeNode(out, it.value(), indentLevel + 1))
+					return false;
+				if (it != map.constEnd() - 1)
+					out += ',';
+				out += '\n';
+			}
+
+			appendIndent(out, indentLevel);
+			out += '}';
+		}
+		break;
+	case QVariant::List:
+	case QVariant::StringList:
+		{
+			out += "[\n";
+
+			const QVariantList list(node.toList());
+			for (int i = 0; i < list.size(); i++)
+			{
+				appendIndent(out, indentLevel + 1);
+				if (!serializeNode(out, list.at(i), indentLevel + 1))
+					return false;
+				if (i != list.size() - 1)
+					out += ',';
+				out += '\n';
+			}
+
+			appendIndent(out, indentLevel);
+			out += ']';
+		}
+		break;
+	case QVariant::String:
+	case QVariant::ByteArray:
+		appendString(out, node.toString());
+		break;
+	default:
+		if (node.canConvert(QVariant::String))
+			out += node.toString().toUtf8();
+		else
+		{
+			setError(tr("Invalid variant type: %1")
+				 .arg(node.typeName()));
+			return false;
+		}
+		break;
+	}
+
+	return true;
+}
+
+bool JsonWriter::serialize(QByteArray& out)
+{
+	bool ok = serializeNode(out, m_data, 0);
+	if (ok)
+		out += '\n';
+	return ok;
+}
@@ -0,0 +1,78 @@
+/*
+    Copyright (c) 2010 Ilari Pihlajisto
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the "Software"), to deal in the Software without
+    restriction, including without limitation the rights to use,
+    copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following
+    conditions:
+
+    The above copyright notice and this permission notice shall be
+    included in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+    OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <QVariant>
+#include <QByteArray>
+#include <QCoreApplication>
+
+
+/*!
+ * \brief A JSON serializer that writes into a byte buffer.
+ *
+ * JsonWriter produces exactly the same output as JsonSerializer and
+ * supports the same QVariant types, but it appends the document to
+ * a QByteArray directly instead of going through a text stream.
+ * Characters outside of ASCII are escaped, so the output is valid
+ * in any ASCII compatible encoding, including UTF-8.
+ *
+ * JSON specification: http://json.org/
+ * \sa JsonSerializer, JsonReader
+ */
+class LIB_EXPORT JsonWriter
+{
+	Q_DECLARE_TR_FUNCTIONS(JsonWriter)
+
+	public:
+		/*! Creates a new writer that operates on \a data. */
+		JsonWriter(const QVariant& data);
+		/*!
+		 * Converts the data into JSON format and appends it to
+		 * \a out.
+		 *
+		 * Returns false if an invalid or unsupported variant type
+		 * is encountered. Otherwise returns true.
+		 */
+		bool serialize(QByteArray& out);
+
+		/*! Returns true if an error occured. */
+		bool hasError() const;
+		/*! Returns a detailed description of the error. */
+		QString errorString() const;
+
+	private:
+		bool serializeNode(QByteArray& out,
+				   const QVariant& node,
+				   int indentLevel);
+		void setError(const QString& message);
+
+		bool m_error;
+		const QVariant m_data;
+		QString m_errorString;
+};
+
+#endif // JSONWRITER_H
@@ -25,6 +25,8 @@
 
 #include <QtTest/QtTest>
 #include <jsonparser.h>
+#include <jsonreader.h>
+#include <jsonserializer.h>
 
 class tst_JsonParser: public QObject
 {
@@ -40,14 +42,96 @@ class tst_JsonParser: public QObject
 		void advanced_data() const;
 		void advanced() const;
 
+		void readerBasics_data() const;
+		void readerBasics() const;
+
+		void readerInvalid_data() const;
+		void readerInvalid() const;
+
+		void readerAdvanced_data() const;
+		void readerAdvanced() const;
+
+		void readerSequence() const;
+		void readerHandler() const;
+
+		void throughput_data() const;
+		void throughput() const;
+
 	private:
 		QVariant sample1() const;
 		QVariant sample2() const;
+		QByteArray tournament(int games) const;
 };
 Q_DECLARE_METATYPE(QVariant)
 Q_DECLARE_METATYPE(QVariant::Type)
 
 
+/*
+ * Counts the games of a tournament's matchProgress array without
+ * building a QVariant tree.
+ */
+class GameCounter : public JsonHandler
+{
+	public:
+		GameCounter()
+			: games(0),
+			  m_depth(0),
+			  m_progressDepth(-1),
+			  m_isProgress(false) {}
+
+		virtual bool beginObject()
+		{
+			if (m_progressDepth != -1 && m_depth == m_progressDepth + 1)
+				games++;
+			m_depth++;
+			m_isProgress = false;
+			return true;
+		}
+
+		virtual bool endObject()
+		{
+			m_depth--;
+			return true;
+		}
+
+		virtual bool beginArray()
+		{
+			if (m_isProgress)
+				m_progressDepth = m_depth;
+			m_isProgress = false;
+			m_depth++;
+			return true;
+		}
+
+		virtual bool endArray()
+		{
+			if (--m_depth == m_progressDepth)
+				m_progressDepth = -1;
+			return true;
+		}
+
+		virtual bool key(const QString& name)
+		{
+			m_isProgress = (name == "matchProgress");
+			return true;
+		}
+
+		virtual bool value(const QVariant& value)
+		{
+			Q_UNUSED(value);
+			m_isProgress = false;
+			return true;
+		}
+
+		int games;
+
+	private:
+		int m_depth;
+		int m_progressDepth;
+		bool m_isProgress;
+};
+
+
 void tst_JsonParser::basics_data() const
 {
 	QTest::addColumn<QString>("input");
@@ -375,5 +459,171 @@ void tst_JsonParser::advanced() const
 	QCOMPARE(data, expected);
 }
 
+void tst_JsonParser::readerBasics_data() const
+{
+	basics_data();
+}
+
+void tst_JsonParser::readerBasics() const
+{
+	QFETCH(QString, input);
+	QFETCH(QVariant::Type, type);
+	QFETCH(QVariant, expected);
+
+	JsonReader reader(input.toUtf8());
+	QVariant data(reader.parse());
+
+	QVERIFY(!reader.hasError());
+	QCOMPARE(data.type(), type);
+	QCOMPARE(data, expected);
+}
+
+void tst_JsonParser::readerInvalid_data() const
+{
+	invalid_data();
+}
+
+void tst_JsonParser::readerInvalid() const
+{
+	QFETCH(QString, input);
+
+	JsonReader reader(input.toUtf8());
+	QVariant data(reader.parse());
+
+	QVERIFY(data.isNull());
+	QVERIFY(reader.hasError());
+}
+
+void tst_JsonParser::readerAdvanced_data() const
+{
+	advanced_data();
+}
+
+void tst_JsonParser::readerAdvanced() const
+{
+	QFETCH(QString, filename);
+	QFETCH(QVariant::Type, type);
+	QFETCH(QVariant, expected);
+
+	QFile file(filename);
+	QVERIFY(file.open(QIODevice::Text | QIODevice::ReadOnly));
+	JsonReader reader(file.readAll());
+	QVariant data(reader.parse());
+
+	QVERIFY(!reader.hasError());
+	QCOMPARE(data.type(), type);
+	QCOMPARE(data, expected);
+}
+
+void tst_JsonParser::readerSequence() const
+{
+	JsonReader reader("{\"sequence\" : 1}\n[2, 3]\n\"\\u00e4\xc3\xa4\"\n4");
+
+	QVariantMap map;
+	map["sequence"] = 1;
+	QCOMPARE(reader.parse(), QVariant(map));
+	QCOMPARE(reader.parse(), QVariant(QVariantList() << 2 << 3));
+	QCOMPARE(reader.parse().toString(), QString(2, QChar(0xe4)));
+	QCOMPARE(reader.parse(), QVariant(4));
+	QVERIFY(!reader.hasError());
+
+	QVERIFY(reader.parse().isNull());
+	QVERIFY(reader.hasError());
+	QCOMPARE(reader.errorLineNumber(), qint64(4));
+}
+
+void tst_JsonParser::readerHandler() const
+{
+	GameCounter counter;
+	JsonReader reader(tournament(100));
+	QVERIFY(reader.parse(&counter));
+	QCOMPARE(counter.games, 100);
+}
+
+QByteArray tst_JsonParser::tournament(int games) const
+{
+	QVariantList progress;
+	for (int i = 0; i < games; i++)
+	{
+		QVariantMap game;
+		game["index"] = i + 1;
+		game["white"] = QString("Engine %1").arg(i % 8);
+		game["black"] = QString("Engine %1").arg((i + 1) % 8);
+		game["startingFen"] = "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1";
+		game["result"] = (i % 3 == 0) ? "1/2-1/2" : "1-0";
+		game["terminationDetails"] = "White mates";
+		game["finished"] = true;
+		progress << game;
+	}
+
+	QVariantMap map;
+	map["tournamentName"] = "Benchmark";
+	map["rounds"] = games;
+	map["matchProgress"] = progress;
+
+	QByteArray bytes;
+	QTextStream stream(&bytes, QIODevice::WriteOnly);
+	JsonSerializer serializer(map);
+	serializer.serialize(stream);
+	stream.flush();
+
+	return bytes;
+}
+
+void tst_JsonParser::throughput_data() const
+{
+	QTest::addColumn<int>("method");
+
+	QTest::newRow("JsonParser") << 0;
+	QTest::newRow("JsonReader") << 1;
+	QTest::newRow("JsonReader handler") << 2;
+}
+
+void tst_JsonParser::throughput() const
+{
+	QFETCH(int, method);
+
+	const int games = 5000;
+	const QByteArray data(tournament(games));
+	qint64 elapsed = 0;
+	int runs = 0;
+	QElapsedTimer timer;
+
+	QBENCHMARK
+	{
+		timer.start();
+
+		if (method == 0)
+		{
+			QTextStream stream(data);
+			JsonParser parser(stream);
+			QVariant result(parser.parse());
+			QVERIFY(!parser.hasError());
+			QCOMPARE(result.toMap()["matchProgress"].toList().size(), games);
+		}
+		else if (method == 1)
+		{
+			JsonReader reader(data);
+			QVariant result(reader.parse());
+			QVERIFY(!reader.hasError());
+			QCOMPARE(result.toMap()["matchProgress"].toList().size(), games);
+		}
+		else
+		{
+			GameCounter counter;
+			JsonReader reader(data);
+			QVERIFY(reader.parse(&counter));
+			QCOMPARE(counter.games, games);
+		}
+
+		elapsed += timer.nsecsElapsed();
+		runs++;
+	}
+
+	if (elapsed > 0)
+		qDebug("%s: %.1f MB/s", QTest::currentDataTag(),
+		       double(data.size()) * runs / (1024 * 1024) / (elapsed / 1e9));
+}
+
 QTEST_MAIN(tst_JsonParser)
 #include "tst_jsonparser.moc"
@@ -26,6 +26,8 @@
 #include <QtTest/QtTest>
 #include <jsonparser.h>
 #include <jsonserializer.h>
+#include <jsonreader.h>
+#include <jsonwriter.h>
 
 class tst_JsonSerializer: public QObject
 {
@@ -35,9 +37,16 @@ class tst_JsonSerializer: public QObject
 		void test_data() const;
 		void test() const;
 
+		void writer_data() const;
+		void writer() const;
+
+		void throughput_data() const;
+		void throughput() const;
+
 	private:
 		QVariant sample1() const;
 		QVariant sample2() const;
+		QVariant tournament(int games) const;
 };
 Q_DECLARE_METATYPE(QVariant)
 
@@ -233,5 +242,103 @@ void tst_JsonSerializer::test() const
 	QCOMPARE(result, input);
 }
 
+void tst_JsonSerializer::writer_data() const
+{
+	test_data();
+}
+
+void tst_JsonSerializer::writer() const
+{
+	QFETCH(QVariant, input);
+
+	QByteArray expected;
+	QTextStream stream(&expected, QIODevice::WriteOnly);
+	JsonSerializer serializer(input);
+	serializer.serialize(stream);
+	stream.flush();
+
+	JsonWriter writer(input);
+	QByteArray bytes;
+	QVERIFY(writer.serialize(bytes));
+	QVERIFY(!writer.hasError());
+	QCOMPARE(bytes, expected);
+
+	JsonReader reader(bytes);
+	QVariant result(reader.parse());
+	QVERIFY(!reader.hasError());
+
+	QCOMPARE(result, input);
+}
+
+QVariant tst_JsonSerializer::tournament(int games) const
+{
+	QVariantList progress;
+	for (int i = 0; i < games; i++)
+	{
+		QVariantMap game;
+		game["index"] = i + 1;
+		game["white"] = QString("Engine %1").arg(i % 8);
+		game["black"] = QString("Engine %1").arg((i + 1) % 8);
+		game["startingFen"] = "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1";
+		game["result"] = (i % 3 == 0) ? "1/2-1/2" : "1-0";
+		game["terminationDetails"] = "White mates";
+		game["finished"] = true;
+		progress << game;
+	}
+
+	QVariantMap map;
+	map["tournamentName"] = "Benchmark";
+	map["rounds"] = games;
+	map["matchProgress"] = progress;
+
+	return QVariant(map);
+}
+
+void tst_JsonSerializer::throughput_data() const
+{
+	QTest::addColumn<bool>("useWriter");
+
+	QTest::newRow("JsonSerializer") << false;
+	QTest::newRow("JsonWriter") << true;
+}
+
+void tst_JsonSerializer::throughput() const
+{
+	QFETCH(bool, useWriter);
+
+	const QVariant data(tournament(5000));
+	qint64 size = 0;
+	qint64 elapsed = 0;
+	int runs = 0;
+	QElapsedTimer timer;
+
+	QBENCHMARK
+	{
+		timer.start();
+
+		QByteArray bytes;
+		if (useWriter)
+		{
+			JsonWriter writer(data);
+			QVERIFY(writer.serialize(bytes));
+		}
+		else
+		{
+			QTextStream stream(&bytes, QIODevice::WriteOnly);
+			JsonSerializer serializer(data);
+			QVERIFY(serializer.serialize(stream));
+			stream.flush();
+		}
+
+		elapsed += timer.nsecsElapsed();
+		runs++;
+		size = bytes.size();
+	}
+
+	if (elapsed > 0)
+		qDebug("%s: %.1f MB/s", QTest::currentDataTag(),
+		       double(size) * runs / (1024 * 1024) / (elapsed / 1e9));
+}
+
 QTEST_MAIN(tst_JsonSerializer)
 #include "tst_jsonserializer.moc"
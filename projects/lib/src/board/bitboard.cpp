@@ -0,0 +1,201 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "bitboard.h"
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace {
+
+// Ray directions. The first four increase the square index.
+enum Direction
+{
+	North,
+	NorthEast,
+	East,
+	NorthWest,
+	South,
+	SouthWest,
+	West,
+	SouthEast,
+	DirectionCount
+};
+
+const int s_fileStep[DirectionCount] = { 0, 1, 1, -1, 0, -1, -1, 1 };
+const int s_rankStep[DirectionCount] = { 1, 1, 0, 1, -1, -1, 0, -1 };
+
+quint64 s_knightAttacks[64];
+quint64 s_kingAttacks[64];
+quint64 s_pawnAttacks[2][64];
+quint64 s_rays[DirectionCount][64];
+bool s_initialized = false;
+QMutex s_mutex;
+
+quint64 squareBit(int file, int rank)
+{
+	if (file < 0 || file > 7 || rank < 0 || rank > 7)
+		return 0;
+	return Q_UINT64_C(1) << (rank * 8 + file);
+}
+
+quint64 rayAttacks(int direction, int square, quint64 occupied)
+{
+	quint64 ray = s_rays[direction][square];
+	quint64 blockers = ray & occupied;
+	if (blockers == 0)
+		return ray;
+
+	int blocker = (direction < South) ? Chess::Bitboard::lsb(blockers)
+					  : Chess::Bitboard::msb(blockers);
+	return ray ^ s_rays[direction][blocker];
+}
+
+} // anonymous namespace
+
+namespace Chess {
+
+void Bitboard::initialize()
+{
+	QMutexLocker locker(&s_mutex);
+
+	if (s_initialized)
+		return;
+
+	for (int sq = 0; sq < 64; sq++)
+	{
+		int file = sq % 8;
+		int rank = sq / 8;
+
+		s_knightAttacks[sq] = squareBit(file + 1, rank + 2)
+				    | squareBit(file - 1, rank + 2)
+				    | squareBit(file + 2, rank + 1)
+				    | squareBit(file - 2, rank + 1)
+				    | squareBit(file + 2, rank - 1)
+				    | squareBit(file - 2, rank - 1)
+				    | squareBit(file + 1, rank - 2)
+				    | squareBit(file - 1, rank - 2);
+
+		s_kingAttacks[sq] = 0;
+		for (int dir = 0; dir < DirectionCount; dir++)
+		{
+			int f = file + s_fileStep[dir];
+			int r = rank + s_rankStep[dir];
+			s_kingAttacks[sq] |= squareBit(f, r);
+
+			s_rays[dir][sq] = 0;
+			for (; squareBit(f, r) != 0; f += s_fileStep[dir], r += s_rankStep[dir])
+				s_rays[dir][sq] |= squareBit(f, r);
+		}
+
+		s_pawnAttacks[Side::White][sq] = squareBit(file - 1, rank + 1)
+					       | squareBit(file + 1, rank + 1);
+		s_pawnAttacks[Side::Black][sq] = squareBit(file - 1, rank - 1)
+					       | squareBit(file + 1, rank - 1);
+	}
+
+	s_initialized = true;
+}
+
+int Bitboard::lsb(quint64 bitboard)
+{
+	Q_ASSERT(bitboard != 0);
+
+#ifdef __GNUC__
+	return __builtin_ctzll(bitboard);
+#else
+	int index = 0;
+	if ((bitboard & 0xFFFFFFFF) == 0)
+	{
+		bitboard >>= 32;
+		index += 32;
+	}
+	quint32 low = quint32(bitboard);
+	while ((low & 1) == 0)
+	{
+		low >>= 1;
+		index++;
+	}
+	return index;
+#endif
+}
+
+int Bitboard::msb(quint64 bitboard)
+{
+	Q_ASSERT(bitboard != 0);
+
+#ifdef __GNUC__
+	return 63 - __builtin_clzll(bitboard);
+#else
+	int index = 0;
+	if (bitboard >> 32)
+	{
+		bitboard >>= 32;
+		index += 32;
+	}
+	quint32 low = quint32(bitboard);
+	while (low >>= 1)
+		index++;
+	return index;
+#endif
+}
+
+int Bitboard::popLsb(quint64& bitboard)
+{
+	int index = lsb(bitboard);
+	bitboard &= bitboard - 1;
+	return index;
+}
+
+quint64 Bitboard::knightAttacks(int square)
+{
+	Q_ASSERT(square >= 0 && square < 64);
+	return s_knightAttacks[square];
+}
+
+quint64 Bitboard::kingAttacks(int square)
+{
+	Q_ASSERT(square >= 0 && square < 64);
+	return s_kingAttacks[square];
+}
+
+quint64 Bitboard::pawnAttacks(Side side, int square)
+{
+	Q_ASSERT(!side.isNull());
+	Q_ASSERT(square >= 0 && square < 64);
+	return s_pawnAttacks[side][square];
+}
+
+quint64 Bitboard::bishopAttacks(int square, quint64 occupied)
+{
+	Q_ASSERT(square >= 0 && square < 64);
+	return rayAttacks(NorthEast, square, occupied)
+	     | rayAttacks(NorthWest, square, occupied)
+	     | rayAttacks(SouthEast, square, occupied)
+	     | rayAttacks(SouthWest, square, occupied);
+}
+
+quint64 Bitboard::rookAttacks(int square, quint64 occupied)
+{
+	Q_ASSERT(square >= 0 && square < 64);
+	return rayAttacks(North, square, occupied)
+	     | rayAttacks(East, square, occupied)
+	     | rayAttacks(South, square, occupied)
+	     | rayAttacks(West, square, occupied);
+}
+
+} // namespace Chess
@@ -0,0 +1,87 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <QtGlobal>
+#include "side.h"
+
+namespace Chess {
+
+/*!
+ * \brief Attack tables for 8x8 bitboards
+ *
+ * A bitboard is a 64-bit set of squares on an 8x8 board. Bit 0 is
+ * the "a1" square, bit 7 is "h1" and bit 63 is "h8".
+ *
+ * The Bitboard class provides precomputed attack sets for the
+ * western chess pieces. Sliding attacks are found by looking up
+ * the ray in each direction and cutting it at the first blocker.
+ *
+ * \note initialize() must be called before using the attack tables.
+ * Chess::Board does it for boards that use bitboards.
+ */
+class LIB_EXPORT Bitboard
+{
+	public:
+		/*! Initializes the attack tables. */
+		static void initialize();
+
+		/*!
+		 * Returns the index of the least significant bit
+		 * in \a bitboard, which must not be empty.
+		 */
+		static int lsb(quint64 bitboard);
+		/*!
+		 * Returns the index of the most significant bit
+		 * in \a bitboard, which must not be empty.
+		 */
+		static int msb(quint64 bitboard);
+		/*!
+		 * Clears the least significant bit in \a bitboard
+		 * and returns its index.
+		 */
+		static int popLsb(quint64& bitboard);
+
+		/*! Returns the squares attacked by a knight at \a square. */
+		static quint64 knightAttacks(int square);
+		/*! Returns the squares attacked by a king at \a square. */
+		static quint64 kingAttacks(int square);
+		/*!
+		 * Returns the squares attacked by a pawn of \a side
+		 * at \a square.
+		 */
+		static quint64 pawnAttacks(Side side, int square);
+		/*!
+		 * Returns the squares attacked by a bishop at \a square
+		 * when the occupied squares are \a occupied.
+		 */
+		static quint64 bishopAttacks(int square, quint64 occupied);
+		/*!
+		 * Returns the squares attacked by a rook at \a square
+		 * when the occupied squares are \a occupied.
+		 */
+		static quint64 rookAttacks(int square, quint64 occupied);
+
+	private:
+		Bitboard();
+};
+
+} // namespace Chess
+#endif // BITBOARD_H
@@ -18,6 +18,7 @@
 #include "board.h"
 #include <QStringList>
 #include "zobrist.h"
+#include "bitboard.h"
 
 
 namespace Chess {
@@ -58,11 +59,17 @@ Board::Board(Zobrist* zobrist)
 	  m_side(Side::White),
 	  m_startingSide(Side::White),
 	  m_key(0),
+	  m_materialKey(0),
 	  m_zobrist(zobrist),
-	  m_sharedZobrist(zobrist)
+	  m_sharedZobrist(zobrist),
+	  m_keyCountSize(0),
+	  m_hasBitboards(false)
 {
 	Q_ASSERT(zobrist != 0);
 
+	m_sideBitboards[Side::White] = 0;
+	m_sideBitboards[Side::Black] = 0;
+
 	setPieceType(Piece::NoPiece, QString(), QString());
 }
 
@@ -75,11 +82,21 @@ bool Board::isRandomVariant() const
 	return false;
 }
 
+int Board::reversibleMoveCount() const
+{
+	return -1;
+}
+
 bool Board::variantHasDrops() const
 {
 	return false;
 }
 
+bool Board::useBitboards() const
+{
+	return false;
+}
+
 QList<Piece> Board::reservePieceTypes() const
 {
 	return QList<Piece>();
@@ -113,6 +130,27 @@ void Board::initialize()
 	for (int i = 0; i < (m_width + 2) * (m_height + 4); i++)
 		m_squares.append(Piece::WallPiece);
 	vInitialize();
+	for (int i = 0; i < 2; i++)
+		m_pieceCount[i].fill(0, m_pieceData.size());
+
+	if (useBitboards())
+	{
+		Q_ASSERT(m_width == 8 && m_height == 8);
+
+		m_hasBitboards = true;
+		m_bitIndex.fill(-1, m_squares.size());
+		m_bitSquare.resize(64);
+		for (int i = 0; i < 64; i++)
+		{
+			// Bitboard index 0 is the bottom-left square
+			int square = (m_width + 2) * (m_height + 1 - i / 8) + 1 + i % 8;
+			m_bitIndex[square] = i;
+			m_bitSquare[i] = square;
+		}
+		for (int i = 0; i < 2; i++)
+			m_pieceBitboards[i].fill(0, m_pieceData.size());
+		Bitboard::initialize();
+	}
 
 	m_zobrist->initialize((m_width + 2) * (m_height + 4), m_pieceData.size());
 }
@@ -165,6 +203,18 @@ Piece Board::pieceFromSymbol(const QString& pieceSymbol) const
 	return Piece(side.opposite(), code);
 }
 
+int Board::pieceTypeFromSymbol(char symbol) const
+{
+	for (int i = 1; i < m_pieceData.size(); i++)
+	{
+		const QString& str = m_pieceData[i].symbol;
+		if (str.length() == 1 && str.at(0) == QLatin1Char(symbol))
+			return i;
+	}
+
+	return Piece::NoPiece;
+}
+
 QString Board::pieceString(int pieceType) const
 {
 	if (pieceType <= 0 || pieceType >= m_pieceData.size())
@@ -319,35 +369,51 @@ QString Board::moveString(const Move& move, MoveNotation notation)
 	return lanMoveString(move);
 }
 
-QString Board::sanStringForPv(const QString& pv, MoveNotation notation)
+QStringList Board::pvStrings(const QVector<Move>& pv, MoveNotation notation)
 {
-	QString str;
-	int made = 0;
-	int i;
+	QStringList strings;
 
-	if (notation == StandardAlgebraic) {
-		QStringList strList = pv.split(' ');
-		if (strList.isEmpty())
-			return str;
+	foreach (const Move& move, pv)
+	{
+		strings.append(moveString(move, notation));
+		makeMove(move);
+	}
+	for (int i = 0; i < pv.size(); i++)
+		undoMove();
+
+	return strings;
+}
+
+QVector<Move> Board::pvFromString(const QString& pv, MoveNotation notation)
+{
+	QVector<Move> moves;
+
+	foreach (const QString& token, pv.split(' '))
+	{
+		if (token.isEmpty())
+			break;
 
-		for (i = 0; i < strList.length(); i++)
+		Move move;
+		if (notation == LongAlgebraic)
 		{
-			QString token = strList.at(i);
-			if (!token.length())
+			move = moveFromLanString(token);
+			if (!isLegalMove(move))
 				break;
-			Move move = moveFromString(token);
+		}
+		else
+		{
+			move = moveFromString(token);
 			if (move.isNull())
 				break;
-			str += (made > 0) ? " " : "";
-			str += sanMoveString(move);
-			makeMove(move);
-			made++;
-		}
-		for (i = 0; i < made; i++) {
-			undoMove();
 		}
+
+		moves.append(move);
+		makeMove(move);
 	}
-	return str;
+	for (int i = 0; i < moves.size(); i++)
+		undoMove();
+
+	return moves;
 }
 
 Move Board::moveFromLanString(const QString& str)
@@ -504,6 +570,13 @@ bool Board::setFenString(const QString& fen)
 	for (int i = 0; i < m_squares.size(); i++)
 		m_squares[i] = Piece::WallPiece;
 	m_key = 0;
+	m_materialKey = 0;
+	for (int i = 0; i < 2; i++)
+	{
+		m_pieceCount[i].fill(0);
+		m_pieceBitboards[i].fill(0);
+		m_sideBitboards[i] = 0;
+	}
 
 	// Get the board contents (squares)
 	QString pieceStr;
@@ -605,6 +678,7 @@ bool Board::setFenString(const QString& fen)
 	}
 
 	m_moveHistory.clear();
+	clearKeyCounts();
 	m_startingFen = fen;
 
 	// Let subclasses handle the rest of the FEN string
@@ -640,6 +714,7 @@ void Board::makeMove(const Move& move, BoardTransition* transition)
 	xorKey(m_zobrist->side());
 	m_side = m_side.opposite();
 	m_moveHistory << md;
+	addKeyCount(md.key);
 }
 
 void Board::undoMove()
@@ -652,6 +727,7 @@ void Board::undoMove()
 
 	m_key = m_moveHistory.last().key;
 	m_moveHistory.pop_back();
+	removeKeyCount(m_key);
 }
 
 void Board::generateMoves(QVarLengthArray<Move>& moves, int pieceType) const
@@ -694,6 +770,20 @@ void Board::generateDropMoves(QVarLengthArray<Move>& moves, int pieceType) const
 		generateMovesForPiece(moves, pieceType, 0);
 }
 
+quint64 Board::movementBitboard(Side side, unsigned movement) const
+{
+	Q_ASSERT(m_hasBitboards);
+
+	quint64 bitboard = 0;
+	const QVector<quint64>& bitboards(m_pieceBitboards[side]);
+	for (int i = 1; i < m_pieceData.size(); i++)
+	{
+		if (m_pieceData[i].movement & movement)
+			bitboard |= bitboards[i];
+	}
+	return bitboard;
+}
+
 void Board::generateHoppingMoves(int sourceSquare,
 				 const QVarLengthArray<int>& offsets,
 				 QVarLengthArray<Move>& moves) const
@@ -782,11 +872,20 @@ bool Board::isLegalMove(const Move& move)
 
 int Board::repeatCount() const
 {
-	if (plyCount() < 4)
+	if (plyCount() < 4 || keyCount(m_key) == 0)
 		return 0;
 
+	// Positions before the last irreversible move can't repeat,
+	// except in variants where captured pieces can be dropped back
+	int end = 0;
+	int reversibleCount = reversibleMoveCount();
+	if (reversibleCount >= 0 && !variantHasDrops())
+		end = qMax(0, plyCount() - reversibleCount);
+
+	// The side to move is part of the key, so only every other
+	// position can be the same as the current one
 	int repeatCount = 0;
-	for (int i = plyCount() - 1; i >= 0; i--)
+	for (int i = plyCount() - 2; i >= end; i -= 2)
 	{
 		if (m_moveHistory.at(i).key == m_key)
 			repeatCount++;
@@ -795,6 +894,92 @@ int Board::repeatCount() const
 	return repeatCount;
 }
 
+int Board::keyCount(quint64 key) const
+{
+	if (m_keyCounts.isEmpty())
+		return 0;
+
+	int mask = m_keyCounts.size() - 1;
+	for (int i = int(key & mask); ; i = (i + 1) & mask)
+	{
+		const KeyCount& slot = m_keyCounts.at(i);
+		if (slot.count == 0)
+			return 0;
+		if (slot.key == key)
+			return slot.count;
+	}
+}
+
+void Board::addKeyCount(quint64 key)
+{
+	// Keep the table at most half full
+	if ((m_keyCountSize + 1) * 2 > m_keyCounts.size())
+	{
+		QVector<KeyCount> old(m_keyCounts);
+		KeyCount empty = { 0, 0 };
+		m_keyCounts.fill(empty, qMax(64, old.size() * 2));
+
+		int mask = m_keyCounts.size() - 1;
+		foreach (const KeyCount& slot, old)
+		{
+			if (slot.count == 0)
+				continue;
+			int i = int(slot.key & mask);
+			while (m_keyCounts[i].count > 0)
+				i = (i + 1) & mask;
+			m_keyCounts[i] = slot;
+		}
+	}
+
+	int mask = m_keyCounts.size() - 1;
+	int i = int(key & mask);
+	while (m_keyCounts[i].count > 0 && m_keyCounts[i].key != key)
+		i = (i + 1) & mask;
+
+	KeyCount& slot = m_keyCounts[i];
+	if (slot.count++ == 0)
+	{
+		slot.key = key;
+		m_keyCountSize++;
+	}
+}
+
+void Board::removeKeyCount(quint64 key)
+{
+	Q_ASSERT(!m_keyCounts.isEmpty());
+
+	int mask = m_keyCounts.size() - 1;
+	int i = int(key & mask);
+	while (m_keyCounts[i].key != key || m_keyCounts[i].count == 0)
+		i = (i + 1) & mask;
+
+	if (--m_keyCounts[i].count > 0)
+		return;
+	m_keyCountSize--;
+
+	// Shift the following keys back so that no probe sequence
+	// goes through the freed slot
+	for (int j = (i + 1) & mask; m_keyCounts[j].count > 0; j = (j + 1) & mask)
+	{
+		int home = int(m_keyCounts[j].key & mask);
+		bool between = (i <= j) ? (i < home && home <= j)
+					: (i < home || home <= j);
+		if (!between)
+		{
+			m_keyCounts[i] = m_keyCounts[j];
+			m_keyCounts[j].count = 0;
+			i = j;
+		}
+	}
+}
+
+void Board::clearKeyCounts()
+{
+	KeyCount empty = { 0, 0 };
+	m_keyCounts.fill(empty);
+	m_keyCountSize = 0;
+}
+
 bool Board::isRepetition(const Chess::Move& move)
 {
 	Q_ASSERT(!move.isNull());
@@ -809,15 +994,22 @@ bool Board::isRepetition(const Chess::Move& move)
 bool Board::canMove()
 {
 	QVarLengthArray<Move> moves;
+	generateLegalMoves(moves);
+
+	return !moves.isEmpty();
+}
+
+void Board::generateLegalMoves(QVarLengthArray<Move>& moves)
+{
 	generateMoves(moves);
 
+	int count = 0;
 	for (int i = 0; i < moves.size(); i++)
 	{
 		if (vIsLegalMove(moves[i]))
-			return true;
+			moves[count++] = moves[i];
 	}
-
-	return false;
+	moves.resize(count);
 }
 
 QVector<Move> Board::legalMoves()
@@ -825,21 +1017,19 @@ QVector<Move> Board::legalMoves()
 	QVarLengthArray<Move> moves;
 	QVector<Move> legalMoves;
 
-	generateMoves(moves);
+	generateLegalMoves(moves);
 	legalMoves.reserve(moves.size());
 
 	for (int i = moves.size() - 1; i >= 0; i--)
-	{
-		if (vIsLegalMove(moves[i]))
-			legalMoves << moves[i];
-	}
+		legalMoves << moves[i];
 
 	return legalMoves;
 }
 
-Result Board::tablebaseResult(unsigned int* dtm) const
+Result Board::tablebaseResult(unsigned int* dtm, TablebaseCache* cache) const
 {
 	Q_UNUSED(dtm);
+	Q_UNUSED(cache);
 	return Result();
 }
 
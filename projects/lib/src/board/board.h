@@ -19,6 +19,7 @@
 #define BOARD_H
 
 #include <QString>
+#include <QStringList>
 #include <QVector>
 #include <QVarLengthArray>
 #include <QSharedPointer>
@@ -31,6 +32,7 @@
 #include "zobrist.h"
 #include "result.h"
 class QStringList;
+class TablebaseCache;
 
 
 namespace Chess {
@@ -190,11 +192,32 @@ class LIB_EXPORT Board
 		Side startingSide() const;
 		/*! Returns the piece at \a square. */
 		Piece pieceAt(const Square& square) const;
+		/*!
+		 * Returns the number of pieces of type \a type that \a side
+		 * has on the board.
+		 *
+		 * If \a side is Side::NoSide, pieces of both sides are counted.
+		 * If \a type is Piece::NoPiece, pieces of every type are counted.
+		 * Pieces in reserve are not included.
+		 */
+		int pieceCount(Side side = Side::NoSide,
+			       int type = Piece::NoPiece) const;
+		/*!
+		 * Returns the material key for the current position.
+		 *
+		 * The material key depends only on the number of pieces of
+		 * each type and side on the board, not on their squares.
+		 */
+		quint64 materialKey() const;
 		/*! Returns the number of halfmoves (plies) played. */
 		int plyCount() const;
 		/*!
 		 * Returns the number of times the current position was
 		 * reached previously in the game.
+		 *
+		 * Only the positions after the last irreversible move are
+		 * compared if the variant reports a reversibleMoveCount()
+		 * and doesn't have piece drops.
 		 */
 		int repeatCount() const;
 		/*!
@@ -230,7 +253,24 @@ class LIB_EXPORT Board
 		 * \sa moveFromString()
 		 */
 		QString moveString(const Move& move, MoveNotation notation);
-		QString sanStringForPv(const QString& pv, MoveNotation notation);
+		/*!
+		 * Converts a principal variation into move strings.
+		 *
+		 * The moves of \a pv are made on the board one at a time
+		 * to get their strings in \a notation, and then undone.
+		 * \sa pvFromString()
+		 */
+		QStringList pvStrings(const QVector<Move>& pv, MoveNotation notation);
+		/*!
+		 * Converts \a pv, a space-separated sequence of move strings
+		 * starting from the current position, into a list of moves.
+		 *
+		 * If \a notation is \a LongAlgebraic only long algebraic
+		 * moves are accepted; otherwise the notation is detected
+		 * like in moveFromString(). The conversion stops at the
+		 * first move that isn't legal.
+		 */
+		QVector<Move> pvFromString(const QString& pv, MoveNotation notation);
 		/*!
 		 * Converts a move string into a Move.
 		 *
@@ -264,6 +304,13 @@ class LIB_EXPORT Board
 		bool isRepetition(const Move& move);
 		/*! Returns a vector of legal moves in the current position. */
 		QVector<Move> legalMoves();
+		/*!
+		 * Returns the number of consecutive reversible moves made,
+		 * or -1 if the variant doesn't keep track of them.
+		 *
+		 * The default implementation returns -1.
+		 */
+		virtual int reversibleMoveCount() const;
 		/*!
 		 * Returns the result of the game, or Result::NoResult if
 		 * the game is in progress.
@@ -276,9 +323,13 @@ class LIB_EXPORT Board
 		 * set to the distance to mate, ie. the number of plies it
 		 * takes to force a mate.
 		 *
+		 * If \a dtm is null the result is only meant for adjudication,
+		 * and probe results may be stored in and reused from \a cache.
+		 *
 		 * The default implementation always returns a null result.
 		 */
-		virtual Result tablebaseResult(unsigned int* dtm = 0) const;
+		virtual Result tablebaseResult(unsigned int* dtm = 0,
+					       TablebaseCache* cache = 0) const;
 
 	protected:
 		/*!
@@ -288,6 +339,16 @@ class LIB_EXPORT Board
 		 * generally call it by themselves.
 		 */
 		virtual void vInitialize() = 0;
+		/*!
+		 * Returns true if the board should keep bitboards of the
+		 * pieces in addition to the board array.
+		 *
+		 * Bitboards are only supported on 8x8 boards.
+		 * The default value is false.
+		 *
+		 * \sa Bitboard
+		 */
+		virtual bool useBitboards() const;
 
 		/*!
 		 * Defines a piece type used in the variant.
@@ -307,6 +368,34 @@ class LIB_EXPORT Board
 				  unsigned movement = 0);
 		/*! Returns true if \pieceType can move like \a movement. */
 		bool pieceHasMovement(int pieceType, unsigned movement) const;
+		/*!
+		 * Returns the type of the piece whose upper-case symbol is
+		 * \a symbol, or Piece::NoPiece if there's no such piece.
+		 *
+		 * Unlike pieceFromSymbol(), this function only recognizes
+		 * single-character symbols and doesn't allocate memory.
+		 */
+		int pieceTypeFromSymbol(char symbol) const;
+		/*! Returns true if the board keeps bitboards of the pieces. */
+		bool hasBitboards() const;
+		/*!
+		 * Returns the bitboard index of \a square, or -1 if
+		 * \a square is outside the board.
+		 *
+		 * \note Only valid if hasBitboards() is true.
+		 */
+		int bitIndex(int square) const;
+		/*! Returns the board array square of bitboard index \a index. */
+		int bitSquare(int index) const;
+		/*! Returns the squares occupied by \a side. */
+		quint64 sideBitboard(Side side) const;
+		/*! Returns the squares occupied by \a piece. */
+		quint64 pieceBitboard(const Piece& piece) const;
+		/*!
+		 * Returns the squares occupied by pieces of \a side that can
+		 * move like \a movement.
+		 */
+		quint64 movementBitboard(Side side, unsigned movement) const;
 
 		/*!
 		 * Makes \a move on the board.
@@ -458,6 +547,14 @@ class LIB_EXPORT Board
 		bool moveExists(const Move& move) const;
 		/*! Returns true if the side to move has any legal moves. */
 		bool canMove();
+		/*!
+		 * Generates the legal moves of the side to move.
+		 *
+		 * The default implementation generates pseudo-legal moves
+		 * and keeps the ones accepted by vIsLegalMove().
+		 * \sa legalMoves()
+		 */
+		virtual void generateLegalMoves(QVarLengthArray<Move>& moves);
 		/*!
 		 * Returns the size of the board array, including the padding
 		 * (the inaccessible wall squares).
@@ -468,8 +565,9 @@ class LIB_EXPORT Board
 		/*!
 		 * Sets \a square to contain \a piece.
 		 *
-		 * This function also updates the zobrist position key, so
-		 * subclasses shouldn't mess with it directly.
+		 * This function also updates the zobrist position key, the
+		 * piece counts and the material key, so subclasses shouldn't
+		 * mess with them directly.
 		 */
 		void setSquare(int square, Piece piece);
 		/*! Returns the last move made in the game. */
@@ -501,8 +599,19 @@ class LIB_EXPORT Board
 			Move move;
 			quint64 key;
 		};
+		// A slot in the open-addressing table of position keys
+		struct KeyCount
+		{
+			quint64 key;
+			int count;
+		};
 		friend LIB_EXPORT QDebug operator<<(QDebug dbg, const Board* board);
 
+		int keyCount(quint64 key) const;
+		void addKeyCount(quint64 key);
+		void removeKeyCount(quint64 key);
+		void clearKeyCounts();
+
 		bool m_initialized;
 		int m_width;
 		int m_height;
@@ -510,12 +619,21 @@ class LIB_EXPORT Board
 		Side m_startingSide;
 		QString m_startingFen;
 		quint64 m_key;
+		quint64 m_materialKey;
 		Zobrist* m_zobrist;
 		QSharedPointer<Zobrist> m_sharedZobrist;
 		QVarLengthArray<PieceData> m_pieceData;
 		QVarLengthArray<Piece> m_squares;
 		QVector<MoveData> m_moveHistory;
+		QVector<KeyCount> m_keyCounts;
+		int m_keyCountSize;
 		QVector<int> m_reserve[2];
+		QVector<int> m_pieceCount[2];
+		bool m_hasBitboards;
+		QVector<int> m_bitIndex;
+		QVector<int> m_bitSquare;
+		QVector<quint64> m_pieceBitboards[2];
+		quint64 m_sideBitboards[2];
 };
 
 
@@ -546,6 +664,19 @@ inline quint64 Board::key() const
 	return m_key;
 }
 
+inline int Board::pieceCount(Side side, int type) const
+{
+	if (side.isNull())
+		return m_pieceCount[Side::White].at(type)
+		     + m_pieceCount[Side::Black].at(type);
+	return m_pieceCount[side].at(type);
+}
+
+inline quint64 Board::materialKey() const
+{
+	return m_materialKey;
+}
+
 inline void Board::xorKey(quint64 key)
 {
 	m_key ^= key;
@@ -560,10 +691,36 @@ inline void Board::setSquare(int square, Piece piece)
 {
 	Piece& old = m_squares[square];
 	if (old.isValid())
+	{
 		xorKey(m_zobrist->piece(old, square));
+
+		QVector<int>& counts = m_pieceCount[old.side()];
+		m_materialKey ^= m_zobrist->reservePiece(old, --counts[old.type()]);
+		counts[Piece::NoPiece]--;
+
+		if (m_hasBitboards)
+		{
+			quint64 bit = Q_UINT64_C(1) << m_bitIndex[square];
+			m_pieceBitboards[old.side()][old.type()] &= ~bit;
+			m_sideBitboards[old.side()] &= ~bit;
+		}
+	}
 	if (piece.isValid())
+	{
 		xorKey(m_zobrist->piece(piece, square));
 
+		QVector<int>& counts = m_pieceCount[piece.side()];
+		m_materialKey ^= m_zobrist->reservePiece(piece, counts[piece.type()]++);
+		counts[Piece::NoPiece]++;
+
+		if (m_hasBitboards)
+		{
+			quint64 bit = Q_UINT64_C(1) << m_bitIndex[square];
+			m_pieceBitboards[piece.side()][piece.type()] |= bit;
+			m_sideBitboards[piece.side()] |= bit;
+		}
+	}
+
 	old = piece;
 }
 
@@ -585,5 +742,30 @@ inline bool Board::pieceHasMovement(int pieceType, unsigned movement) const
 	return (m_pieceData[pieceType].movement & movement);
 }
 
+inline bool Board::hasBitboards() const
+{
+	return m_hasBitboards;
+}
+
+inline int Board::bitIndex(int square) const
+{
+	return m_bitIndex[square];
+}
+
+inline int Board::bitSquare(int index) const
+{
+	return m_bitSquare[index];
+}
+
+inline quint64 Board::sideBitboard(Side side) const
+{
+	return m_sideBitboards[side];
+}
+
+inline quint64 Board::pieceBitboard(const Piece& piece) const
+{
+	return m_pieceBitboards[piece.side()][piece.type()];
+}
+
 } // namespace Chess
 #endif // BOARD_H
@@ -17,7 +17,9 @@ SOURCES += $$PWD/board.cpp \
     $$PWD/crazyhouseboard.cpp \
     $$PWD/boardfactory.cpp \
     $$PWD/boardtransition.cpp \
-    $$PWD/syzygytablebase.cpp
+    $$PWD/syzygytablebase.cpp \
+    $$PWD/tablebasecache.cpp \
+    $$PWD/bitboard.cpp
 HEADERS += $$PWD/board.h \
     $$PWD/move.h \
     $$PWD/piece.h \
@@ -38,4 +40,6 @@ HEADERS += $$PWD/board.h \
     $$PWD/crazyhouseboard.h \
     $$PWD/boardfactory.h \
     $$PWD/boardtransition.h \
-    $$PWD/syzygytablebase.h
+    $$PWD/syzygytablebase.h \
+    $$PWD/tablebasecache.h \
+    $$PWD/bitboard.h
@@ -49,6 +49,11 @@ bool LosersBoard::vSetFenString(const QStringList& fen)
 	return WesternBoard::vSetFenString(fen);
 }
 
+bool LosersBoard::hasCustomLegality() const
+{
+	return true;
+}
+
 bool LosersBoard::vIsLegalMove(const Move& move)
 {
 	bool isCapture = (captureType(move) != Piece::NoPiece);
@@ -45,6 +45,7 @@ class LIB_EXPORT LosersBoard : public WesternBoard
 
 	protected:
 		// Inherited from WesternBoard
+		virtual bool hasCustomLegality() const;
 		virtual bool vSetFenString(const QStringList& fen);
 		virtual bool vIsLegalMove(const Move& move);
 
@@ -1069,19 +1069,18 @@ QString StandardBoard::defaultFenString() const
 	return "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 }
 
-Result StandardBoard::tablebaseResult(unsigned int* dtz) const
+Result StandardBoard::tablebaseResult(unsigned int* dtz,
+				       TablebaseCache* cache) const
 {
-	SyzygyTablebase::PieceList pieces;
+	if (!SyzygyTablebase::tbAvailable(pieceCount()))
+		return Result();
 
+	SyzygyTablebase::PieceList pieces;
 	for (int i = 0; i < arraySize(); i++)
 	{
 		Piece piece(pieceAt(i));
 		if (piece.isValid())
-		{
-			if (pieces.size() > 6)
-				return Result();
 			pieces.append(qMakePair(chessSquare(i), piece));
-		}
 	}
 
 	SyzygyTablebase::Castling castling = 0;
@@ -1094,6 +1093,14 @@ Result StandardBoard::tablebaseResult(unsigned int* dtz) const
 	if (hasCastlingRight(Chess::Side::Black, QueenSide))
 		castling |= SyzygyTablebase::BlackQueenSide;
 
+	if (dtz == 0)
+		return SyzygyTablebase::adjudicationResult(sideToMove(),
+							   chessSquare(enpassantSquare()),
+							   castling,
+							   reversibleMoveCount(),
+							   pieces,
+							   key(),
+							   cache);
 	return SyzygyTablebase::result(sideToMove(),
 					chessSquare(enpassantSquare()),
 					castling,
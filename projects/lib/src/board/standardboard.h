@@ -44,7 +44,8 @@ class LIB_EXPORT StandardBoard : public WesternBoard
 		virtual Board* copy() const;
 		virtual QString variant() const;
 		virtual QString defaultFenString() const;
-		virtual Result tablebaseResult(unsigned int* dtm = 0) const;
+		virtual Result tablebaseResult(unsigned int* dtm = 0,
+					       TablebaseCache* cache = 0) const;
 };
 
 } // namespace Chess
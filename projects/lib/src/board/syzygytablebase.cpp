@@ -17,16 +17,15 @@
 
 #include "syzygytablebase.h"
 #include <QDir>
-#include <QMutex>
 #include <QStringList>
 #include <tbprobe.h>
 #include "westernboard.h"
+#include "tablebasecache.h"
 
 namespace {
 
 bool s_initialized = false, s_initOK = false, s_noRule50 = false;
 int s_pieces = INT_MAX;
-QMutex s_mutex;
 
 int tbSquare(const Chess::Square& square)
 {
@@ -35,6 +34,47 @@ int tbSquare(const Chess::Square& square)
 	return square.rank() * 8 + square.file();
 }
 
+struct TbPosition
+{
+	explicit TbPosition(const SyzygyTablebase::PieceList& pieces);
+
+	uint64_t white, black;
+	uint64_t kings, queens, rooks, bishops, knights, pawns;
+};
+
+TbPosition::TbPosition(const SyzygyTablebase::PieceList& pieces)
+	: white(0), black(0),
+	  kings(0), queens(0), rooks(0), bishops(0), knights(0), pawns(0)
+{
+	typedef QPair<Chess::Square, Chess::Piece> PcSq;
+	foreach (const PcSq& item, pieces)
+	{
+		if (tbSquare(item.first) < 0)
+			continue;
+		unsigned sq = tbSquare(item.first);
+		uint64_t bit = ((uint64_t)1 << sq);
+		if (item.second.side() == Chess::Side::White)
+			white |= bit;
+		else
+			black |= bit;
+		switch (item.second.type())
+		{
+		case Chess::WesternBoard::Pawn:
+			pawns |= bit; break;
+		case Chess::WesternBoard::Knight:
+			knights |= bit; break;
+		case Chess::WesternBoard::Bishop:
+			bishops |= bit; break;
+		case Chess::WesternBoard::Rook:
+			rooks |= bit; break;
+		case Chess::WesternBoard::Queen:
+			queens |= bit; break;
+		case Chess::WesternBoard::King:
+			kings |= bit; break;
+		}
+	}
+}
+
 } // anonymous namespace
 
 bool SyzygyTablebase::initialize(const QString& path)
@@ -81,41 +121,13 @@ Chess::Result SyzygyTablebase::result(const Chess::Side& side,
 
 	bool wtm = (side == Chess::Side::White);
 	unsigned ep = (tbSquare(enpassantSq) < 0? 0: tbSquare(enpassantSq));
-	uint64_t white = 0, black = 0;
-	uint64_t kings = 0, queens = 0, rooks = 0, bishops = 0, knights = 0,
-		pawns = 0;
-	typedef QPair<Chess::Square, Chess::Piece> PcSq;
-	foreach (const PcSq& item, pieces)
-	{
-		if (tbSquare(item.first) < 0)
-			continue;
-		unsigned sq = tbSquare(item.first);
-		uint64_t bit = ((uint64_t)1 << sq);
-		if (item.second.side() == Chess::Side::White)
-			white |= bit;
-		else
-			black |= bit;
-		switch (item.second.type())
-		{
-		case Chess::WesternBoard::Pawn:
-			pawns |= bit; break;
-		case Chess::WesternBoard::Knight:
-			knights |= bit; break;
-		case Chess::WesternBoard::Bishop:
-			bishops |= bit; break;
-		case Chess::WesternBoard::Rook:
-			rooks |= bit; break;
-		case Chess::WesternBoard::Queen:
-			queens |= bit; break;
-		case Chess::WesternBoard::King:
-			kings |= bit; break;
-		}
-	}
+	TbPosition pos(pieces);
 
-	s_mutex.lock();
-	unsigned result = tb_probe_root(white, black, kings, queens, rooks,
-		bishops, knights, pawns, rule50, 0, ep, wtm, nullptr);
-	s_mutex.unlock();
+	// Fathom is built with thread support, so probes from several
+	// game threads can run concurrently.
+	unsigned result = tb_probe_root(pos.white, pos.black, pos.kings,
+		pos.queens, pos.rooks, pos.bishops, pos.knights, pos.pawns,
+		rule50, 0, ep, wtm, nullptr);
 
 	Chess::Side winner(Chess::Side::NoSide); 
 	if (result == TB_RESULT_FAILED)
@@ -150,3 +162,82 @@ Chess::Result SyzygyTablebase::result(const Chess::Side& side,
 		*dtz = TB_GET_DTZ(result);
 	return Chess::Result(Chess::Result::Adjudication, winner, "SyzygyTB");
 }
+
+Chess::Result SyzygyTablebase::adjudicationResult(const Chess::Side& side,
+						  const Chess::Square& enpassantSq,
+						  Castling castling,
+						  int rule50,
+						  const PieceList& pieces,
+						  quint64 key,
+						  TablebaseCache* cache)
+{
+	if (!s_initOK)
+		return Chess::Result();
+	if (castling)
+		return Chess::Result();
+	if (pieces.size() > s_pieces)
+		return Chess::Result();
+
+	bool wtm = (side == Chess::Side::White);
+	unsigned ep = (tbSquare(enpassantSq) < 0? 0: tbSquare(enpassantSq));
+	TbPosition pos(pieces);
+
+	int wdl = -1;
+	int dtz = -1;
+	if (cache == nullptr || !cache->lookup(key, &wdl, &dtz))
+	{
+		// The WDL tables are much smaller and faster to probe than
+		// the DTZ tables, so try them first. The probe is done with
+		// a zero 50-move counter so that the result can be cached.
+		wdl = tb_probe_wdl(pos.white, pos.black, pos.kings,
+			pos.queens, pos.rooks, pos.bishops, pos.knights,
+			pos.pawns, 0, 0, ep, wtm);
+		if (wdl == (int)TB_RESULT_FAILED)
+			return Chess::Result();
+		if (cache != nullptr)
+			cache->store(key, wdl);
+	}
+
+	Chess::Side winner(Chess::Side::NoSide);
+	switch (wdl)
+	{
+	case TB_BLESSED_LOSS:
+		if (!s_noRule50)
+			break;
+		// Fallthrough
+	case TB_LOSS:
+		winner = side.opposite();
+		break;
+	case TB_DRAW:
+		break;
+	case TB_CURSED_WIN:
+		if (!s_noRule50)
+			break;
+		// Fallthrough
+	case TB_WIN:
+		winner = side;
+		break;
+	}
+
+	// A decisive position can still be drawn by the 50-move rule if
+	// the counter is already running, which only the DTZ tables can
+	// tell.
+	if ((wdl == TB_WIN || wdl == TB_LOSS) && rule50 > 0 && !s_noRule50)
+	{
+		if (dtz < 0)
+		{
+			unsigned result = tb_probe_root(pos.white, pos.black,
+				pos.kings, pos.queens, pos.rooks, pos.bishops,
+				pos.knights, pos.pawns, 0, 0, ep, wtm, nullptr);
+			if (result == TB_RESULT_FAILED)
+				return Chess::Result();
+			dtz = TB_GET_DTZ(result);
+			if (cache != nullptr)
+				cache->store(key, wdl, dtz);
+		}
+		if (dtz + rule50 > 100)
+			winner = Chess::Side::NoSide;
+	}
+
+	return Chess::Result(Chess::Result::Adjudication, winner, "SyzygyTB");
+}
@@ -24,6 +24,7 @@
 #include "result.h"
 #include "square.h"
 #include "piece.h"
+class TablebaseCache;
 
 /*!
  * \brief A wrapper for probing Syzygy endgame tablebases.
@@ -35,6 +36,9 @@
  * positions. The Syzygy tablebases take the 50-move-rule into account.
  * Syzygy tablebases can only be used in standard chess and Fischer
  * Random chess.
+ *
+ * After initialize() has returned the tablebases can be probed from
+ * multiple threads at the same time.
  */
 class LIB_EXPORT SyzygyTablebase
 {
@@ -95,6 +99,26 @@ class LIB_EXPORT SyzygyTablebase
 					    int rule50,
 					    const PieceList& pieces,
 					    unsigned int* dtz = nullptr);
+		/*!
+		 * Returns the expected game result for the position specified
+		 * by \a side, \a enpassantSq, \a castling, \a rule50 and
+		 * \a pieces for adjudication purposes.
+		 *
+		 * Unlike result() this function probes the WDL tables first
+		 * and only needs the DTZ tables when a decisive position may
+		 * be drawn by the 50-move rule. If \a cache is not null, the
+		 * probe results are stored in it under the zobrist key \a key.
+		 *
+		 * If the position isn't found in the tablebases, a null result
+		 * is returned.
+		 */
+		static Chess::Result adjudicationResult(const Chess::Side& side,
+							const Chess::Square& enpassantSq,
+							Castling castling,
+							int rule50,
+							const PieceList& pieces,
+							quint64 key,
+							TablebaseCache* cache = nullptr);
 
 	private:
 		SyzygyTablebase();
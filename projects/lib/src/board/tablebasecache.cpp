@@ -0,0 +1,94 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tablebasecache.h"
+#include <QMutexLocker>
+
+TablebaseCache::TablebaseCache(int size)
+	: m_size(1),
+	  m_hits(0),
+	  m_misses(0)
+{
+	Q_ASSERT(size > 0);
+
+	// Round the size up to a power of two so that the key can be
+	// masked into an index.
+	while (m_size < size)
+		m_size <<= 1;
+}
+
+bool TablebaseCache::lookup(quint64 key, int* wdl, int* dtz) const
+{
+	Q_ASSERT(wdl != 0);
+	Q_ASSERT(dtz != 0);
+
+	QMutexLocker locker(&m_mutex);
+
+	if (!m_entries.isEmpty())
+	{
+		const Entry& entry = m_entries.at(int(key & (m_size - 1)));
+		if (entry.wdl >= 0 && entry.key == key)
+		{
+			m_hits++;
+			*wdl = entry.wdl;
+			*dtz = entry.dtz;
+			return true;
+		}
+	}
+
+	m_misses++;
+	return false;
+}
+
+void TablebaseCache::store(quint64 key, int wdl, int dtz)
+{
+	Q_ASSERT(wdl >= 0);
+
+	QMutexLocker locker(&m_mutex);
+
+	if (m_entries.isEmpty())
+	{
+		Entry empty = { 0, -1, -1 };
+		m_entries.fill(empty, m_size);
+	}
+
+	Entry& entry = m_entries[int(key & (m_size - 1))];
+	entry.key = key;
+	entry.wdl = wdl;
+	entry.dtz = dtz;
+}
+
+void TablebaseCache::clear()
+{
+	QMutexLocker locker(&m_mutex);
+
+	m_entries.clear();
+	m_hits = 0;
+	m_misses = 0;
+}
+
+quint64 TablebaseCache::hits() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_hits;
+}
+
+quint64 TablebaseCache::misses() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_misses;
+}
@@ -0,0 +1,89 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TABLEBASECACHE_H
+#define TABLEBASECACHE_H
+
+#include <QVector>
+#include <QMutex>
+
+/*!
+ * \brief A bounded cache for tablebase probe results.
+ *
+ * TablebaseCache stores the raw WDL (win-draw-loss) value and, when it
+ * has been probed, the DTZ (distance to zero) value of tablebase
+ * positions. The entries are indexed by the zobrist key of the
+ * position. Neither value depends on the 50-move counter, so the same
+ * entry can be used whenever a position is reached again.
+ *
+ * The cache has a fixed number of entries and newer positions replace
+ * older ones. It's safe to share one cache between games that are
+ * played in different threads.
+ *
+ * \sa SyzygyTablebase
+ */
+class LIB_EXPORT TablebaseCache
+{
+	public:
+		/*!
+		 * Creates a new cache with room for at least \a size
+		 * positions.
+		 *
+		 * Memory for the entries is allocated when the first
+		 * position is stored.
+		 */
+		explicit TablebaseCache(int size = 0x10000);
+
+		/*!
+		 * Looks up the position with zobrist key \a key.
+		 *
+		 * Returns true and sets \a wdl and \a dtz if the position is
+		 * found; otherwise returns false. \a dtz is set to -1 if only
+		 * the WDL value is known.
+		 */
+		bool lookup(quint64 key, int* wdl, int* dtz) const;
+		/*!
+		 * Stores the WDL value \a wdl and DTZ value \a dtz of the
+		 * position with zobrist key \a key.
+		 *
+		 * \a dtz should be -1 if the DTZ value is unknown.
+		 */
+		void store(quint64 key, int wdl, int dtz = -1);
+		/*! Removes all positions and resets the hit and miss counters. */
+		void clear();
+
+		/*! Returns the number of successful lookups. */
+		quint64 hits() const;
+		/*! Returns the number of failed lookups. */
+		quint64 misses() const;
+
+	private:
+		struct Entry
+		{
+			quint64 key;
+			qint16 wdl;
+			qint16 dtz;
+		};
+
+		int m_size;
+		mutable QMutex m_mutex;
+		mutable quint64 m_hits;
+		mutable quint64 m_misses;
+		QVector<Entry> m_entries;
+};
+
+#endif // TABLEBASECACHE_H
@@ -16,13 +16,34 @@
 */
 
 #include "westernboard.h"
+#include <cstring>
 #include <QStringList>
+#include "bitboard.h"
 #include "westernzobrist.h"
 #include "boardtransition.h"
 
 
 namespace Chess {
 
+// Writes the name of \a square at \a str and returns the end
+static char* writeSquare(char* str, const Square& square)
+{
+	*str++ = 'a' + square.file();
+	int rank = square.rank() + 1;
+	if (rank >= 10)
+		*str++ = '0' + rank / 10;
+	*str++ = '0' + rank % 10;
+	return str;
+}
+
+// Reads a square name of two characters from \a str
+static Square sanSquare(const char* str)
+{
+	if (str[1] < '0' || str[1] > '9')
+		return Square();
+	return Square(str[0] - 'a', str[1] - '1');
+}
+
 WesternBoard::WesternBoard(WesternZobrist* zobrist)
 	: Board(zobrist),
 	  m_arwidth(0),
@@ -30,7 +51,10 @@ WesternBoard::WesternBoard(WesternZobrist* zobrist)
 	  m_enpassantSquare(0),
 	  m_reversibleMoveCount(0),
 	  m_kingCanCapture(true),
-	  m_zobrist(zobrist)
+	  m_hasCustomLegality(false),
+	  m_zobrist(zobrist),
+	  m_legalMovesKey(0),
+	  m_hasLegalMoves(false)
 {
 	setPieceType(Pawn, tr("pawn"), "P");
 	setPieceType(Knight, tr("knight"), "N", KnightMovement);
@@ -55,9 +79,21 @@ bool WesternBoard::kingCanCapture() const
 	return true;
 }
 
+bool WesternBoard::hasCustomLegality() const
+{
+	return false;
+}
+
+bool WesternBoard::useBitboards() const
+{
+	return width() == 8 && height() == 8;
+}
+
 void WesternBoard::vInitialize()
 {
 	m_kingCanCapture = kingCanCapture();
+	m_hasCustomLegality = hasCustomLegality();
+	m_hasLegalMoves = false;
 	m_arwidth = width() + 2;
 
 	m_castlingRights.rookSquare[Side::White][QueenSide] = 0;
@@ -96,6 +132,14 @@ void WesternBoard::vInitialize()
 	m_rookOffsets[3] = m_arwidth;
 }
 
+char* WesternBoard::writePieceSymbol(char* str, int pieceType) const
+{
+	const QString symbol(pieceSymbol(Piece(upperCaseSide(), pieceType)));
+	for (int i = 0; i < symbol.length(); i++)
+		*str++ = symbol.at(i).toLatin1();
+	return str;
+}
+
 int WesternBoard::captureType(const Move& move) const
 {
 	if (pieceAt(move.sourceSquare()).type() == Pawn
@@ -132,13 +176,19 @@ QString WesternBoard::lanMoveString(const Move& move)
 
 QString WesternBoard::sanMoveString(const Move& move)
 {
-	QString str;
+	// The string is built in a fixed buffer to avoid allocating
+	// memory for each part of it
+	char str[32];
+	char* p = str;
 	int source = move.sourceSquare();
 	int target = move.targetSquare();
 	Piece piece = pieceAt(source);
 	Piece capture = pieceAt(target);
 	Square square = chessSquare(source);
 
+	// If the move gives check the legal moves generated for the
+	// mate test are kept, so the game doesn't generate them again
+	// when the move is made
 	char checkOrMate = 0;
 	makeMove(move);
 	if (inCheck(sideToMove()))
@@ -153,10 +203,12 @@ QString WesternBoard::sanMoveString(const Move& move)
 	// drop move
 	if (source == 0 && move.promotion() != Piece::NoPiece)
 	{
-		str = lanMoveString(move);
+		p = writePieceSymbol(p, move.promotion());
+		*p++ = '@';
+		p = writeSquare(p, chessSquare(target));
 		if (checkOrMate != 0)
-			str += checkOrMate;
-		return str;
+			*p++ = checkOrMate;
+		return QString::fromLatin1(str, int(p - str));
 	}
 
 	bool needRank = false;
@@ -175,32 +227,42 @@ QString WesternBoard::sanMoveString(const Move& move)
 		CastlingSide cside = castlingSide(move);
 		if (cside != NoCastlingSide)
 		{
-			if (cside == QueenSide)
-				str = "O-O-O";
-			else
-				str = "O-O";
+			const char* castling = (cside == QueenSide) ? "O-O-O" : "O-O";
+			while (*castling != 0)
+				*p++ = *castling++;
 			if (checkOrMate != 0)
-				str += checkOrMate;
-			return str;
+				*p++ = checkOrMate;
+			return QString::fromLatin1(str, int(p - str));
 		}
 		else
-			str += pieceSymbol(piece).toUpper();
+			p = writePieceSymbol(p, piece.type());
 	}
 	else	// not king or pawn
 	{
-		str += pieceSymbol(piece).toUpper();
+		p = writePieceSymbol(p, piece.type());
+
+		// Use the legal moves of the position if they're known
+		// already. Otherwise only the moves of the same piece type
+		// are generated, and the rare candidates with the same
+		// target square are tested for legality.
 		QVarLengthArray<Move> moves;
-		generateMoves(moves, piece.type());
+		bool movesAreLegal = (m_hasLegalMoves
+				      && m_legalMovesKey == key());
+		if (movesAreLegal)
+			moves = m_legalMoves;
+		else
+			generateMoves(moves, piece.type());
 
 		for (int i = 0; i < moves.size(); i++)
 		{
 			const Move& move2 = moves[i];
 			if (move2.sourceSquare() == 0
 			||  move2.sourceSquare() == source
-			||  move2.targetSquare() != target)
+			||  move2.targetSquare() != target
+			||  pieceAt(move2.sourceSquare()).type() != piece.type())
 				continue;
 
-			if (!vIsLegalMove(move2))
+			if (!movesAreLegal && !vIsLegalMove(move2))
 				continue;
 
 			Square square2(chessSquare(move2.sourceSquare()));
@@ -211,22 +273,25 @@ QString WesternBoard::sanMoveString(const Move& move)
 		}
 	}
 	if (needFile)
-		str += 'a' + square.file();
+		*p++ = 'a' + square.file();
 	if (needRank)
-		str += '1' + square.rank();
+		*p++ = '1' + square.rank();
 
 	if (capture.isValid())
-		str += 'x';
+		*p++ = 'x';
 
-	str += squareString(target);
+	p = writeSquare(p, chessSquare(target));
 
 	if (move.promotion() != Piece::NoPiece)
-		str += "=" + pieceSymbol(move.promotion()).toUpper();
+	{
+		*p++ = '=';
+		p = writePieceSymbol(p, move.promotion());
+	}
 
 	if (checkOrMate != 0)
-		str += checkOrMate;
+		*p++ = checkOrMate;
 
-	return str;
+	return QString::fromLatin1(str, int(p - str));
 }
 
 Move WesternBoard::moveFromLanString(const QString& str)
@@ -255,29 +320,36 @@ Move WesternBoard::moveFromLanString(const QString& str)
 
 Move WesternBoard::moveFromSanString(const QString& str)
 {
-	if (str.length() < 2)
+	// The string is parsed from a fixed buffer. Strings that don't
+	// fit in it are too long to be SAN moves anyway.
+	char mstr[16];
+	int len = str.length();
+	if (len < 2 || len >= int(sizeof(mstr)))
 		return Move();
+	for (int i = 0; i < len; i++)
+		mstr[i] = str.at(i).toLatin1();
 
-	QString mstr = str;
 	Side side = sideToMove();
 
 	// Ignore check/mate/strong move/blunder notation
-	while (mstr.endsWith('+') || mstr.endsWith('#')
-	||     mstr.endsWith('!') || mstr.endsWith('?'))
+	while (len > 0
+	&&     (mstr[len - 1] == '+' || mstr[len - 1] == '#'
+	||      mstr[len - 1] == '!' || mstr[len - 1] == '?'))
 	{
-		mstr.chop(1);
+		len--;
 	}
+	mstr[len] = 0;
 
-	if (mstr.length() < 2)
+	if (len < 2)
 		return Move();
 
 	// Castling
-	if (mstr.startsWith("O-O"))
+	if (qstrncmp(mstr, "O-O", 3) == 0)
 	{
 		CastlingSide cside;
-		if (mstr == "O-O")
+		if (qstrcmp(mstr, "O-O") == 0)
 			cside = KingSide;
-		else if (mstr == "O-O-O")
+		else if (qstrcmp(mstr, "O-O-O") == 0)
 			cside = QueenSide;
 		else
 			return Move();
@@ -294,34 +366,32 @@ Move WesternBoard::moveFromSanString(const QString& str)
 
 	Square sourceSq;
 	Square targetSq;
-	QString::const_iterator it = mstr.begin();
+	const char* it = mstr;
+	const char* end = mstr + len;
 
-	// A SAN move can't start with the capture mark, and
-	// a pawn move must not specify the piece type
-	if (*it == 'x' || pieceFromSymbol(*it) == Pawn)
+	// A SAN move can't start with the capture mark
+	if (*it == 'x')
 		return Move();
 
 	// Piece type
-	Piece piece = pieceFromSymbol(*it);
-	if (piece.side() != Side::White)
-		piece = Piece::NoPiece;
-	else
-		piece.setSide(side);
-	if (piece.isEmpty())
+	Piece piece;
+	int pieceType = pieceTypeFromSymbol(*it);
+	if (pieceType == Piece::NoPiece)
 	{
 		piece = Piece(side, Pawn);
-		targetSq = chessSquare(mstr.mid(0, 2));
+		targetSq = sanSquare(it);
 		if (isValidSquare(targetSq))
 			it += 2;
 	}
 	else
 	{
+		piece = Piece(side, pieceType);
 		++it;
 
 		// Drop moves
 		if (*it == '@')
 		{
-			targetSq = chessSquare(mstr.right(2));
+			targetSq = sanSquare(end - 2);
 			if (!isValidSquare(targetSq))
 				return Move();
 
@@ -337,21 +407,21 @@ Move WesternBoard::moveFromSanString(const QString& str)
 	if (!isValidSquare(targetSq))
 	{
 		// Source square's file
-		sourceSq.setFile(it->toLatin1() - 'a');
+		sourceSq.setFile(*it - 'a');
 		if (sourceSq.file() < 0 || sourceSq.file() >= width())
 			sourceSq.setFile(-1);
-		else if (++it == mstr.end())
+		else if (++it == end)
 			return Move();
 
 		// Source square's rank
-		if (it->isDigit())
+		if (*it >= '0' && *it <= '9')
 		{
-			sourceSq.setRank(it->toLatin1() - '1');
+			sourceSq.setRank(*it - '1');
 			if (sourceSq.rank() < 0 || sourceSq.rank() >= height())
 				return Move();
 			++it;
 		}
-		if (it == mstr.end())
+		if (it == end)
 		{
 			// What we thought was the source square, was
 			// actually the target square.
@@ -367,7 +437,7 @@ Move WesternBoard::moveFromSanString(const QString& str)
 		// Capture
 		else if (*it == 'x')
 		{
-			if(++it == mstr.end())
+			if(++it == end)
 				return Move();
 			stringIsCapture = true;
 		}
@@ -375,9 +445,9 @@ Move WesternBoard::moveFromSanString(const QString& str)
 		// Target square
 		if (!isValidSquare(targetSq))
 		{
-			if (it + 1 == mstr.end())
+			if (it + 1 == end)
 				return Move();
-			targetSq = chessSquare(mstr.mid(it - mstr.begin(), 2));
+			targetSq = sanSquare(it);
 			it += 2;
 		}
 	}
@@ -396,12 +466,15 @@ Move WesternBoard::moveFromSanString(const QString& str)
 
 	// Promotion
 	int promotion = Piece::NoPiece;
-	if (it != mstr.end())
+	if (it != end)
 	{
-		if ((*it == '=' || *it == '(') && ++it == mstr.end())
+		if ((*it == '=' || *it == '(') && ++it == end)
 			return Move();
 
-		promotion = pieceFromSymbol(*it).type();
+		char symbol = *it;
+		if (symbol >= 'a' && symbol <= 'z')
+			symbol -= 'a' - 'A';
+		promotion = pieceTypeFromSymbol(symbol);
 		if (promotion == Piece::NoPiece)
 			return Move();
 	}
@@ -897,6 +970,9 @@ void WesternBoard::generateMovesForPiece(QVarLengthArray<Move>& moves,
 		return;
 	}
 
+	if (hasBitboards())
+		return generateBitboardMoves(moves, pieceType, square);
+
 	if (pieceHasMovement(pieceType, KnightMovement))
 		generateHoppingMoves(square, m_knightOffsets, moves);
 	if (pieceHasMovement(pieceType, BishopMovement))
@@ -905,11 +981,84 @@ void WesternBoard::generateMovesForPiece(QVarLengthArray<Move>& moves,
 		generateSlidingMoves(square, m_rookOffsets, moves);
 }
 
+void WesternBoard::generateBitboardMoves(QVarLengthArray<Move>& moves,
+					 int pieceType,
+					 int square) const
+{
+	int index = bitIndex(square);
+	quint64 occupied = sideBitboard(Side::White) | sideBitboard(Side::Black);
+	quint64 targets = 0;
+
+	if (pieceHasMovement(pieceType, KnightMovement))
+		targets |= Bitboard::knightAttacks(index);
+	if (pieceHasMovement(pieceType, BishopMovement))
+		targets |= Bitboard::bishopAttacks(index, occupied);
+	if (pieceHasMovement(pieceType, RookMovement))
+		targets |= Bitboard::rookAttacks(index, occupied);
+
+	targets &= ~sideBitboard(sideToMove());
+	while (targets != 0)
+		moves.append(Move(square, bitSquare(Bitboard::popLsb(targets))));
+}
+
+quint64 WesternBoard::attackedSquares(Side side) const
+{
+	quint64 occupied = sideBitboard(Side::White) | sideBitboard(Side::Black);
+	quint64 attacks = 0;
+	quint64 pieces;
+
+	pieces = pieceBitboard(Piece(side, Pawn));
+	while (pieces != 0)
+		attacks |= Bitboard::pawnAttacks(side, Bitboard::popLsb(pieces));
+	pieces = movementBitboard(side, KnightMovement);
+	while (pieces != 0)
+		attacks |= Bitboard::knightAttacks(Bitboard::popLsb(pieces));
+	pieces = movementBitboard(side, BishopMovement);
+	while (pieces != 0)
+		attacks |= Bitboard::bishopAttacks(Bitboard::popLsb(pieces), occupied);
+	pieces = movementBitboard(side, RookMovement);
+	while (pieces != 0)
+		attacks |= Bitboard::rookAttacks(Bitboard::popLsb(pieces), occupied);
+	if (m_kingCanCapture)
+	{
+		pieces = pieceBitboard(Piece(side, King));
+		while (pieces != 0)
+			attacks |= Bitboard::kingAttacks(Bitboard::popLsb(pieces));
+	}
+
+	return attacks;
+}
+
+bool WesternBoard::bitboardInCheck(Side side, int square) const
+{
+	Side opSide = side.opposite();
+	int index = bitIndex(square);
+	Q_ASSERT(index >= 0);
+
+	if (Bitboard::pawnAttacks(side, index) & pieceBitboard(Piece(opSide, Pawn)))
+		return true;
+	if (Bitboard::knightAttacks(index) & movementBitboard(opSide, KnightMovement))
+		return true;
+	if (m_kingCanCapture
+	&&  (Bitboard::kingAttacks(index) & pieceBitboard(Piece(opSide, King))))
+		return true;
+
+	quint64 occupied = sideBitboard(Side::White) | sideBitboard(Side::Black);
+	if (Bitboard::bishopAttacks(index, occupied) & movementBitboard(opSide, BishopMovement))
+		return true;
+	if (Bitboard::rookAttacks(index, occupied) & movementBitboard(opSide, RookMovement))
+		return true;
+
+	return false;
+}
+
 bool WesternBoard::inCheck(Side side, int square) const
 {
 	Side opSide = side.opposite();
 	if (square == 0)
 		square = m_kingSquare[side];
+	if (hasBitboards())
+		return bitboardInCheck(side, square);
 	
 	// Pawn attacks
 	int step = (side == Side::White) ? -m_arwidth : m_arwidth;
@@ -1011,9 +1160,13 @@ bool WesternBoard::isLegalPosition()
 			}
 		}
 		
+		quint64 attacked = 0;
+		if (hasBitboards())
+			attacked = attackedSquares(sideToMove());
 		for (int i = source; i != target; i += offset)
 		{
-			if (inCheck(side, i))
+			if (hasBitboards() ? (attacked >> bitIndex(i)) & 1
+					   : inCheck(side, i))
 				return false;
 		}
 	}
@@ -1033,6 +1186,198 @@ bool WesternBoard::vIsLegalMove(const Move& move)
 	return Board::vIsLegalMove(move);
 }
 
+int WesternBoard::kingRayCheckers(const QVarLengthArray<int>& offsets,
+				  unsigned movement,
+				  int pinId,
+				  QVarLengthArray<quint8>& checkMask,
+				  QVarLengthArray<quint8>& pinMask) const
+{
+	Side side = sideToMove();
+	Side opSide = side.opposite();
+	int kingSq = m_kingSquare[side];
+	int checkers = 0;
+
+	for (int i = 0; i < offsets.size(); i++, pinId++)
+	{
+		int offset = offsets[i];
+		int square = kingSq + offset;
+		Piece piece;
+
+		while ((piece = pieceAt(square)).isEmpty())
+			square += offset;
+		if (piece.side() == opSide)
+		{
+			if (!pieceHasMovement(piece.type(), movement))
+				continue;
+
+			// The check can be stopped by capturing the
+			// checking piece or by blocking its ray
+			for (int j = kingSq + offset; j != square + offset; j += offset)
+				checkMask[j] = 1;
+			checkers++;
+			continue;
+		}
+		if (piece.side() != side)
+			continue;
+
+		// The king's own piece is pinned if the next piece on
+		// the ray is an opposing slider. It can move only on the
+		// ray between the king and the pinning piece.
+		do
+			square += offset;
+		while ((piece = pieceAt(square)).isEmpty());
+
+		if (piece.side() == opSide
+		&&  pieceHasMovement(piece.type(), movement))
+		{
+			for (int j = kingSq + offset; j != square + offset; j += offset)
+				pinMask[j] = pinId;
+		}
+	}
+
+	return checkers;
+}
+
+int WesternBoard::checkAndPinMasks(QVarLengthArray<quint8>& checkMask,
+				   QVarLengthArray<quint8>& pinMask) const
+{
+	Side side = sideToMove();
+	Side opSide = side.opposite();
+	int kingSq = m_kingSquare[side];
+	int checkers = 0;
+
+	checkMask.resize(arraySize());
+	pinMask.resize(arraySize());
+	memset(checkMask.data(), 0, checkMask.size());
+	memset(pinMask.data(), 0, pinMask.size());
+
+	// Pawn checks
+	int step = (side == Side::White) ? -m_arwidth : m_arwidth;
+	for (int i = -1; i <= 1; i += 2)
+	{
+		int square = kingSq + step + i;
+		if (pieceAt(square) == Piece(opSide, Pawn))
+		{
+			checkMask[square] = 1;
+			checkers++;
+		}
+	}
+
+	// Knight, archbishop, chancellor checks
+	for (int i = 0; i < m_knightOffsets.size(); i++)
+	{
+		int square = kingSq + m_knightOffsets[i];
+		Piece piece(pieceAt(square));
+		if (piece.side() == opSide
+		&&  pieceHasMovement(piece.type(), KnightMovement))
+		{
+			checkMask[square] = 1;
+			checkers++;
+		}
+	}
+
+	// Sliding checks and pins, with a different pin id for each ray
+	checkers += kingRayCheckers(m_bishopOffsets, BishopMovement, 1,
+				    checkMask, pinMask);
+	checkers += kingRayCheckers(m_rookOffsets, RookMovement,
+				    m_bishopOffsets.size() + 1,
+				    checkMask, pinMask);
+
+	return checkers;
+}
+
+void WesternBoard::generateLegalMoves(QVarLengthArray<Move>& moves)
+{
+	// The moves of the last generated position are kept. The
+	// position after a checking move is generated for the mate test
+	// of its SAN string and again for the game result.
+	if (m_hasLegalMoves && m_legalMovesKey == key())
+	{
+		moves = m_legalMoves;
+		return;
+	}
+	generateLegalMovesForPosition(moves);
+
+	m_legalMoves = moves;
+	m_legalMovesKey = key();
+	m_hasLegalMoves = true;
+}
+
+void WesternBoard::generateLegalMovesForPosition(QVarLengthArray<Move>& moves)
+{
+	if (m_hasCustomLegality)
+	{
+		Board::generateLegalMoves(moves);
+		return;
+	}
+
+	Side side = sideToMove();
+	int kingSq = m_kingSquare[side];
+	QVarLengthArray<quint8> checkMask;
+	QVarLengthArray<quint8> pinMask;
+	int checkers = checkAndPinMasks(checkMask, pinMask);
+
+	generateMoves(moves);
+
+	// Find the king moves to attacked squares with the king lifted
+	// off the board, so that it doesn't shield the squares behind
+	// it from sliding attacks. Castling moves are tested later.
+	setSquare(kingSq, Piece::NoPiece);
+	quint64 attacked = 0;
+	if (hasBitboards())
+		attacked = attackedSquares(side.opposite());
+	for (int i = 0; i < moves.size(); i++)
+	{
+		const Move& move = moves[i];
+		if (move.sourceSquare() != kingSq
+		||  castlingSide(move) != NoCastlingSide)
+			continue;
+
+		int target = move.targetSquare();
+		if (hasBitboards() ? (attacked >> bitIndex(target)) & 1
+				   : inCheck(side, target))
+			moves[i] = Move();
+	}
+	setSquare(kingSq, Piece(side, King));
+
+	int count = 0;
+	for (int i = 0; i < moves.size(); i++)
+	{
+		const Move move(moves[i]);
+		if (move.isNull())
+			continue;
+
+		int source = move.sourceSquare();
+		int target = move.targetSquare();
+		bool isLegal;
+
+		if (source == kingSq)
+		{
+			isLegal = castlingSide(move) == NoCastlingSide
+				  || vIsLegalMove(move);
+		}
+		else if (source == 0)
+			isLegal = checkers == 0 || (checkers == 1 && checkMask[target]);
+		else if (target == m_enpassantSquare
+		     &&  pieceAt(source).type() == Pawn)
+		{
+			// An en-passant capture removes two pieces from
+			// the king's rank, so it's tested by making it
+			isLegal = vIsLegalMove(move);
+		}
+		else
+		{
+			isLegal = checkers < 2
+				  && (checkers == 0 || checkMask[target])
+				  && (pinMask[source] == 0 || pinMask[target] == pinMask[source]);
+		}
+
+		if (isLegal)
+			moves[count++] = move;
+	}
+	moves.resize(count);
+}
+
 void WesternBoard::addPromotions(int sourceSquare,
 				 int targetSquare,
 				 QVarLengthArray<Move>& moves) const
@@ -1203,16 +1548,12 @@ Result WesternBoard::result()
 
 	// Insufficient mating material
 	int material[2] = { 0, 0 };
-	for (int i = 0; i < arraySize(); i++)
+	for (int i = Side::White; i <= Side::Black; i++)
 	{
-		const Piece& piece = pieceAt(i);
-		if (!piece.isValid())
-			continue;
-
-		if (piece.type() == Knight || piece.type() == Bishop)
-			material[piece.side()] += 1;
-		else
-			material[piece.side()] += 2;
+		Side side = Side::Type(i);
+		material[side] = 2 * pieceCount(side)
+			       - pieceCount(side, Knight)
+			       - pieceCount(side, Bishop);
 	}
 	if (material[Side::White] <= 3 && material[Side::Black] <= 3)
 	{
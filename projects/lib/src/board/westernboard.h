@@ -58,9 +58,7 @@ class LIB_EXPORT WesternBoard : public Board
 		virtual int width() const;
 		virtual int height() const;
 		virtual Result result();
-
-		/*! Returns the number of consecutive reversible moves made. */
-		int reversibleMoveCount() const;
+		virtual int reversibleMoveCount() const;
 
 	protected:
 		/*! The king's castling side. */
@@ -84,6 +82,16 @@ class LIB_EXPORT WesternBoard : public Board
 		 * \sa AtomicBoard
 		 */
 		virtual bool kingCanCapture() const;
+		/*!
+		 * Returns true if the variant has move legality rules other
+		 * than not leaving the king in check.
+		 *
+		 * Legal moves are then found by making each pseudo-legal
+		 * move and testing the position with vIsLegalMove() instead
+		 * of using check and pin detection. The default value is
+		 * false.
+		 */
+		virtual bool hasCustomLegality() const;
 		/*!
 		 * Adds pawn promotions to a move list.
 		 *
@@ -123,6 +131,7 @@ class LIB_EXPORT WesternBoard : public Board
 
 		// Inherited from Board
 		virtual void vInitialize();
+		virtual bool useBitboards() const;
 		virtual QString vFenString(FenNotation notation) const;
 		virtual bool vSetFenString(const QStringList& fen);
 		virtual QString lanMoveString(const Move& move);
@@ -136,6 +145,7 @@ class LIB_EXPORT WesternBoard : public Board
 						   int pieceType,
 						   int square) const;
 		virtual bool vIsLegalMove(const Move& move);
+		virtual void generateLegalMoves(QVarLengthArray<Move>& moves);
 		virtual bool isLegalPosition();
 		virtual int captureType(const Move& move) const;
 
@@ -157,10 +167,24 @@ class LIB_EXPORT WesternBoard : public Board
 			int reversibleMoveCount;
 		};
 
+		int kingRayCheckers(const QVarLengthArray<int>& offsets,
+				    unsigned movement,
+				    int pinId,
+				    QVarLengthArray<quint8>& checkMask,
+				    QVarLengthArray<quint8>& pinMask) const;
+		int checkAndPinMasks(QVarLengthArray<quint8>& checkMask,
+				     QVarLengthArray<quint8>& pinMask) const;
+		quint64 attackedSquares(Side side) const;
+		void generateLegalMovesForPosition(QVarLengthArray<Move>& moves);
+		bool bitboardInCheck(Side side, int square) const;
+		void generateBitboardMoves(QVarLengthArray<Move>& moves,
+					   int pieceType,
+					   int square) const;
 		void generateCastlingMoves(QVarLengthArray<Move>& moves) const;
 		void generatePawnMoves(int sourceSquare,
 				       QVarLengthArray<Move>& moves) const;
 
+		char* writePieceSymbol(char* str, int pieceType) const;
 		bool canCastle(CastlingSide castlingSide) const;
 		QString castlingRightsString(FenNotation notation) const;
 		bool parseCastlingRights(QChar c);
@@ -176,10 +200,14 @@ class LIB_EXPORT WesternBoard : public Board
 		int m_enpassantSquare;
 		int m_reversibleMoveCount;
 		bool m_kingCanCapture;
+		bool m_hasCustomLegality;
 		QVector<MoveData> m_history;
 		CastlingRights m_castlingRights;
 		int m_castleTarget[2][2];
 		const WesternZobrist* m_zobrist;
+		QVarLengthArray<Move> m_legalMoves;
+		quint64 m_legalMovesKey;
+		bool m_hasLegalMoves;
 
 		QVarLengthArray<int> m_knightOffsets;
 		QVarLengthArray<int> m_bishopOffsets;
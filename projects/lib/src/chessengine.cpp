@@ -18,26 +18,25 @@
 #include "chessengine.h"
 #include <QIODevice>
 #include <QTimer>
-#include <QStringRef>
 #include <QtAlgorithms>
 #include "engineoption.h"
 
 
 int ChessEngine::s_count = 0;
 
-QStringRef ChessEngine::nextToken(const QStringRef& previous, bool untilEnd)
+EngineToken ChessEngine::nextToken(const EngineToken& previous, bool untilEnd)
 {
-	const QString* str = previous.string();
-	if (str == 0)
-		return QStringRef();
+	const char* line = previous.line();
+	if (line == 0)
+		return EngineToken();
 
 	int i;
 	int start = -1;
-	int firstPos = previous.position() + previous.size();
+	int size = previous.lineSize();
 
-	for (i = firstPos; i < str->size(); i++)
+	for (i = previous.position() + previous.size(); i < size; i++)
 	{
-		if (str->at(i).isSpace())
+		if (EngineToken::isSpace(line[i]))
 		{
 			if (start == -1)
 				continue;
@@ -48,8 +47,8 @@ QStringRef ChessEngine::nextToken(const QStringRef& previous, bool untilEnd)
 			start = i;
 			if (untilEnd)
 			{
-				int end = str->size();
-				while (str->at(--end).isSpace())
+				int end = size;
+				while (EngineToken::isSpace(line[--end]))
 					;
 				i = end + 1;
 				break;
@@ -58,13 +57,13 @@ QStringRef ChessEngine::nextToken(const QStringRef& previous, bool untilEnd)
 	}
 
 	if (start == -1)
-		return QStringRef();
-	return QStringRef(str, start, i - start);
+		return EngineToken();
+	return EngineToken(line, size, start, i - start);
 }
 
-QStringRef ChessEngine::firstToken(const QString& str, bool untilEnd)
+EngineToken ChessEngine::firstToken(const char* line, int size, bool untilEnd)
 {
-	return nextToken(QStringRef(&str, 0, 0), untilEnd);
+	return nextToken(EngineToken(line, size, 0, 0), untilEnd);
 }
 
 
@@ -74,6 +73,8 @@ ChessEngine::ChessEngine(QObject* parent)
 	  m_pingState(NotStarted),
 	  m_pinging(false),
 	  m_whiteEvalPov(false),
+	  m_fenAfterIrreversible(false),
+	  m_infoInterval(0),
 	  m_pingTimer(new QTimer(this)),
 	  m_quitTimer(new QTimer(this)),
 	  m_idleTimer(new QTimer(this)),
@@ -109,6 +110,7 @@ void ChessEngine::setDevice(QIODevice* device)
 
 	m_ioDevice = device;
 	m_ioDevice->setParent(this);
+	m_readBuffer.clear();
 
 	connect(m_ioDevice, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
 	connect(m_ioDevice, SIGNAL(readChannelFinished()), this, SLOT(onCrashed()));
@@ -130,6 +132,8 @@ void ChessEngine::applyConfiguration(const EngineConfiguration& configuration)
 	m_configurationString = m_configurationString.trimmed();
 
 	m_whiteEvalPov = configuration.whiteEvalPov();
+	m_fenAfterIrreversible = configuration.fenAfterIrreversible();
+	m_infoInterval = configuration.infoInterval();
 	m_restartMode = configuration.restartMode();
 	setClaimsValidated(configuration.areClaimsValidated());
 
@@ -254,6 +258,16 @@ bool ChessEngine::whiteEvalPov() const
 	return m_whiteEvalPov;
 }
 
+bool ChessEngine::fenAfterIrreversible() const
+{
+	return m_fenAfterIrreversible;
+}
+
+int ChessEngine::infoInterval() const
+{
+	return m_infoInterval;
+}
+
 void ChessEngine::endGame(const Chess::Result& result)
 {
 	ChessPlayer::endGame(result);
@@ -387,31 +401,46 @@ void ChessEngine::write(const QString& data, WriteMode mode)
 	}
 
 	Q_ASSERT(m_ioDevice->isWritable());
-	emit debugMessage(QString(">%1(%2): %3")
-			  .arg(name())
-			  .arg(m_id)
-			  .arg(data));
+	if (receivers(SIGNAL(debugMessage(QString))) > 0)
+		emit debugMessage(QString(">%1(%2): %3")
+				  .arg(name())
+				  .arg(m_id)
+				  .arg(data));
 
 	m_ioDevice->write(data.toLatin1() + "\n");
 }
 
 void ChessEngine::onReadyRead()
 {
-	while (m_ioDevice->isReadable() && m_ioDevice->canReadLine())
+	if (!m_ioDevice->isReadable())
+		return;
+
+	// Debug messages are only formatted if someone is listening
+	const bool debug = receivers(SIGNAL(debugMessage(QString))) > 0;
+
+	// Split the output into lines directly in the byte buffer. An
+	// incomplete last line is kept until the rest of it arrives.
+	m_readBuffer += m_ioDevice->readAll();
+	int start = 0;
+	int end;
+	while (m_ioDevice->isReadable()
+	&&     (end = m_readBuffer.indexOf('\n', start)) != -1)
 	{
-		QString line = QString(m_ioDevice->readLine());
-		if (line.endsWith('\n'))
-			line.chop(1);
-		if (line.endsWith('\r'))
-			line.chop(1);
-		if (line.isEmpty())
+		const char* data = m_readBuffer.constData() + start;
+		int size = end - start;
+		start = end + 1;
+
+		if (size > 0 && data[size - 1] == '\r')
+			size--;
+		if (size == 0)
 			continue;
 
-		emit debugMessage(QString("<%1(%2): %3")
-				  .arg(name())
-				  .arg(m_id)
-				  .arg(line));
-		parseLine(line);
+		if (debug)
+			emit debugMessage(QString("<%1(%2): %3")
+					  .arg(name())
+					  .arg(m_id)
+					  .arg(QString::fromUtf8(data, size)));
+		parseLine(data, size);
 
 		if (m_idleTimer->isActive())
 		{
@@ -421,6 +450,7 @@ void ChessEngine::onReadyRead()
 				m_idleTimer->stop();
 		}
 	}
+	m_readBuffer.remove(0, start);
 }
 
 void ChessEngine::flushWriteBuffer()
@@ -20,8 +20,10 @@
 
 #include "chessplayer.h"
 #include <QVariant>
+#include <QByteArray>
 #include <QStringList>
 #include "engineconfiguration.h"
+#include "enginetoken.h"
 
 class QIODevice;
 class EngineOption;
@@ -124,32 +126,33 @@ class LIB_EXPORT ChessEngine : public ChessPlayer
 
 	protected:
 		/*!
-		 * Reads the first whitespace-delimited token from a string
-		 * and returns a QStringRef reference to the token.
+		 * Reads the first whitespace-delimited token from \a line,
+		 * which is \a size bytes long.
 		 *
-		 * If \a readToEnd is true, the whole string is read, except
+		 * If \a readToEnd is true, the whole line is read, except
 		 * for leading and trailing whitespace. Otherwise only one
 		 * word is read.
 		 *
-		 * If \a str doesn't contain any words, a null QStringRef
+		 * If \a line doesn't contain any words, a null EngineToken
 		 * object is returned.
 		 */
-		static QStringRef firstToken(const QString& str,
-					     bool readToEnd = false);
+		static EngineToken firstToken(const char* line,
+					      int size,
+					      bool readToEnd = false);
 		/*!
 		 * Reads the first whitespace-delimited token after the
 		 * token referenced by \a previous.
 		 *
 		 * If \a readToEnd is true, everything from the first word
-		 * after \a previous to the end of the string is read,
+		 * after \a previous to the end of the line is read,
 		 * except for leading and trailing whitespace. Otherwise
 		 * only one word is read.
 		 *
 		 * If \a previous is null or it's not followed by any words,
-		 * a null QStringRef object is returned.
+		 * a null EngineToken object is returned.
 		 */
-		static QStringRef nextToken(const QStringRef& previous,
-					    bool readToEnd = false);
+		static EngineToken nextToken(const EngineToken& previous,
+					     bool readToEnd = false);
 
 		// Inherited from ChessPlayer
 		virtual void startGame() = 0;
@@ -160,8 +163,13 @@ class LIB_EXPORT ChessEngine : public ChessPlayer
 		 */
 		virtual void startProtocol() = 0;
 
-		/*! Parses a line of input from the engine. */
-		virtual void parseLine(const QString& line) = 0;
+		/*!
+		 * Parses a line of input from the engine.
+		 *
+		 * \a line is \a size bytes of raw output without the
+		 * line terminator. It is only valid during the call.
+		 */
+		virtual void parseLine(const char* line, int size) = 0;
 
 		/*!
 		 * Sends a ping command to the engine.
@@ -206,6 +214,16 @@ class LIB_EXPORT ChessEngine : public ChessPlayer
 
 		/*! Are evaluation scores from white's point of view? */
 		bool whiteEvalPov() const;
+		/*!
+		 * Is the position sent as a FEN string after
+		 * irreversible moves?
+		 */
+		bool fenAfterIrreversible() const;
+		/*!
+		 * Returns the minimum interval between evaluation updates,
+		 * or 0 if every update is parsed.
+		 */
+		int infoInterval() const;
 
 	protected slots:
 		// Inherited from ChessPlayer
@@ -246,10 +264,13 @@ class LIB_EXPORT ChessEngine : public ChessPlayer
 		State m_pingState;
 		bool m_pinging;
 		bool m_whiteEvalPov;
+		bool m_fenAfterIrreversible;
+		int m_infoInterval;
 		QTimer* m_pingTimer;
 		QTimer* m_quitTimer;
 		QTimer* m_idleTimer;
 		QIODevice *m_ioDevice;
+		QByteArray m_readBuffer;
 		QStringList m_writeBuffer;
 		QStringList m_variants;
 		QList<EngineOption*> m_options;
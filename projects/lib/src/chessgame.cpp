@@ -18,7 +18,6 @@
 #include "chessgame.h"
 #include <QThread>
 #include <QTimer>
-#include <QtCore/qmath.h>
 #include "board/board.h"
 #include "chessplayer.h"
 #include "openingbook.h"
@@ -183,165 +182,42 @@ void ChessGame::kill()
 	stop();
 }
 
-static QString evalString(ChessGame *game, const MoveEvaluation& eval)
+static PgnGame::MoveAnnotation moveAnnotation(ChessGame* game,
+					      const MoveEvaluation& eval)
 {
-	if (eval.isBookEval())
-		return "book";
-	if (eval.isEmpty())
-		return QString();
-
-	QString str;
-#if 1
-	// score
-	// str += " ev=";
-	QString sScore;
-	if (eval.depth() > 0)
-	{
-		int score = eval.score();
-		int absScore = qAbs(score);
-
-		// Detect mate-in-n scores
-		if (absScore > 9900
-		&&  (absScore = 1000 - (absScore % 1000)) < 100)
-		{
-			if (score < 0)
-				sScore = "-";
-			sScore += "M" + QString::number(absScore);
-		}
-		else
-			sScore = QString::number(double(score) / 100.0, 'f', 2);
-
-		// str += sScore + ",";
-	} else {
-		sScore = "0.00";
-		// str += sScore + ",";
-	}
-
-	str += "d=";
-	if (eval.depth() > 0) {
-		str += QString::number(eval.depth());
-	} else {
-		str += "1";
-	}
-
-	// ponder move 'pd' algebraic move
-	QString sanPv = game->board()->sanStringForPv(eval.pv(), Chess::Board::StandardAlgebraic);
-	QStringList sanList = sanPv.split(' ');
-	if (sanList.length() > 1) {
-		str+= ", pd=" + sanList[1];
-	}
-
-	// move time 'mt' "hh:mm:ss"
-	int t = eval.time(); // milliseconds
-	str += ", mt=";
-	if (t == 0)
-		str += "00:00:00";
-	else {
-		int total = qFloor(t / 1000.);
-		int hours = qFloor(total / 3600.) % 24; // should be ok, right?
-		int minutes = (total / 60) % 60;
-		int seconds = total % 60;
-		str +=	QString::number(hours).rightJustified(2, '0') + ":" +
-				QString::number(minutes).rightJustified(2, '0') + ":" +
-				QString::number(seconds).rightJustified(2, '0');
-	}
+	PgnGame::MoveAnnotation annotation;
+	annotation.isValid = true;
+	annotation.depth = eval.depth();
+	annotation.score = eval.score();
+	annotation.time = eval.time();
+	annotation.nps = eval.nps();
+	annotation.tbHits = eval.tbHits();
+	annotation.nodeCount = eval.nodeCount();
 
-	// time left 'tl' "hh:mm:ss"
-	ChessPlayer *player = game->player(game->board()->sideToMove());
+	ChessPlayer* player = game->player(game->board()->sideToMove());
 	Q_ASSERT(player != 0);
+	annotation.timeLeft = player->timeControl()->timeLeft();
 
-	int tl = player->timeControl()->timeLeft(); // milliseconds
-	str += ", tl=";
-	if (tl == 0)
-		str += "00:00:00";
-	else {
-		int total = qFloor(tl / 1000.);
-		int hours = qFloor(total / 3600.) % 24; // should be ok, right?
-		int minutes = (total / 60) % 60;
-		int seconds = total % 60;
-		str +=	QString::number(hours).rightJustified(2, '0') + ":" +
-				QString::number(minutes).rightJustified(2, '0') + ":" +
-				QString::number(seconds).rightJustified(2, '0');
-	}
-
-	// speed 's' "%d kN/s"
-	int nps = eval.nps();
-	str += ", s=" + QString::number(qFloor(nps / 1000)) + " kN/s";
-
-	// nodes 'n' "%d"
-	str += ", n=" + QString::number(eval.nodeCount());
+	annotation.pv = game->board()->pvStrings(eval.pv(),
+		Chess::Board::StandardAlgebraic).join(" ").toUtf8();
 
-	// pv 'pv' algebraic string
-	str += ", pv=" + game->board()->sanStringForPv(eval.pv(), Chess::Board::StandardAlgebraic);
+	Chess::WesternBoard* wboard = dynamic_cast<Chess::WesternBoard*>(game->board());
+	if (wboard)
+		annotation.reversibleMoveCount = wboard->reversibleMoveCount();
 
-	// tbhits 'tb'
-	str += ", tb=" + QString::number(eval.tbHits());
-
-	// 50-move clock 'R50'
-	Chess::WesternBoard *wboard = dynamic_cast<Chess::WesternBoard *>(game->board());
-	if (wboard) {
-		str += ", R50=" + QString::number(qFloor(((100 - wboard->reversibleMoveCount()) / 2.) + 0.5));
-	}
-
-	// eval from white's perspective 'wv'
-	Chess::Side side = game->board()->sideToMove();
-	str += ", wv=";
-	if (side == Chess::Side::Black && sScore != "0.00") {
-		if (sScore[0] == '-')
-			str += sScore.right(sScore.length() - 1);
-		else
-			str += "-" + sScore;
-	} else {
-		str += sScore;
-	}
-
-	str += ",";
-#else
-	if (eval.depth() > 0)
-	{
-		int score = eval.score();
-		int absScore = qAbs(score);
-		if (score > 0)
-			str += "+";
-
-		// Detect mate-in-n scores
-		if (absScore > 9900
-		&&  (absScore = 1000 - (absScore % 1000)) < 100)
-		{
-			if (score < 0)
-				str += "-";
-			str += "M" + QString::number(absScore);
-		}
-		else
-			str += QString::number(double(score) / 100.0, 'f', 2);
-
-		str += "/" + QString::number(eval.depth()) + " ";
-	}
-
-	int t = eval.time();
-	if (t == 0)
-		return str + "0s";
-
-	int precision = 0;
-	if (t < 100)
-		precision = 3;
-	else if (t < 1000)
-		precision = 2;
-	else if (t < 10000)
-		precision = 1;
-	str += QString::number(double(t / 1000.0), 'f', precision) + 's';
-#endif
-
-	return str;
+	return annotation;
 }
 
-void ChessGame::addPgnMove(const Chess::Move& move, const QString& comment)
+void ChessGame::addPgnMove(const Chess::Move& move, const MoveEvaluation& eval)
 {
 	PgnGame::MoveData md;
 	md.key = m_board->key();
 	md.move = m_board->genericMove(move);
 	md.moveString = m_board->moveString(move, Chess::Board::StandardAlgebraic);
-	md.comment = comment;
+	if (eval.isBookEval())
+		md.comment = "book";
+	else if (!eval.isEmpty())
+		md.annotation = moveAnnotation(this, eval);
 
 	m_pgn->addMove(md);
 
@@ -350,8 +226,13 @@ void ChessGame::addPgnMove(const Chess::Move& move, const QString& comment)
 
 void ChessGame::emitLastMove()
 {
-	PgnGame::MoveData md(m_pgn->moves().last());
-	emit moveMade(md.move, md.moveString, md.comment);
+	const PgnGame::MoveData& md(m_pgn->moves().last());
+
+	// The comment is formatted only for those who display it
+	QString comment;
+	if (receivers(SIGNAL(moveMade(Chess::GenericMove, QString, QString))) > 0)
+		comment = m_pgn->moveComment(m_pgn->moves().size() - 1);
+	emit moveMade(md.move, md.moveString, comment);
 }
 
 void ChessGame::onMoveMade(const Chess::Move& move)
@@ -368,7 +249,7 @@ void ChessGame::onMoveMade(const Chess::Move& move)
 	}
 
 	m_moves.append(move);
-	addPgnMove(move, evalString(this, sender->evaluation()));
+	addPgnMove(move, sender->evaluation());
 
 	// Get the result before sending the move to the opponent
 	m_board->makeMove(move);
@@ -781,12 +662,14 @@ void ChessGame::startGame()
 	}
 
 	// Play the forced opening moves first
+	MoveEvaluation bookEval;
+	bookEval.setBookEval(true);
 	for (int i = 0; i < m_moves.size(); i++)
 	{
 		Chess::Move move(m_moves.at(i));
 		Q_ASSERT(m_board->isLegalMove(move));
 
-		addPgnMove(move, "book");
+		addPgnMove(move, bookEval);
 
 		playerToMove()->makeBookMove(move);
 		playerToWait()->makeMove(move);
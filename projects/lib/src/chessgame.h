@@ -108,7 +108,7 @@ class LIB_EXPORT ChessGame : public QObject
 		Chess::Move bookMove(Chess::Side side);
 		void resetBoard();
 		void initializePgn();
-		void addPgnMove(const Chess::Move& move, const QString& comment);
+		void addPgnMove(const Chess::Move& move, const MoveEvaluation& eval);
 		void emitLastMove();
 		void startGameTimer();
 		int stopGameTimer();
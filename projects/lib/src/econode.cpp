@@ -22,6 +22,9 @@
 #include <QMutex>
 #include "pgngame.h"
 #include "pgnstream.h"
+#include "parallelpgnreader.h"
+#include "board/board.h"
+#include "board/boardfactory.h"
 
 EcoInfo::EcoInfo(const QString& ecoCode, const QString& opening, const QString& variation) :
 m_ecoCode(ecoCode),
@@ -35,6 +38,7 @@ m_variation(variation)
 
 static QStringList s_openings;
 static EcoNode* s_root = 0;
+static QHash<quint64, const EcoNode*> s_positions;
 
 class EcoDeleter
 {
@@ -70,6 +74,50 @@ QDataStream& operator>>(QDataStream& in, EcoNode*& node)
 	return in;
 }
 
+// Maps the zobrist key of the position at each node to the node.
+// Positions that are reached by more than one line are mapped to the
+// node of the shortest line.
+void EcoNode::addPositions(Chess::Board* board,
+			   const EcoNode* node,
+			   int ply,
+			   QHash<quint64, int>& plies)
+{
+	QMap<QString, EcoNode*>::const_iterator it;
+	for (it = node->m_children.constBegin();
+	     it != node->m_children.constEnd(); ++it)
+	{
+		Chess::Move move(board->moveFromString(it.key()));
+		if (move.isNull())
+		{
+			qWarning("Invalid move in the ECO tree: %s",
+				 qPrintable(it.key()));
+			continue;
+		}
+
+		board->makeMove(move);
+		quint64 key = board->key();
+		if (!plies.contains(key) || plies.value(key) > ply + 1)
+		{
+			plies[key] = ply + 1;
+			s_positions[key] = it.value();
+		}
+		addPositions(board, it.value(), ply + 1, plies);
+		board->undoMove();
+	}
+}
+
+void EcoNode::initializePositions(const EcoNode* root)
+{
+	Chess::Board* board = Chess::BoardFactory::create("standard");
+	Q_ASSERT(board != 0);
+	board->reset();
+
+	QHash<quint64, int> plies;
+	addPositions(board, root, 0, plies);
+
+	delete board;
+}
+
 static int ecoFromString(const QString& ecoString)
 {
 	if (ecoString.length() < 2)
@@ -102,7 +150,12 @@ void EcoNode::initialize()
 		{
 			QDataStream in(&file);
 			in.setVersion(QDataStream::Qt_4_6);
-			in >> s_openings >> s_root;
+			// The tree is published only after its positions
+			// have been indexed
+			EcoNode* root = 0;
+			in >> s_openings >> root;
+			initializePositions(root);
+			s_root = root;
 		}
 	}
 	mutex.unlock();
@@ -123,8 +176,9 @@ void EcoNode::initialize(PgnStream& in)
 	EcoNode* current = s_root;
 	QMap<QString, int> tmpOpenings;
 
+	ParallelPgnReader reader(in);
 	PgnGame game;
-	while (game.read(in))
+	while (reader.readGame(game))
 	{
 		current = s_root;
 		foreach (const PgnGame::MoveData& move, game.moves())
@@ -158,6 +212,8 @@ void EcoNode::initialize(PgnStream& in)
 
 		current->m_variation = game.tagValue("Variation");
 	}
+
+	initializePositions(s_root);
 }
 
 const EcoNode* EcoNode::root()
@@ -185,7 +241,12 @@ const EcoNode* EcoNode::find(const QVector<PgnGame::MoveData>& moves)
 		current = node;
 	}
 
-	return 0;
+	return valid;
+}
+
+const EcoNode* EcoNode::findPosition(quint64 key)
+{
+	return s_positions.value(key);
 }
 
 void EcoNode::write(const QString& fileName)
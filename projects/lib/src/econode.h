@@ -20,9 +20,11 @@
 
 #include <QString>
 #include <QMap>
+#include <QHash>
 #include "pgngame.h"
 class QDataStream;
 class PgnStream;
+namespace Chess { class Board; }
 
 struct EcoInfo
 {
@@ -50,6 +52,8 @@ struct EcoInfo
  * that's part of the cutechess library (the default). A node corresponding
  * to a PgnGame can be found by traversing the ECO tree as new moves are added
  * to the game, or by passing all the moves at once to the find() function.
+ * Games that transpose into a known opening line can be matched by position
+ * with the findPosition() function.
  *
  * \note The Encyclopaedia of Chess Openings only applies to games of standard
  * chess that start from the default starting position.
@@ -101,6 +105,15 @@ class LIB_EXPORT EcoNode
 		 * opening sequence in \a moves.
 		 */
 		static const EcoNode* find(const QVector<PgnGame::MoveData>& moves);
+		/*!
+		 * Returns the node whose opening line leads to the position
+		 * with zobrist key \a key, or 0 if no line leads there.
+		 *
+		 * This finds the opening of a game that has transposed into
+		 * a known line. If several lines lead to the same position,
+		 * the node of the shortest line is returned.
+		 */
+		static const EcoNode* findPosition(quint64 key);
 		/*! Writes the ECO tree in binary format to \a fileName. */
 		static void write(const QString& fileName);
 
@@ -110,6 +123,11 @@ class LIB_EXPORT EcoNode
 
 		EcoNode();
 		void addChild(const QString& sanMove, EcoNode* child);
+		static void initializePositions(const EcoNode* root);
+		static void addPositions(Chess::Board* board,
+					 const EcoNode* node,
+					 int ply,
+					 QHash<quint64, int>& plies);
 
 		qint16 m_ecoCode;
 		qint32 m_opening;
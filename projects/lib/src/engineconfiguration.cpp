@@ -24,6 +24,8 @@
 EngineConfiguration::EngineConfiguration()
 	: m_variants(QStringList() << "standard"),
 	  m_whiteEvalPov(false),
+	  m_fenAfterIrreversible(false),
+	  m_infoInterval(0),
 	  m_validateClaims(true),
 	  m_restartMode(RestartAuto),
 	  m_rating(0)
@@ -38,6 +40,8 @@ EngineConfiguration::EngineConfiguration(const QString& name,
 	  m_protocol(protocol),
 	  m_variants(QStringList() << "standard"),
 	  m_whiteEvalPov(false),
+	  m_fenAfterIrreversible(false),
+	  m_infoInterval(0),
 	  m_validateClaims(true),
 	  m_restartMode(RestartAuto),
 	  m_rating(0)
@@ -47,6 +51,8 @@ EngineConfiguration::EngineConfiguration(const QString& name,
 EngineConfiguration::EngineConfiguration(const QVariant& variant)
 	: m_variants(QStringList() << "standard"),
 	  m_whiteEvalPov(false),
+	  m_fenAfterIrreversible(false),
+	  m_infoInterval(0),
 	  m_validateClaims(true),
 	  m_restartMode(RestartAuto),
 	  m_rating(0)
@@ -62,6 +68,10 @@ EngineConfiguration::EngineConfiguration(const QVariant& variant)
 		setInitStrings(map["initStrings"].toStringList());
 	if (map.contains("whitepov"))
 		setWhiteEvalPov(map["whitepov"].toBool());
+	if (map.contains("fenAfterIrreversible"))
+		setFenAfterIrreversible(map["fenAfterIrreversible"].toBool());
+	if (map.contains("infoInterval"))
+		setInfoInterval(map["infoInterval"].toInt());
 
 	if (map.contains("restart"))
 	{
@@ -107,6 +117,8 @@ EngineConfiguration::EngineConfiguration(const EngineConfiguration& other)
 	  m_initStrings(other.m_initStrings),
 	  m_variants(other.m_variants),
 	  m_whiteEvalPov(other.m_whiteEvalPov),
+	  m_fenAfterIrreversible(other.m_fenAfterIrreversible),
+	  m_infoInterval(other.m_infoInterval),
 	  m_validateClaims(other.m_validateClaims),
 	  m_restartMode(other.m_restartMode),
 	  m_rating(other.m_rating)
@@ -133,6 +145,10 @@ QVariant EngineConfiguration::toVariant() const
 		map.insert("initStrings", m_initStrings);
 	if (m_whiteEvalPov)
 		map.insert("whitepov", true);
+	if (m_fenAfterIrreversible)
+		map.insert("fenAfterIrreversible", true);
+	if (m_infoInterval > 0)
+		map.insert("infoInterval", m_infoInterval);
 
 	if (m_restartMode == RestartOn)
 		map.insert("restart", "on");
@@ -300,6 +316,26 @@ void EngineConfiguration::setWhiteEvalPov(bool whiteEvalPov)
 	m_whiteEvalPov = whiteEvalPov;
 }
 
+bool EngineConfiguration::fenAfterIrreversible() const
+{
+	return m_fenAfterIrreversible;
+}
+
+void EngineConfiguration::setFenAfterIrreversible(bool enabled)
+{
+	m_fenAfterIrreversible = enabled;
+}
+
+int EngineConfiguration::infoInterval() const
+{
+	return m_infoInterval;
+}
+
+void EngineConfiguration::setInfoInterval(int interval)
+{
+	m_infoInterval = qMax(interval, 0);
+}
+
 EngineConfiguration::RestartMode EngineConfiguration::restartMode() const
 {
 	return m_restartMode;
@@ -332,6 +368,8 @@ EngineConfiguration& EngineConfiguration::operator=(const EngineConfiguration& o
 		m_initStrings = other.m_initStrings;
 		m_variants = other.m_variants;
 		m_whiteEvalPov = other.m_whiteEvalPov;
+		m_fenAfterIrreversible = other.m_fenAfterIrreversible;
+		m_infoInterval = other.m_infoInterval;
 		m_validateClaims = other.m_validateClaims;
 		m_restartMode = other.m_restartMode;
 		m_rating = other.m_rating;
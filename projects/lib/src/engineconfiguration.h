@@ -171,6 +171,32 @@ class LIB_EXPORT EngineConfiguration
 		/*! Sets white evaluation point of view. */
 		void setWhiteEvalPov(bool whiteEvalPov);
 
+		/*!
+		 * Returns true if the position is sent to the engine as a
+		 * FEN string after every irreversible move; otherwise
+		 * returns false.
+		 *
+		 * Only UCI engines use this setting. By default (false) the
+		 * position is sent as the starting position followed by all
+		 * the moves of the game.
+		 */
+		bool fenAfterIrreversible() const;
+		/*! Sets the FEN mode for irreversible moves to \a enabled. */
+		void setFenAfterIrreversible(bool enabled);
+
+		/*!
+		 * Returns the minimum interval, in milliseconds, between
+		 * updates of the engine's evaluation while it's thinking.
+		 *
+		 * Only UCI engines use this setting. With the default value
+		 * (0) every "info" line is parsed as it arrives. Otherwise
+		 * only the latest values are kept, and they are parsed at
+		 * most once per interval and when the engine moves.
+		 */
+		int infoInterval() const;
+		/*! Sets the evaluation update interval to \a interval. */
+		void setInfoInterval(int interval);
+
 		/*!
 		 * Returns the restart mode.
 		 * The default value is \a RestartAuto.
@@ -206,6 +232,8 @@ class LIB_EXPORT EngineConfiguration
 		QStringList m_variants;
 		QList<EngineOption*> m_options;
 		bool m_whiteEvalPov;
+		bool m_fenAfterIrreversible;
+		int m_infoInterval;
 		bool m_validateClaims;
 		RestartMode m_restartMode;
 		int m_rating;
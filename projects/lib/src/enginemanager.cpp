@@ -18,9 +18,8 @@
 #include "enginemanager.h"
 #include <QSettings>
 #include <QFile>
-#include <QTextStream>
-#include <jsonparser.h>
-#include <jsonserializer.h>
+#include <jsonreader.h>
+#include <jsonwriter.h>
 
 
 EngineManager::EngineManager(QObject* parent)
@@ -87,15 +86,14 @@ void EngineManager::loadEngines(const QString& fileName)
 		return;
 	}
 
-	QTextStream stream(&input);
-	JsonParser parser(stream);
-	const QVariantList engines(parser.parse().toList());
+	JsonReader reader(input.readAll());
+	const QVariantList engines(reader.parse().toList());
 
-	if (parser.hasError())
+	if (reader.hasError())
 	{
 		qWarning("%s", qPrintable(QString("bad engine configuration file line %1 in %2: %3")
-			.arg(parser.errorLineNumber()).arg(fileName)
-			.arg(parser.errorString())));
+			.arg(reader.errorLineNumber()).arg(fileName)
+			.arg(reader.errorString())));
 		return;
 	}
 
@@ -116,9 +114,10 @@ void EngineManager::saveEngines(const QString& fileName)
 		return;
 	}
 
-	QTextStream out(&output);
-	JsonSerializer serializer(engines);
-	serializer.serialize(out);
+	QByteArray bytes;
+	JsonWriter writer(engines);
+	if (writer.serialize(bytes))
+		output.write(bytes);
 }
 
 QSet<QString> EngineManager::engineNames() const
@@ -0,0 +1,168 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "enginetoken.h"
+#include <cstring>
+
+
+EngineToken::EngineToken()
+	: m_line(0),
+	  m_lineSize(0),
+	  m_position(0),
+	  m_size(0)
+{
+}
+
+EngineToken::EngineToken(const char* line,
+			 int lineSize,
+			 int position,
+			 int size)
+	: m_line(line),
+	  m_lineSize(lineSize),
+	  m_position(position),
+	  m_size(size)
+{
+	Q_ASSERT(line != 0);
+	Q_ASSERT(position >= 0 && size >= 0);
+	Q_ASSERT(position + size <= lineSize);
+}
+
+bool EngineToken::isNull() const
+{
+	return m_line == 0;
+}
+
+bool EngineToken::isEmpty() const
+{
+	return m_size == 0;
+}
+
+const char* EngineToken::line() const
+{
+	return m_line;
+}
+
+int EngineToken::lineSize() const
+{
+	return m_lineSize;
+}
+
+int EngineToken::position() const
+{
+	return m_position;
+}
+
+int EngineToken::size() const
+{
+	return m_size;
+}
+
+const char* EngineToken::constData() const
+{
+	return m_line + m_position;
+}
+
+char EngineToken::at(int i) const
+{
+	Q_ASSERT(i >= 0 && i < m_size);
+	return m_line[m_position + i];
+}
+
+EngineToken EngineToken::joined(const EngineToken& last) const
+{
+	Q_ASSERT(last.m_line == m_line);
+	Q_ASSERT(last.m_position >= m_position);
+
+	return EngineToken(m_line, m_lineSize, m_position,
+			   last.m_position + last.m_size - m_position);
+}
+
+bool EngineToken::parseNumber(quint64* value, bool* negative) const
+{
+	const char* data = constData();
+	int i = 0;
+
+	*value = 0;
+	*negative = false;
+	if (m_size > 0 && (data[0] == '-' || data[0] == '+'))
+	{
+		*negative = (data[0] == '-');
+		i++;
+	}
+	if (i >= m_size)
+		return false;
+
+	for (; i < m_size; i++)
+	{
+		if (data[i] < '0' || data[i] > '9')
+			return false;
+
+		int digit = data[i] - '0';
+		if (*value > (Q_UINT64_C(0xFFFFFFFFFFFFFFFF) - digit) / 10)
+			return false;
+		*value = *value * 10 + digit;
+	}
+
+	return true;
+}
+
+int EngineToken::toInt(bool* ok) const
+{
+	quint64 value;
+	bool negative;
+	bool valid = parseNumber(&value, &negative)
+		  && value <= (negative ? 2147483648ULL : 2147483647ULL);
+
+	if (ok != 0)
+		*ok = valid;
+	if (!valid)
+		return 0;
+	return negative ? int(-qint64(value)) : int(value);
+}
+
+quint64 EngineToken::toULongLong(bool* ok) const
+{
+	quint64 value;
+	bool negative;
+	bool valid = parseNumber(&value, &negative) && !negative;
+
+	if (ok != 0)
+		*ok = valid;
+	return valid ? value : 0;
+}
+
+QString EngineToken::toString() const
+{
+	if (m_line == 0)
+		return QString();
+	return QString::fromUtf8(constData(), m_size);
+}
+
+bool EngineToken::operator==(const char* str) const
+{
+	if (m_line == 0)
+		return false;
+
+	int len = int(strlen(str));
+	return len == m_size && memcmp(constData(), str, len) == 0;
+}
+
+bool EngineToken::operator!=(const char* str) const
+{
+	return !(*this == str);
+}
@@ -0,0 +1,112 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ENGINETOKEN_H
+#define ENGINETOKEN_H
+
+#include <QString>
+#include <QByteArray>
+
+/*!
+ * \brief A reference to a word in a line of raw engine output
+ *
+ * EngineToken is the byte-oriented counterpart of QStringRef. Chess
+ * engines communicate in plain ASCII, so their output is tokenized
+ * without converting it to Unicode first, and only the tokens that
+ * are kept are converted with toString().
+ *
+ * An EngineToken doesn't own the data it refers to. It remains valid
+ * only as long as the line it was read from.
+ *
+ * \sa ChessEngine::firstToken(), ChessEngine::nextToken()
+ */
+class LIB_EXPORT EngineToken
+{
+	public:
+		/*! Creates a null token. */
+		EngineToken();
+		/*!
+		 * Creates a token of \a size bytes at \a position in
+		 * \a line, which is \a lineSize bytes long.
+		 */
+		EngineToken(const char* line,
+			    int lineSize,
+			    int position,
+			    int size);
+
+		/*! Returns true if the token is null. */
+		bool isNull() const;
+		/*! Returns true if the token has no characters. */
+		bool isEmpty() const;
+
+		/*! Returns the line that contains the token. */
+		const char* line() const;
+		/*! Returns the size of the line in bytes. */
+		int lineSize() const;
+		/*! Returns the starting position of the token in the line. */
+		int position() const;
+		/*! Returns the size of the token in bytes. */
+		int size() const;
+		/*! Returns a pointer to the first character of the token. */
+		const char* constData() const;
+		/*! Returns the character at index \a i of the token. */
+		char at(int i) const;
+
+		/*!
+		 * Returns a token that spans from the start of this token
+		 * to the end of \a last, which must be on the same line.
+		 */
+		EngineToken joined(const EngineToken& last) const;
+
+		/*!
+		 * Returns the token as an integer, or 0 if it isn't a
+		 * valid decimal number. If \a ok is not 0, it is set to
+		 * true on success and false on failure.
+		 */
+		int toInt(bool* ok = 0) const;
+		/*!
+		 * Returns the token as an unsigned 64-bit integer, or 0
+		 * if it isn't a valid decimal number.
+		 * \sa toInt()
+		 */
+		quint64 toULongLong(bool* ok = 0) const;
+		/*! Returns the token as UTF-8 decoded text. */
+		QString toString() const;
+
+		/*! Returns true if the token is the same as \a str. */
+		bool operator==(const char* str) const;
+		/*! Returns true if the token is not the same as \a str. */
+		bool operator!=(const char* str) const;
+
+		/*! Returns true if \a c is a whitespace character. */
+		static bool isSpace(char c);
+
+	private:
+		bool parseNumber(quint64* value, bool* negative) const;
+
+		const char* m_line;
+		int m_lineSize;
+		int m_position;
+		int m_size;
+};
+
+inline bool EngineToken::isSpace(char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+#endif // ENGINETOKEN_H
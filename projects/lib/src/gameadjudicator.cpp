@@ -26,7 +26,8 @@ GameAdjudicator::GameAdjudicator()
 	  m_drawScoreCount(0),
 	  m_resignMoveCount(0),
 	  m_resignScore(0),
-	  m_tbEnabled(false)
+	  m_tbEnabled(false),
+	  m_tbCache(0)
 {
 	m_resignLoserScoreCount[0] = 0;
 	m_resignLoserScoreCount[1] = 0;
@@ -62,6 +63,11 @@ void GameAdjudicator::setTablebaseAdjudication(bool enable)
 	m_tbEnabled = enable;
 }
 
+void GameAdjudicator::setTablebaseCache(TablebaseCache* cache)
+{
+	m_tbCache = cache;
+}
+
 void GameAdjudicator::resetDrawCount()
 {
 	m_drawScoreCount = 0;
@@ -74,7 +80,7 @@ void GameAdjudicator::addEval(const Chess::Board* board, const MoveEvaluation& e
 	// Tablebase adjudication
 	if (m_tbEnabled)
 	{
-		m_result = board->tablebaseResult();
+		m_result = board->tablebaseResult(0, m_tbCache);
 		if (!m_result.isNone())
 			return;
 	}
@@ -20,6 +20,7 @@
 
 #include "board/result.h"
 namespace Chess { class Board; }
+class TablebaseCache;
 class MoveEvaluation;
 
 /*!
@@ -63,6 +64,13 @@ class LIB_EXPORT GameAdjudicator
 		 * latest position is found in the tablebases.
 		 */
 		void setTablebaseAdjudication(bool enable);
+		/*!
+		 * Sets the cache for tablebase probes to \a cache.
+		 *
+		 * The cache can be shared between several adjudicators. The
+		 * adjudicator doesn't take ownership of \a cache.
+		 */
+		void setTablebaseCache(TablebaseCache* cache);
 
 		/*!
 		 * Adds a new move evaluation to the adjudicator.
@@ -96,6 +104,7 @@ class LIB_EXPORT GameAdjudicator
 		int m_resignLoserScoreCount[2];
 		int m_resignWinnerScoreCount[2];
 		bool m_tbEnabled;
+		TablebaseCache* m_tbCache;
 		Chess::Result m_result;
 };
 
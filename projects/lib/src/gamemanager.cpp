@@ -27,13 +27,15 @@ class GameInitializer : public QObject
 
 	public:
 		GameInitializer(const PlayerBuilder* white,
-				const PlayerBuilder* black);
+				const PlayerBuilder* black,
+				QObject* receiver);
 		virtual ~GameInitializer();
 
 		const PlayerBuilder* whiteBuilder() const;
 		const PlayerBuilder* blackBuilder() const;
 		void swapPlayers();
 		void setGame(ChessGame* game);
+		void setDebugEnabled(bool enabled);
 
 	public slots:
 		void initializeGame();
@@ -49,16 +51,21 @@ class GameInitializer : public QObject
 	private:
 		int m_playerCount;
 		bool m_finishing;
+		bool m_debug;
 		const PlayerBuilder* m_builder[2];
 		ChessPlayer* m_player[2];
 		ChessGame* m_game;
+		QObject* m_receiver;
 };
 
 GameInitializer::GameInitializer(const PlayerBuilder* white,
-				 const PlayerBuilder* black)
+				 const PlayerBuilder* black,
+				 QObject* receiver)
 	: m_playerCount(0),
 	  m_finishing(false),
-	  m_game(0)
+	  m_debug(true),
+	  m_game(0),
+	  m_receiver(receiver)
 {
 	Q_ASSERT(white != 0);
 	Q_ASSERT(black != 0);
@@ -102,6 +109,11 @@ void GameInitializer::setGame(ChessGame* game)
 	m_game = game;
 }
 
+void GameInitializer::setDebugEnabled(bool enabled)
+{
+	m_debug = enabled;
+}
+
 void GameInitializer::initializeGame()
 {
 	for (int i = 0; i < 2; i++)
@@ -118,7 +130,7 @@ void GameInitializer::initializeGame()
 		if (m_player[i] == 0)
 		{
 			QString error;
-			m_player[i] = m_builder[i]->create(thread()->parent(),
+			m_player[i] = m_builder[i]->create(m_debug ? m_receiver : 0,
 							   SIGNAL(debugMessage(QString)),
 							   this, &error);
 			m_game->setError(error);
@@ -177,21 +189,23 @@ void GameInitializer::onPlayerQuit()
 }
 
 
-class GameThread : public QThread
+class GameSlot : public QObject
 {
 	Q_OBJECT
 
 	public:
-		GameThread(const PlayerBuilder* white,
-			   const PlayerBuilder* black,
-			   QObject* parent);
-		virtual ~GameThread();
+		GameSlot(const PlayerBuilder* white,
+			 const PlayerBuilder* black,
+			 QThread* workerThread,
+			 GameManager* manager);
 
 		bool isReady() const;
-		void newGame(ChessGame* game);
+		bool isRunning() const;
+		void newGame(ChessGame* game, bool debug);
 		void finish();
 		void finishAndDelete();
 
+		QThread* workerThread() const;
 		GameInitializer* initializer() const;
 		ChessGame* game() const;
 		GameManager::StartMode startMode() const;
@@ -203,49 +217,70 @@ class GameThread : public QThread
 	signals:
 		void gameInitialized(bool success);
 		void ready();
+		void finished();
 
 	private slots:
 		void onGameDestroyed();
+		void onInitializerDestroyed();
+		void onFinished();
 
 	private:
 		bool m_ready;
+		bool m_running;
 		GameManager::StartMode m_startMode;
 		GameManager::CleanupMode m_cleanupMode;
 		ChessGame* m_game;
 		GameInitializer* m_initializer;
+		QThread* m_thread;
+		bool m_ownsThread;
 };
 
-GameThread::GameThread(const PlayerBuilder* white,
-		       const PlayerBuilder* black,
-		       QObject* parent)
-	: QThread(parent),
+GameSlot::GameSlot(const PlayerBuilder* white,
+		   const PlayerBuilder* black,
+		   QThread* workerThread,
+		   GameManager* manager)
+	: QObject(manager),
 	  m_ready(true),
+	  m_running(true),
 	  m_startMode(GameManager::StartImmediately),
 	  m_cleanupMode(GameManager::DeletePlayers),
 	  m_game(0),
-	  m_initializer(new GameInitializer(white, black))
+	  m_initializer(new GameInitializer(white, black, manager)),
+	  m_thread(workerThread),
+	  m_ownsThread(workerThread == 0)
 {
+	// Without a shared worker thread the slot runs in a thread
+	// of its own, which quits when the players are gone.
+	if (m_ownsThread)
+	{
+		m_thread = new QThread(this);
+		connect(m_thread, SIGNAL(finished()),
+			this, SLOT(onFinished()));
+		m_thread->start();
+	}
+
 	connect(m_initializer, SIGNAL(gameInitialized(bool)),
 		this, SIGNAL(gameInitialized(bool)));
 	connect(m_initializer, SIGNAL(finished()),
 		m_initializer, SLOT(deleteLater()),
 		Qt::QueuedConnection);
 	connect(m_initializer, SIGNAL(destroyed()),
-		this, SLOT(quit()),
+		this, SLOT(onInitializerDestroyed()),
 		Qt::QueuedConnection);
-	m_initializer->moveToThread(this);
+	m_initializer->moveToThread(m_thread);
 }
 
-GameThread::~GameThread()
+bool GameSlot::isReady() const
 {
+	return m_ready;
 }
 
-bool GameThread::isReady() const
+bool GameSlot::isRunning() const
 {
-	return m_ready;
+	return m_running;
 }
 
-void GameThread::newGame(ChessGame* game)
+void GameSlot::newGame(ChessGame* game, bool debug)
 {
 	m_ready = false;
 	m_game = game;
@@ -254,11 +289,12 @@ void GameThread::newGame(ChessGame* game)
 		Qt::QueuedConnection);
 
 	m_initializer->setGame(m_game);
+	m_initializer->setDebugEnabled(debug);
 	QMetaObject::invokeMethod(m_initializer, "initializeGame",
 				  Qt::QueuedConnection);
 }
 
-void GameThread::finish()
+void GameSlot::finish()
 {
 	if (m_initializer == 0)
 		return;
@@ -274,57 +310,84 @@ void GameThread::finish()
 	m_initializer = 0;
 }
 
-void GameThread::finishAndDelete()
+void GameSlot::finishAndDelete()
 {
 	connect(this, SIGNAL(finished()), this, SLOT(deleteLater()));
 	finish();
 }
 
-GameInitializer* GameThread::initializer() const
+QThread* GameSlot::workerThread() const
+{
+	return m_thread;
+}
+
+GameInitializer* GameSlot::initializer() const
 {
 	return m_initializer;
 }
 
-ChessGame* GameThread::game() const
+ChessGame* GameSlot::game() const
 {
 	return m_game;
 }
 
-GameManager::StartMode GameThread::startMode() const
+GameManager::StartMode GameSlot::startMode() const
 {
 	return m_startMode;
 }
 
-GameManager::CleanupMode GameThread::cleanupMode() const
+GameManager::CleanupMode GameSlot::cleanupMode() const
 {
 	return m_cleanupMode;
 }
 
-void GameThread::setStartMode(GameManager::StartMode mode)
+void GameSlot::setStartMode(GameManager::StartMode mode)
 {
 	m_startMode = mode;
 }
 
-void GameThread::setCleanupMode(GameManager::CleanupMode mode)
+void GameSlot::setCleanupMode(GameManager::CleanupMode mode)
 {
 	m_cleanupMode = mode;
 }
 
-void GameThread::onGameDestroyed()
+void GameSlot::onGameDestroyed()
 {
 	m_ready = true;
 	emit ready();
 }
 
+void GameSlot::onInitializerDestroyed()
+{
+	if (m_ownsThread)
+		m_thread->quit();
+	else
+		onFinished();
+}
+
+void GameSlot::onFinished()
+{
+	m_running = false;
+	emit finished();
+}
+
 
 GameManager::GameManager(QObject* parent)
 	: QObject(parent),
 	  m_finishing(false),
 	  m_concurrency(1),
-	  m_activeQueuedGameCount(0)
+	  m_workerThreadCount(0),
+	  m_activeQueuedGameCount(0),
+	  m_droppedSlotCount(0),
+	  m_stopPending(false)
 {
 }
 
+GameManager::~GameManager()
+{
+	stopWorkerThreads();
+}
+
 QList<ChessGame*> GameManager::activeGames() const
 {
 	return m_activeGames;
@@ -340,18 +403,28 @@ void GameManager::setConcurrency(int concurrency)
 	m_concurrency = concurrency;
 }
 
+int GameManager::workerThreadCount() const
+{
+	return m_workerThreadCount;
+}
+
+void GameManager::setWorkerThreadCount(int count)
+{
+	m_workerThreadCount = count;
+}
+
 void GameManager::cleanupIdleThreads()
 {
-	QList<GameThread*>::iterator it = m_activeThreads.begin();
-	while (it != m_activeThreads.end())
+	QList<GameSlot*>::iterator it = m_activeGameSlots.begin();
+	while (it != m_activeGameSlots.end())
 	{
-		GameThread* thread = *it;
-		Q_ASSERT(thread != 0);
+		GameSlot* gameSlot = *it;
+		Q_ASSERT(gameSlot != 0);
 
-		if (thread->isReady())
+		if (gameSlot->isReady())
 		{
-			it = m_activeThreads.erase(it);
-			thread->finishAndDelete();
+			it = m_activeGameSlots.erase(it);
+			gameSlot->finishAndDelete();
 		}
 		else
 			++it;
@@ -362,29 +435,91 @@ void GameManager::cleanup()
 {
 	m_finishing = false;
 
-	// Remove terminated threads from the list
-	QList< QPointer<GameThread> >::iterator it = m_threads.begin();
-	while (it != m_threads.end())
+	// Remove finished game slots from the list
+	QList< QPointer<GameSlot> >::iterator it = m_gameSlots.begin();
+	while (it != m_gameSlots.end())
 	{
 		if (*it == 0 || !(*it)->isRunning())
-			it = m_threads.erase(it);
+			it = m_gameSlots.erase(it);
 		else
 			++it;
 	}
 
-	if (m_threads.isEmpty())
+	if (m_gameSlots.isEmpty())
 	{
-		emit finished();
+		stopWhenIdle();
 		return;
 	}
 
-	// Terminate running threads
-	foreach (GameThread* thread, m_threads)
+	// Terminate running game slots
+	foreach (GameSlot* gameSlot, m_gameSlots)
 	{
-		connect(thread, SIGNAL(finished()), this, SLOT(onThreadQuit()),
+		connect(gameSlot, SIGNAL(finished()), this, SLOT(onGameSlotFinished()),
 			Qt::QueuedConnection);
-		thread->finish();
+		gameSlot->finish();
+	}
+}
+
+void GameManager::stopWhenIdle()
+{
+	// Slots that failed to start are no longer in m_gameSlots, but
+	// they may still be finishing in the worker threads
+	if (m_droppedSlotCount > 0)
+	{
+		m_stopPending = true;
+		return;
+	}
+
+	m_stopPending = false;
+	stopWorkerThreads();
+	emit finished();
+}
+
+void GameManager::stopWorkerThreads()
+{
+	foreach (QThread* thread, m_workerThreads)
+	{
+		thread->quit();
+		thread->wait();
+		delete thread;
+	}
+	m_workerThreads.clear();
+}
+
+QThread* GameManager::workerThread()
+{
+	if (m_workerThreadCount <= 0)
+		return 0;
+
+	// Use the thread with the fewest game slots. A new thread is
+	// started only if all the threads are busy and the pool
+	// isn't full yet.
+	QThread* best = 0;
+	int bestLoad = 0;
+	foreach (QThread* thread, m_workerThreads)
+	{
+		int load = 0;
+		foreach (GameSlot* gameSlot, m_gameSlots)
+		{
+			if (gameSlot != 0 && gameSlot->workerThread() == thread)
+				load++;
+		}
+		if (best == 0 || load < bestLoad)
+		{
+			best = thread;
+			bestLoad = load;
+		}
 	}
+
+	if (best == 0
+	||  (bestLoad > 0 && m_workerThreads.size() < m_workerThreadCount))
+	{
+		best = new QThread(this);
+		best->start();
+		m_workerThreads << best;
+	}
+
+	return best;
 }
 
 void GameManager::finish()
@@ -419,37 +554,49 @@ void GameManager::newGame(ChessGame* game,
 	startQueuedGame();
 }
 
-void GameManager::onThreadQuit()
+void GameManager::onGameSlotFinished()
 {
-	GameThread* thread = qobject_cast<GameThread*>(QObject::sender());
-	m_threads.removeOne(thread);
+	GameSlot* gameSlot = qobject_cast<GameSlot*>(QObject::sender());
+	m_gameSlots.removeOne(gameSlot);
 
-	if (thread != 0)
-		thread->deleteLater();
+	if (gameSlot != 0)
+		gameSlot->deleteLater();
 
-	if (m_threads.isEmpty())
+	if (m_gameSlots.isEmpty())
 	{
 		m_finishing = false;
-		emit finished();
+		stopWhenIdle();
 	}
 }
 
-void GameManager::onThreadReady()
+void GameManager::onDroppedGameSlotFinished()
+{
+	if (--m_droppedSlotCount > 0 || !m_stopPending)
+		return;
+
+	// New games may have started while the slot was finishing
+	if (m_gameSlots.isEmpty())
+		stopWhenIdle();
+	else
+		m_stopPending = false;
+}
+
+void GameManager::onGameSlotReady()
 {
-	GameThread* thread = qobject_cast<GameThread*>(QObject::sender());
-	Q_ASSERT(thread != 0);
-	ChessGame* game = thread->game();
+	GameSlot* gameSlot = qobject_cast<GameSlot*>(QObject::sender());
+	Q_ASSERT(gameSlot != 0);
+	ChessGame* game = gameSlot->game();
 
 	m_activeGames.removeOne(game);
-	m_threads.removeAll(0);
+	m_gameSlots.removeAll(0);
 
-	if (thread->cleanupMode() == DeletePlayers)
+	if (gameSlot->cleanupMode() == DeletePlayers)
 	{
-		m_activeThreads.removeOne(thread);
-		thread->finishAndDelete();
+		m_activeGameSlots.removeOne(gameSlot);
+		gameSlot->finishAndDelete();
 	}
 
-	if (thread->startMode() == Enqueue)
+	if (gameSlot->startMode() == Enqueue)
 	{
 		m_activeQueuedGameCount--;
 		startQueuedGame();
@@ -462,30 +609,33 @@ void GameManager::onThreadReady()
 
 void GameManager::onGameInitialized(bool success)
 {
-	GameThread* gameThread = qobject_cast<GameThread*>(sender());
-	Q_ASSERT(gameThread != 0);
-	ChessGame* game = gameThread->game();
+	GameSlot* gameSlot = qobject_cast<GameSlot*>(sender());
+	Q_ASSERT(gameSlot != 0);
+	ChessGame* game = gameSlot->game();
 
 	if (!success)
 	{
-		m_threads.removeOne(gameThread);
-		m_activeThreads.removeOne(gameThread);
+		m_gameSlots.removeOne(gameSlot);
+		m_activeGameSlots.removeOne(gameSlot);
 
-		connect(gameThread, SIGNAL(destroyed()),
+		m_droppedSlotCount++;
+		connect(gameSlot, SIGNAL(finished()),
+			this, SLOT(onDroppedGameSlotFinished()));
+		connect(gameSlot, SIGNAL(destroyed()),
 			game, SLOT(emitStartFailed()));
-		gameThread->finishAndDelete();
+		gameSlot->finishAndDelete();
 
 		return;
 	}
 
 	m_activeGames << game;
-	if (gameThread->startMode() == Enqueue)
+	if (gameSlot->startMode() == Enqueue)
 	{
 		m_activeQueuedGameCount++;
 		cleanupIdleThreads();
 	}
 
-	game->moveToThread(gameThread);
+	game->moveToThread(gameSlot->workerThread());
 	connect(game, SIGNAL(started(ChessGame*)),
 		this, SIGNAL(gameStarted(ChessGame*)),
 		Qt::QueuedConnection);
@@ -494,46 +644,50 @@ void GameManager::onGameInitialized(bool success)
 	startQueuedGame();
 }
 
-GameThread* GameManager::getThread(const PlayerBuilder* white,
+GameSlot* GameManager::getGameSlot(const PlayerBuilder* white,
 				   const PlayerBuilder* black)
 {
 	Q_ASSERT(white != 0);
 	Q_ASSERT(black != 0);
 
-	foreach (GameThread* thread, m_activeThreads)
+	foreach (GameSlot* gameSlot, m_activeGameSlots)
 	{
-		if (!thread->isReady())
+		if (!gameSlot->isReady())
 			continue;
 
-		GameInitializer* tmp = thread->initializer();
+		GameInitializer* tmp = gameSlot->initializer();
 		if (tmp->whiteBuilder() == black
 		&&  tmp->blackBuilder() == white)
 			tmp->swapPlayers();
 		if (tmp->whiteBuilder() == white && tmp->blackBuilder() == black)
-			return thread;
+			return gameSlot;
 	}
 
-	GameThread* gameThread = new GameThread(white, black, this);
-	m_threads << gameThread;
-	m_activeThreads << gameThread;
-	connect(gameThread, SIGNAL(ready()),
-		this, SLOT(onThreadReady()));
-	connect(gameThread, SIGNAL(gameInitialized(bool)),
+	GameSlot* gameSlot = new GameSlot(white, black, workerThread(), this);
+	m_gameSlots << gameSlot;
+	m_activeGameSlots << gameSlot;
+	connect(gameSlot, SIGNAL(ready()),
+		this, SLOT(onGameSlotReady()));
+	connect(gameSlot, SIGNAL(gameInitialized(bool)),
 		this, SLOT(onGameInitialized(bool)),
 		Qt::QueuedConnection);
 
-	gameThread->start();
-	return gameThread;
+	return gameSlot;
 }
 
 void GameManager::startGame(const GameEntry& entry)
 {
-	GameThread* gameThread = getThread(entry.white, entry.black);
-	Q_ASSERT(gameThread != 0);
+	GameSlot* gameSlot = getGameSlot(entry.white, entry.black);
+	Q_ASSERT(gameSlot != 0);
+
+	// New players send their debug messages through the manager
+	// only if someone is listening, so that engines don't have to
+	// format them for nothing
+	bool debug = receivers(SIGNAL(debugMessage(QString))) > 0;
 
-	gameThread->setStartMode(entry.startMode);
-	gameThread->setCleanupMode(entry.cleanupMode);
-	gameThread->newGame(entry.game);
+	gameSlot->setStartMode(entry.startMode);
+	gameSlot->setCleanupMode(entry.cleanupMode);
+	gameSlot->newGame(entry.game, debug);
 }
 
 void GameManager::startQueuedGame()
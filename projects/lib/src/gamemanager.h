@@ -24,7 +24,8 @@
 class ChessGame;
 class ChessPlayer;
 class PlayerBuilder;
-class GameThread;
+class GameSlot;
+class QThread;
 
 
 /*!
@@ -34,6 +35,11 @@ class GameThread;
  * multiple games concurrently, and queue games to be
  * run when a game slot/thread is free.
  *
+ * By default each game slot gets a thread of its own. With
+ * setWorkerThreadCount() the games are multiplexed onto a fixed
+ * pool of threads instead, which avoids starting and stopping
+ * threads when many short games are played concurrently.
+ *
  * \sa ChessGame, PlayerBuilder
  */
 class LIB_EXPORT GameManager : public QObject
@@ -70,6 +76,8 @@ class LIB_EXPORT GameManager : public QObject
 
 		/*! Creates a new game manager. */
 		GameManager(QObject* parent = 0);
+		/*! Destroys the game manager and its worker threads. */
+		virtual ~GameManager();
 
 		/*!
 		 * Returns the list of active games.
@@ -97,6 +105,31 @@ class LIB_EXPORT GameManager : public QObject
 		 */
 		void setConcurrency(int concurrency);
 
+		/*!
+		 * Returns the size of the worker thread pool.
+		 *
+		 * The default is 0, which means that each game slot
+		 * runs in a thread of its own.
+		 *
+		 * \sa setWorkerThreadCount()
+		 */
+		int workerThreadCount() const;
+		/*!
+		 * Sets the size of the worker thread pool to \a count.
+		 *
+		 * If \a count is larger than 0, new game slots are
+		 * distributed over at most \a count threads. A game slot
+		 * and its players stay in the same thread for as long as
+		 * the slot exists, so the players' I/O is always handled
+		 * by the thread that created them. The threads are started
+		 * when they're needed and stopped by finish().
+		 *
+		 * \note ChessGame::lockThread() pauses every game in the
+		 * same thread.
+		 * \sa workerThreadCount()
+		 */
+		void setWorkerThreadCount(int count);
+
 		/*!
 		 * Cleans up and deletes all idle game threads
 		 *
@@ -179,12 +212,18 @@ class LIB_EXPORT GameManager : public QObject
 		 * safely deleted.
 		 */
 		void finished();
-		/*! This signal redirects the ChessPlayer::debugMessage() signal. */
+		/*!
+		 * This signal redirects the ChessPlayer::debugMessage() signal.
+		 *
+		 * Only players that are created while this signal is
+		 * connected forward their debug messages.
+		 */
 		void debugMessage(const QString& data);
 
 	private slots:
-		void onThreadReady();
-		void onThreadQuit();
+		void onGameSlotReady();
+		void onGameSlotFinished();
+		void onDroppedGameSlotFinished();
 		void onGameInitialized(bool success);
 
 	private:
@@ -197,17 +236,24 @@ class LIB_EXPORT GameManager : public QObject
 			CleanupMode cleanupMode;
 		};
 
-		GameThread* getThread(const PlayerBuilder* white,
+		GameSlot* getGameSlot(const PlayerBuilder* white,
 				      const PlayerBuilder* black);
+		QThread* workerThread();
+		void stopWhenIdle();
+		void stopWorkerThreads();
 		void startGame(const GameEntry& entry);
 		void startQueuedGame();
 		void cleanup();
 
 		bool m_finishing;
 		int m_concurrency;
+		int m_workerThreadCount;
 		int m_activeQueuedGameCount;
-		QList< QPointer<GameThread> > m_threads;
-		QList<GameThread*> m_activeThreads;
+		int m_droppedSlotCount;
+		bool m_stopPending;
+		QList< QPointer<GameSlot> > m_gameSlots;
+		QList<GameSlot*> m_activeGameSlots;
+		QList<QThread*> m_workerThreads;
 		QList<GameEntry> m_gameEntries;
 		QList<ChessGame*> m_activeGames;
 };
@@ -0,0 +1,133 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "livepgnwriter.h"
+#include <QTextStream>
+#include <QTextCodec>
+#if QT_VERSION >= 0x050100
+#include <QSaveFile>
+#endif
+
+LivePgnWriter::LivePgnWriter(const QString& fileName, PgnGame::PgnMode mode)
+	: m_fileName(fileName),
+	  m_mode(mode),
+	  m_file(fileName),
+	  m_game(0),
+	  m_moveCount(0),
+	  m_lineLength(0),
+	  m_resultPos(0)
+{
+}
+
+QString LivePgnWriter::fileName() const
+{
+	return m_fileName;
+}
+
+bool LivePgnWriter::update(const PgnGame& game)
+{
+	if (&game != m_game
+	||  !m_file.isOpen()
+	||  game.moves().size() < m_moveCount
+	||  game.gameComment() != m_gameComment
+	||  game.tags() != m_tags)
+		return rewrite(game);
+
+	return appendMoves(game);
+}
+
+bool LivePgnWriter::finish(const PgnGame& game)
+{
+	bool ok = rewrite(game);
+
+	m_file.close();
+	m_game = 0;
+	return ok;
+}
+
+bool LivePgnWriter::rewrite(const PgnGame& game)
+{
+	m_file.close();
+	m_game = &game;
+	m_tags = game.tags();
+	m_gameComment = game.gameComment();
+	m_moveCount = game.moves().size();
+
+	QByteArray data;
+	QTextStream out(&data, QIODevice::WriteOnly);
+	out.setCodec(QTextCodec::codecForName("latin1"));
+	game.writeHeader(out, m_mode);
+	m_lineLength = game.writeMoves(out, m_mode, 0, 0);
+	out.flush();
+	m_resultPos = data.size();
+	game.writeResult(out, m_lineLength);
+	out.flush();
+
+	// Replace the live file in one step so that readers never see
+	// a partially written game
+#if QT_VERSION >= 0x050100
+	QSaveFile file(m_fileName);
+	if (!file.open(QIODevice::WriteOnly)
+	||  file.write(data) != data.size()
+	||  !file.commit())
+		return false;
+#else
+	const QString tmpFileName = m_fileName + ".tmp";
+	QFile file(tmpFileName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+	||  file.write(data) != data.size())
+		return false;
+	file.close();
+	QFile::remove(m_fileName);
+	if (!QFile::rename(tmpFileName, m_fileName))
+		return false;
+#endif
+
+	return m_file.open(QIODevice::ReadWrite);
+}
+
+bool LivePgnWriter::appendMoves(const PgnGame& game)
+{
+	if (game.moves().size() == m_moveCount)
+		return true;
+
+	QByteArray data;
+	QTextStream out(&data, QIODevice::WriteOnly);
+	out.setCodec(QTextCodec::codecForName("latin1"));
+	int lineLength = game.writeMoves(out, m_mode, m_moveCount, m_lineLength);
+	out.flush();
+	int movesSize = data.size();
+	game.writeResult(out, lineLength);
+	out.flush();
+
+	// Overwrite the old termination marker with the new moves and
+	// a new marker in a single write
+	if (!m_file.seek(m_resultPos)
+	||  m_file.write(data) != data.size()
+	||  !m_file.flush())
+	{
+		m_file.close();
+		return false;
+	}
+	if (m_file.size() > m_resultPos + data.size())
+		m_file.resize(m_resultPos + data.size());
+
+	m_moveCount = game.moves().size();
+	m_lineLength = lineLength;
+	m_resultPos += movesSize;
+	return true;
+}
@@ -0,0 +1,84 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIVEPGNWRITER_H
+#define LIVEPGNWRITER_H
+
+#include <QString>
+#include <QFile>
+#include "pgngame.h"
+
+
+/*!
+ * \brief Writes the game in progress to a PGN file.
+ *
+ * LivePgnWriter keeps a PGN file up to date with a game that is being
+ * played, eg. for broadcasting. The file is kept open, and only the
+ * new moves and the game termination marker are written when moves
+ * are added to the game.
+ *
+ * The whole file is rewritten only when the tags or the game comment
+ * change, or when the game ends. In that case the game is first
+ * written to a temporary file which then replaces the live file, so
+ * readers never see a partially written header.
+ */
+class LIB_EXPORT LivePgnWriter
+{
+	public:
+		/*!
+		 * Creates a new live PGN writer for file \a fileName.
+		 *
+		 * The games are written in \a mode mode.
+		 */
+		LivePgnWriter(const QString& fileName,
+			      PgnGame::PgnMode mode = PgnGame::Verbose);
+
+		/*! Returns the name of the live PGN file. */
+		QString fileName() const;
+
+		/*!
+		 * Updates the live file with the current state of \a game.
+		 *
+		 * If \a game is not the game that was written last, the
+		 * file is rewritten.
+		 *
+		 * Returns true if successful; otherwise returns false.
+		 */
+		bool update(const PgnGame& game);
+		/*!
+		 * Writes the final version of \a game to the live file.
+		 *
+		 * Returns true if successful; otherwise returns false.
+		 */
+		bool finish(const PgnGame& game);
+
+	private:
+		bool rewrite(const PgnGame& game);
+		bool appendMoves(const PgnGame& game);
+
+		QString m_fileName;
+		PgnGame::PgnMode m_mode;
+		QFile m_file;
+		const PgnGame* m_game;
+		QList< QPair<QString, QString> > m_tags;
+		QString m_gameComment;
+		int m_moveCount;
+		int m_lineLength;
+		qint64 m_resultPos;
+};
+
+#endif // LIVEPGNWRITER_H
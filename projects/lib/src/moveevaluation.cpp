@@ -63,7 +63,7 @@ qulonglong MoveEvaluation::nodeCount() const
 	return m_nodeCount;
 }
 
-QString MoveEvaluation::pv() const
+QVector<Chess::Move> MoveEvaluation::pv() const
 {
 	return m_pv;
 }
@@ -115,7 +115,7 @@ void MoveEvaluation::setNodeCount(qulonglong nodeCount)
 	m_nodeCount = nodeCount;
 }
 
-void MoveEvaluation::setPv(const QString& pv)
+void MoveEvaluation::setPv(const QVector<Chess::Move>& pv)
 {
 	m_pv = pv;
 }
@@ -18,7 +18,8 @@
 #ifndef MOVEEVALUATION_H
 #define MOVEEVALUATION_H
 
-#include <QString>
+#include <QVector>
+#include "board/move.h"
 
 /*!
  * \brief Evaluation data for a chess move.
@@ -66,10 +67,11 @@ class LIB_EXPORT MoveEvaluation
 		/*!
 		 * The principal variation.
 		 * This is a sequence of moves that an engine
-		 * expects to be played next.
+		 * expects to be played next, starting from the
+		 * position the player was thinking on.
 		 * \note For human players this is always empty.
 		 */
-		QString pv() const;
+		QVector<Chess::Move> pv() const;
 
 		/*! The node per second calculated by the engine (UCI only) */
 		int nps() const;
@@ -96,7 +98,7 @@ class LIB_EXPORT MoveEvaluation
 		void setNodeCount(qulonglong nodeCount);
 
 		/*! Sets the principal variation to \a pv. */
-		void setPv(const QString& pv);
+		void setPv(const QVector<Chess::Move>& pv);
 
 		/*! Sets the nodes per second to \a nps (relevant to UCI only). */
 		void setNps(int nps);
@@ -112,7 +114,7 @@ class LIB_EXPORT MoveEvaluation
 		qulonglong m_nodeCount;
 		int m_nps;
 		int m_tbHits;
-		QString m_pv;
+		QVector<Chess::Move> m_pv;
 };
 
 #endif // MOVEEVALUATION_H
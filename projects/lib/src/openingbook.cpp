@@ -21,6 +21,7 @@
 #include <QDataStream>
 #include "pgngame.h"
 #include "pgnstream.h"
+#include "parallelpgnreader.h"
 #include "mersenne.h"
 
 
@@ -122,10 +123,10 @@ int OpeningBook::import(PgnStream& in, int maxMoves)
 		return 0;
 
 	int moveCount = 0;
-	while (in.status() == PgnStream::Ok)
+	ParallelPgnReader reader(in, ParallelPgnReader::Games, maxMoves);
+	PgnGame game;
+	while (reader.readGame(game))
 	{
-		PgnGame game;
-		game.read(in, maxMoves);
 		if (game.moves().isEmpty())
 			break;
 
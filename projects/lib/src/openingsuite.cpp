@@ -19,6 +19,8 @@
 #include <QFile>
 #include <QTextStream>
 #include "pgnstream.h"
+#include "pgnindex.h"
+#include "pgngameentry.h"
 #include "epdrecord.h"
 #include "mersenne.h"
 
@@ -96,7 +98,11 @@ bool OpeningSuite::initialize()
 	}
 
 	if (m_format == PgnFormat)
+	{
 		m_pgnStream = new PgnStream(m_file);
+		if (m_order == RandomOrder || m_startIndex > 0)
+			return initializeFromIndex();
+	}
 
 	if (m_order == RandomOrder)
 	{
@@ -112,14 +118,7 @@ bool OpeningSuite::initialize()
 			if (pos.pos == -1)
 				break;
 
-			int i = Mersenne::random() % (m_filePositions.size() + 1);
-			if (i == m_filePositions.size())
-				m_filePositions.append(pos);
-			else
-			{
-				m_filePositions.append(m_filePositions.at(i));
-				m_filePositions[i] = pos;
-			}
+			addShuffledPos(pos);
 		}
 	}
 	else if (m_order == SequentialOrder)
@@ -146,6 +145,46 @@ bool OpeningSuite::initialize()
 	return true;
 }
 
+bool OpeningSuite::initializeFromIndex()
+{
+	PgnIndex index(m_fileName);
+	if (!index.update())
+		return false;
+
+	if (m_order == RandomOrder)
+	{
+		// Create a shuffled vector of file positions
+		m_filePositions.reserve(index.count());
+		for (int i = 0; i < index.count(); i++)
+		{
+			const PgnGameEntry* entry = index.entry(i);
+			FilePosition pos = { entry->pos(), entry->lineNumber() };
+			addShuffledPos(pos);
+		}
+	}
+	else if (m_startIndex < index.count())
+	{
+		const PgnGameEntry* entry = index.entry(m_startIndex);
+		m_pgnStream->seek(entry->pos(), entry->lineNumber());
+	}
+	else
+		m_pgnStream->seek(index.scanPos(), index.scanLineNumber());
+
+	return true;
+}
+
+void OpeningSuite::addShuffledPos(const FilePosition& pos)
+{
+	int i = Mersenne::random() % (m_filePositions.size() + 1);
+	if (i == m_filePositions.size())
+		m_filePositions.append(pos);
+	else
+	{
+		m_filePositions.append(m_filePositions.at(i));
+		m_filePositions[i] = pos;
+	}
+}
+
 PgnGame OpeningSuite::nextGame(int maxPlies)
 {
 	PgnGame game;
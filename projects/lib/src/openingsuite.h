@@ -90,7 +90,9 @@ class LIB_EXPORT OpeningSuite
 		 * the opening suite file and gets ready to read data. If
 		 * \a order is RandomOrder, the file positions of all the
 		 * openings are parsed from the file, which could take some
-		 * time if the file is large.
+		 * time if the file is large. For PGN files the positions are
+		 * kept in an index file (see PgnIndex), so the file only has
+		 * to be parsed once.
 		 *
 		 * Returns true if successfull; otherwise returns false.
 		 */
@@ -108,6 +110,8 @@ class LIB_EXPORT OpeningSuite
 			qint64 lineNumber;
 		};
 
+		bool initializeFromIndex();
+		void addShuffledPos(const FilePosition& pos);
 		FilePosition getPgnPos();
 		FilePosition getEpdPos();
 
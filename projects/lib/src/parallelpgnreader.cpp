@@ -0,0 +1,280 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "parallelpgnreader.h"
+#include <QThread>
+#include <QMutexLocker>
+#include "pgnstream.h"
+#include "pgngame.h"
+#include "pgngameentry.h"
+
+
+struct ParallelPgnReader::Job
+{
+	Job() : pos(0), lineNumber(1), endPos(0), endLineNumber(1),
+		done(false), ok(false) {}
+
+	QByteArray text;
+	qint64 pos;
+	qint64 lineNumber;
+	qint64 endPos;
+	qint64 endLineNumber;
+	bool done;
+	bool ok;
+	PgnGame game;
+	PgnGameEntry entry;
+};
+
+class ParallelPgnReader::SplitterThread : public QThread
+{
+	public:
+		SplitterThread(ParallelPgnReader* reader)
+			: m_reader(reader) {}
+
+	protected:
+		virtual void run() { m_reader->split(); }
+
+	private:
+		ParallelPgnReader* m_reader;
+};
+
+class ParallelPgnReader::WorkerThread : public QThread
+{
+	public:
+		WorkerThread(ParallelPgnReader* reader)
+			: m_reader(reader) {}
+
+	protected:
+		virtual void run() { m_reader->work(); }
+
+	private:
+		ParallelPgnReader* m_reader;
+};
+
+ParallelPgnReader::ParallelPgnReader(PgnStream& in,
+				     Content content,
+				     int maxMoves,
+				     int threadCount)
+	: m_in(in),
+	  m_content(content),
+	  m_maxMoves(maxMoves),
+	  m_variant(in.variant()),
+	  m_pos(in.pos()),
+	  m_lineNumber(in.lineNumber()),
+	  m_endPos(-1),
+	  m_endLineNumber(1),
+	  m_readFailed(false),
+	  m_splitDone(false),
+	  m_stopping(false),
+	  m_splitter(new SplitterThread(this))
+{
+	Q_ASSERT(maxMoves > 0);
+
+	if (threadCount <= 0)
+		threadCount = qMax(1, QThread::idealThreadCount());
+	m_capacity = threadCount * 16;
+
+	m_splitter->start();
+	for (int i = 0; i < threadCount; i++)
+	{
+		WorkerThread* worker = new WorkerThread(this);
+		m_workers.append(worker);
+		worker->start();
+	}
+}
+
+ParallelPgnReader::~ParallelPgnReader()
+{
+	m_mutex.lock();
+	m_stopping = true;
+	m_jobAdded.wakeAll();
+	m_jobDone.wakeAll();
+	m_jobTaken.wakeAll();
+	m_mutex.unlock();
+
+	m_splitter->wait();
+	delete m_splitter;
+	foreach (WorkerThread* worker, m_workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+
+	qDeleteAll(m_jobs);
+}
+
+int ParallelPgnReader::threadCount() const
+{
+	return m_workers.size();
+}
+
+qint64 ParallelPgnReader::pos() const
+{
+	return m_pos;
+}
+
+qint64 ParallelPgnReader::lineNumber() const
+{
+	return m_lineNumber;
+}
+
+void ParallelPgnReader::split()
+{
+	forever
+	{
+		m_mutex.lock();
+		while (m_jobs.size() >= m_capacity && !m_stopping)
+			m_jobTaken.wait(&m_mutex);
+		bool stopping = m_stopping;
+		m_mutex.unlock();
+
+		if (stopping)
+			break;
+		if (!m_in.nextGame())
+		{
+			QMutexLocker locker(&m_mutex);
+			m_endPos = m_in.pos();
+			m_endLineNumber = m_in.lineNumber();
+			break;
+		}
+
+		Job* job = new Job;
+		job->pos = m_in.pos();
+		job->lineNumber = m_in.lineNumber();
+		job->text = m_in.readGameText();
+		job->endPos = m_in.pos();
+		job->endLineNumber = m_in.lineNumber();
+
+		QMutexLocker locker(&m_mutex);
+		m_jobs.enqueue(job);
+		m_pendingJobs.enqueue(job);
+		m_jobAdded.wakeOne();
+	}
+
+	QMutexLocker locker(&m_mutex);
+	m_splitDone = true;
+	m_jobAdded.wakeAll();
+	m_jobDone.wakeAll();
+}
+
+void ParallelPgnReader::work()
+{
+	PgnStream stream(m_variant);
+
+	forever
+	{
+		m_mutex.lock();
+		while (m_pendingJobs.isEmpty() && !m_splitDone && !m_stopping)
+			m_jobAdded.wait(&m_mutex);
+		if (m_pendingJobs.isEmpty() || m_stopping)
+		{
+			m_mutex.unlock();
+			break;
+		}
+		Job* job = m_pendingJobs.dequeue();
+		m_mutex.unlock();
+
+		// Every game starts with the stream's original variant, so
+		// the results don't depend on which worker parses the game.
+		stream.setVariant(m_variant);
+		stream.setString(&job->text, job->pos, job->lineNumber);
+		if (m_content == Games)
+			job->ok = job->game.read(stream, m_maxMoves);
+		else
+			job->ok = job->entry.read(stream);
+		job->text.clear();
+
+		QMutexLocker locker(&m_mutex);
+		job->done = true;
+		m_jobDone.wakeAll();
+	}
+}
+
+ParallelPgnReader::Job* ParallelPgnReader::takeJob()
+{
+	QMutexLocker locker(&m_mutex);
+
+	while (!m_stopping)
+	{
+		if (!m_jobs.isEmpty() && m_jobs.head()->done)
+		{
+			m_jobTaken.wakeOne();
+			return m_jobs.dequeue();
+		}
+		if (m_jobs.isEmpty() && m_splitDone)
+		{
+			// Every game was read, so the rest of the stream
+			// is just whitespace or comments
+			if (m_endPos != -1 && !m_readFailed)
+			{
+				m_pos = m_endPos;
+				m_lineNumber = m_endLineNumber;
+			}
+			break;
+		}
+		m_jobDone.wait(&m_mutex);
+	}
+
+	return 0;
+}
+
+bool ParallelPgnReader::readGame(PgnGame& game)
+{
+	Q_ASSERT(m_content == Games);
+
+	Job* job = takeJob();
+	if (job == 0)
+	{
+		game = PgnGame();
+		return false;
+	}
+
+	bool ok = job->ok;
+	game = job->game;
+	if (ok)
+	{
+		m_pos = job->endPos;
+		m_lineNumber = job->endLineNumber;
+	}
+	else
+		m_readFailed = true;
+	delete job;
+
+	return ok;
+}
+
+bool ParallelPgnReader::readEntry(PgnGameEntry& entry)
+{
+	Q_ASSERT(m_content == GameEntries);
+
+	Job* job = takeJob();
+	if (job == 0)
+		return false;
+
+	bool ok = job->ok;
+	entry = job->entry;
+	if (ok)
+	{
+		m_pos = job->endPos;
+		m_lineNumber = job->endLineNumber;
+	}
+	else
+		m_readFailed = true;
+	delete job;
+
+	return ok;
+}
@@ -0,0 +1,146 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PARALLELPGNREADER_H
+#define PARALLELPGNREADER_H
+
+#include <climits>
+#include <QString>
+#include <QQueue>
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+class PgnStream;
+class PgnGame;
+class PgnGameEntry;
+
+
+/*!
+ * \brief A class for reading PGN games in multiple threads.
+ *
+ * ParallelPgnReader reads games from a PGN stream in three stages:
+ * - One thread splits the stream into games without parsing the moves
+ * - Worker threads parse the games. Each worker has its own board
+ *   object for validating the moves.
+ * - The parsed games are returned by readGame() or readEntry() in
+ *   the same order as they appear in the stream.
+ *
+ * The number of games that are read ahead is limited, so memory
+ * usage stays bounded no matter how large the stream is.
+ *
+ * The PGN stream must not be used by anyone else while the reader
+ * exists.
+ *
+ * \sa PgnStream, PgnGame, PgnGameEntry
+ */
+class LIB_EXPORT ParallelPgnReader
+{
+	public:
+		/*! The type of data that is read from each game. */
+		enum Content
+		{
+			Games,		//!< Complete games, read with readGame()
+			GameEntries	//!< Game entries, read with readEntry()
+		};
+
+		/*!
+		 * Creates a new reader for \a in and starts reading.
+		 *
+		 * \a content is the type of data that is read from each game.
+		 * At most \a maxMoves moves are read from each game.
+		 * \a threadCount is the number of worker threads; if it's
+		 * zero or less, QThread::idealThreadCount() is used.
+		 */
+		explicit ParallelPgnReader(PgnStream& in,
+					   Content content = Games,
+					   int maxMoves = INT_MAX - 1,
+					   int threadCount = 0);
+		/*!
+		 * Destroys the reader.
+		 *
+		 * Reading is stopped, and any games that weren't read are
+		 * discarded.
+		 */
+		~ParallelPgnReader();
+
+		/*! Returns the number of worker threads. */
+		int threadCount() const;
+		/*!
+		 * Returns the stream position just after the last game
+		 * that was read successfully.
+		 *
+		 * The stream itself is usually further ahead because the
+		 * games are read ahead of time. If no games have been
+		 * read, the starting position of the stream is returned.
+		 * Once every game up to the end of the stream has been
+		 * read without errors, the end of the stream is returned,
+		 * so that any whitespace after the last game is included.
+		 */
+		qint64 pos() const;
+		/*!
+		 * Returns the line number that corresponds to pos().
+		 */
+		qint64 lineNumber() const;
+
+		/*!
+		 * Reads the next game into \a game.
+		 *
+		 * Returns false if there are no more games, or if the game
+		 * could not be read. The reader must have been created
+		 * with the Games content type.
+		 */
+		bool readGame(PgnGame& game);
+		/*!
+		 * Reads the next game entry into \a entry.
+		 *
+		 * Returns false if there are no more games. The reader must
+		 * have been created with the GameEntries content type.
+		 */
+		bool readEntry(PgnGameEntry& entry);
+
+	private:
+		struct Job;
+		class SplitterThread;
+		class WorkerThread;
+
+		void split();
+		void work();
+		Job* takeJob();
+
+		PgnStream& m_in;
+		Content m_content;
+		int m_maxMoves;
+		int m_capacity;
+		QString m_variant;
+		qint64 m_pos;
+		qint64 m_lineNumber;
+		qint64 m_endPos;
+		qint64 m_endLineNumber;
+		bool m_readFailed;
+		bool m_splitDone;
+		bool m_stopping;
+		QQueue<Job*> m_jobs;
+		QQueue<Job*> m_pendingJobs;
+		QMutex m_mutex;
+		QWaitCondition m_jobAdded;
+		QWaitCondition m_jobDone;
+		QWaitCondition m_jobTaken;
+		SplitterThread* m_splitter;
+		QList<WorkerThread*> m_workers;
+};
+
+#endif // PARALLELPGNREADER_H
@@ -19,14 +19,12 @@
 #include <QStringList>
 #include <QFile>
 #include <QMetaObject>
-#include <QProcess>
 #include <QTextCodec>
+#include <QtCore/qmath.h>
 #include "board/boardfactory.h"
 #include "econode.h"
 #include "pgnstream.h"
 
-static QProcess *s_pxt = NULL;
-
 PgnStream& operator>>(PgnStream& in, PgnGame& game)
 {
 	game.read(in);
@@ -39,10 +37,93 @@ QTextStream& operator<<(QTextStream& out, const PgnGame& game)
 	return out;
 }
 
+// Formats \a msecs as "hh:mm:ss"
+static QString clockString(int msecs)
+{
+	if (msecs == 0)
+		return "00:00:00";
+
+	int total = qFloor(msecs / 1000.);
+	int hours = qFloor(total / 3600.) % 24;
+	int minutes = (total / 60) % 60;
+	int seconds = total % 60;
+
+	return QString::number(hours).rightJustified(2, '0') + ":" +
+	       QString::number(minutes).rightJustified(2, '0') + ":" +
+	       QString::number(seconds).rightJustified(2, '0');
+}
+
+static QString annotationString(const PgnGame::MoveAnnotation& annotation,
+				Chess::Side side)
+{
+	QString sScore;
+	if (annotation.depth > 0)
+	{
+		int score = annotation.score;
+		int absScore = qAbs(score);
+
+		// Detect mate-in-n scores
+		if (absScore > 9900
+		&&  (absScore = 1000 - (absScore % 1000)) < 100)
+		{
+			if (score < 0)
+				sScore = "-";
+			sScore += "M" + QString::number(absScore);
+		}
+		else
+			sScore = QString::number(double(score) / 100.0, 'f', 2);
+	}
+	else
+		sScore = "0.00";
+
+	QString str("d=");
+	if (annotation.depth > 0)
+		str += QString::number(annotation.depth);
+	else
+		str += "1";
+
+	// Ponder move
+	const QString pv(QString::fromUtf8(annotation.pv.constData(),
+					   annotation.pv.size()));
+	int ponder = pv.indexOf(' ') + 1;
+	if (ponder > 0)
+		str += ", pd=" + pv.mid(ponder, pv.indexOf(' ', ponder) - ponder);
+
+	str += ", mt=" + clockString(annotation.time);
+	str += ", tl=" + clockString(annotation.timeLeft);
+	str += ", s=" + QString::number(qFloor(annotation.nps / 1000)) + " kN/s";
+	str += ", n=" + QString::number(annotation.nodeCount);
+	str += ", pv=" + pv;
+	str += ", tb=" + QString::number(annotation.tbHits);
+
+	if (annotation.reversibleMoveCount >= 0)
+	{
+		int r50 = qFloor(((100 - annotation.reversibleMoveCount) / 2.) + 0.5);
+		str += ", R50=" + QString::number(r50);
+	}
+
+	// Score from white's point of view
+	str += ", wv=";
+	if (side == Chess::Side::Black && sScore != "0.00")
+	{
+		if (sScore[0] == '-')
+			str += sScore.right(sScore.length() - 1);
+		else
+			str += "-" + sScore;
+	}
+	else
+		str += sScore;
+
+	str += ",";
+	return str;
+}
+
 PgnGame::PgnGame()
 	: m_startingSide(Chess::Side::White),
 	  m_tagReceiver(0),
-	  m_wantsEcoClassification(false)
+	  m_wantsEcoClassification(false),
+	  m_isEcoClassified(false),
+	  m_ecoNode(0)
 {
 }
 
@@ -56,6 +137,8 @@ void PgnGame::clear()
 	m_startingSide = Chess::Side();
 	m_tags.clear();
 	m_moves.clear();
+	m_isEcoClassified = false;
+	m_ecoNode = 0;
 }
 
 QList< QPair<QString, QString> > PgnGame::tags() const
@@ -94,56 +177,75 @@ const QVector<PgnGame::MoveData>& PgnGame::moves() const
 
 void PgnGame::classifyEco()
 {
-	QString pgnText;
-
-	if (!s_pxt || s_pxt->state() == QProcess::NotRunning) {
-	    QString program = "./pgn-extract";
-	#ifdef _WIN32
-		program += ".exe";
-	#endif
-
-	    QStringList arguments;
-	    arguments
-			<< "-e"
-			<< "-s";
-			// << "-l_pxtlog.txt"
-			// << "-o_pxtmpo.pgn"
-			// << "_pxtmpi.pgn";
-
-		if (!s_pxt)
-			s_pxt = new QProcess();
-	    s_pxt->start(program, arguments);
-		s_pxt->waitForStarted();
-	}
+	m_isEcoClassified = isStandard();
+	m_ecoNode = m_isEcoClassified ? EcoNode::root() : 0;
+	if (!m_isEcoClassified)
+		return;
 
-	QTextStream outstream(&pgnText);
-	write(outstream);
-	outstream.flush();
+	for (int i = 0; i < m_moves.size() && i <= ECO_PLIES; i++)
+		advanceEco(m_moves.at(i), i);
+}
 
-	QByteArray pgnData = pgnText.toLocal8Bit();
-	s_pxt->write(pgnData);
+void PgnGame::setEcoTags(const EcoNode* node)
+{
+	setTag("ECO", node->ecoCode());
+	setTag("Opening", node->opening());
+	setTag("Variation", node->variation());
+}
 
-	s_pxt->waitForReadyRead();
-	pgnData = s_pxt->readAllStandardOutput();
+void PgnGame::advanceEco(const MoveData& data, int ply)
+{
+	Q_ASSERT(m_isEcoClassified);
 
-	PgnStream pgnStream(&pgnData);
-	PgnGame pgnGame;
-	pgnGame.read(pgnStream);
+	// The game has left the ECO tree, but it may have transposed
+	// into a known line. The key of the position after a move is
+	// known only when the next move is added.
+	if (m_ecoNode == 0)
+	{
+		m_ecoNode = EcoNode::findPosition(data.key);
+		if (m_ecoNode == 0)
+			return;
+		if (m_ecoNode->isLeaf())
+			setEcoTags(m_ecoNode);
+	}
+	if (ply >= ECO_PLIES)
+		return;
 
-	QString val;
-	val = pgnGame.tagValue("ECO");
-	if (!val.isEmpty()) setTag("ECO", val);
-	val = pgnGame.tagValue("Opening");
-	if (!val.isEmpty()) setTag("Opening", val);
-	val = pgnGame.tagValue("Variation");
-	if (!val.isEmpty()) setTag("Variation", val);
+	m_ecoNode = m_ecoNode->child(data.moveString);
+	if (m_ecoNode != 0 && m_ecoNode->isLeaf())
+		setEcoTags(m_ecoNode);
 }
 
 void PgnGame::addMove(const MoveData& data)
 {
 	m_moves.append(data);
-	if (m_wantsEcoClassification && m_moves.size() <= ECO_PLIES)
-		classifyEco();
+	if (!m_wantsEcoClassification || m_moves.size() > ECO_PLIES + 1)
+		return;
+
+	// The ECO cursor starts from the root when the first move is
+	// added; games from a custom position are never classified.
+	if (m_moves.size() == 1)
+	{
+		m_isEcoClassified = isStandard();
+		m_ecoNode = m_isEcoClassified ? EcoNode::root() : 0;
+	}
+	if (m_isEcoClassified)
+		advanceEco(data, m_moves.size() - 1);
+}
+
+QString PgnGame::moveComment(int index) const
+{
+	const MoveData& data = m_moves.at(index);
+	if (!data.annotation.isValid)
+		return data.comment;
+
+	Chess::Side side = (index % 2 == 0) ?
+		m_startingSide : m_startingSide.opposite();
+	QString str(annotationString(data.annotation, side));
+	if (!data.comment.isEmpty())
+		str += ", " + data.comment;
+
+	return str;
 }
 
 void PgnGame::setWantsEcoClassification(bool wants)
@@ -310,6 +412,15 @@ static void writeTag(QTextStream& out, const QString& tag, const QString& value)
 }
 
 void PgnGame::write(QTextStream& out, PgnMode mode) const
+{
+	if (m_tags.isEmpty())
+		return;
+
+	writeHeader(out, mode);
+	writeResult(out, writeMoves(out, mode, 0, 0));
+}
+
+void PgnGame::writeHeader(QTextStream& out, PgnMode mode) const
 {
 	if (m_tags.isEmpty())
 		return;
@@ -325,17 +436,26 @@ void PgnGame::write(QTextStream& out, PgnMode mode) const
 		writeTag(out, "SetUp", m_tags["SetUp"]);
 	}
 
+	if (!m_gameComment.isEmpty())
+		out << "\n" << QString("{ %1 }").arg(m_gameComment);
+}
+
+int PgnGame::writeMoves(QTextStream& out,
+			PgnMode mode,
+			int first,
+			int lineLength) const
+{
 	QString str;
-	int lineLength = 0;
+	int side = (first % 2 == 0) ? int(m_startingSide) : !m_startingSide;
 	int movenum = 0;
-	int side = m_startingSide;
 
-	if (!m_gameComment.isEmpty()) {
-		str = QString("{ %1 }").arg(m_gameComment);
-		out << "\n" << str;
-	}
+	// Number of the last move that was written
+	if (first > 0 && m_startingSide == Chess::Side::White)
+		movenum = (first + 1) / 2;
+	else if (first > 0)
+		movenum = first / 2 + 1;
 
-	for (int i = 0; i < m_moves.size(); i++)
+	for (int i = first; i < m_moves.size(); i++)
 	{
 		const MoveData& data = m_moves.at(i);
 
@@ -346,8 +466,12 @@ void PgnGame::write(QTextStream& out, PgnMode mode) const
 			str = QString::number(++movenum) + ". ";
 
 		str += data.moveString;
-		if (mode == Verbose && !data.comment.isEmpty())
-			str += QString(" { %1 }").arg(data.comment);
+		if (mode == Verbose)
+		{
+			const QString comment(moveComment(i));
+			if (!comment.isEmpty())
+				str += QString(" { %1 }").arg(comment);
+		}
 
 		// Limit the lines to 80 characters
 		if (lineLength == 0 || lineLength + str.size() >= 80)
@@ -363,7 +487,13 @@ void PgnGame::write(QTextStream& out, PgnMode mode) const
 
 		side = !side;
 	}
-	str = m_tags.value("Result");
+
+	return lineLength;
+}
+
+void PgnGame::writeResult(QTextStream& out, int lineLength) const
+{
+	const QString str = m_tags.value("Result");
 	if (lineLength + str.size() >= 80)
 		out << "\n" << str << "\n\n";
 	else
@@ -447,6 +577,11 @@ QString PgnGame::startingFenString() const
 	return m_tags.value("FEN");
 }
 
+QString PgnGame::gameComment() const
+{
+	return m_gameComment;
+}
+
 void PgnGame::setTag(const QString& tag, const QString& value)
 {
 	if (value.isEmpty())
@@ -60,6 +60,53 @@ class LIB_EXPORT PgnGame
 			Verbose
 		};
 
+		/*!
+		 * \brief Search information about an engine's move.
+		 *
+		 * The annotation is kept in numeric form and formatted into
+		 * the move's comment only when the game is written.
+		 */
+		struct MoveAnnotation
+		{
+			/*! Creates an empty annotation. */
+			MoveAnnotation()
+				: isValid(false),
+				  reversibleMoveCount(-1),
+				  depth(0),
+				  score(0),
+				  time(0),
+				  timeLeft(0),
+				  nps(0),
+				  tbHits(0),
+				  nodeCount(0)
+			{
+			}
+
+			/*! Is the annotation in use? */
+			bool isValid;
+			/*!
+			 * The number of reversible moves before the move,
+			 * or -1 if the variant doesn't have a 50-move rule.
+			 */
+			qint16 reversibleMoveCount;
+			/*! The search depth in plies. */
+			qint32 depth;
+			/*! The score in centipawns from the mover's point of view. */
+			qint32 score;
+			/*! The move time in milliseconds. */
+			qint32 time;
+			/*! The time left on the mover's clock in milliseconds. */
+			qint32 timeLeft;
+			/*! The nodes per second. */
+			qint32 nps;
+			/*! The number of tablebase hits. */
+			qint32 tbHits;
+			/*! The number of nodes searched. */
+			quint64 nodeCount;
+			/*! The principal variation as space-separated SAN moves. */
+			QByteArray pv;
+		};
+
 		/*! \brief A struct for storing the game's move history. */
 		struct MoveData
 		{
@@ -69,8 +116,13 @@ class LIB_EXPORT PgnGame
 			Chess::GenericMove move;
 			/*! The move in Standard Algebraic Notation. */
 			QString moveString;
-			/*! A comment/annotation describing the move. */
+			/*!
+			 * A comment describing the move.
+			 * \sa PgnGame::moveComment()
+			 */
 			QString comment;
+			/*! The engine's search information for the move. */
+			MoveAnnotation annotation;
 		};
 
 		/*! Creates a new PgnGame object. */
@@ -86,6 +138,13 @@ class LIB_EXPORT PgnGame
 		const QVector<MoveData>& moves() const;
 		/*! Adds a new move to the game. */
 		void addMove(const MoveData& data);
+		/*!
+		 * Returns the full comment of the move at \a index.
+		 *
+		 * This is the formatted annotation of the move followed by
+		 * its comment, as written to the PGN file.
+		 */
+		QString moveComment(int index) const;
 
 		/*!
 		 * Creates a board object for viewing or analyzing the game.
@@ -109,6 +168,32 @@ class LIB_EXPORT PgnGame
 		bool read(PgnStream& in, int maxMoves = INT_MAX - 1);
 		/*! Writes the game to a text stream. */
 		void write(QTextStream& out, PgnMode mode = Verbose) const;
+		/*!
+		 * Writes the tags and the game comment to a text stream.
+		 *
+		 * This is the part of write() that precedes the movetext.
+		 */
+		void writeHeader(QTextStream& out, PgnMode mode = Verbose) const;
+		/*!
+		 * Writes the moves starting from move \a first to a text
+		 * stream.
+		 *
+		 * \a lineLength is the length of the current movetext line,
+		 * and the length of the last line is returned. Together with
+		 * writeHeader() and writeResult() this function can be used
+		 * to write the movetext incrementally, with the same output
+		 * as write().
+		 */
+		int writeMoves(QTextStream& out,
+			       PgnMode mode,
+			       int first,
+			       int lineLength) const;
+		/*!
+		 * Writes the game termination marker to a text stream.
+		 *
+		 * \a lineLength is the length of the current movetext line.
+		 */
+		void writeResult(QTextStream& out, int lineLength) const;
 		/*!
 		 * Writes the game to a file.
 		 * If the file already exists, the game will be appended
@@ -147,6 +232,8 @@ class LIB_EXPORT PgnGame
 		Chess::Side startingSide() const;
 		/*! Returns the starting position's FEN string. */
 		QString startingFenString() const;
+		/*! Returns the comment before the moves begin. */
+		QString gameComment() const;
 
 		/*!
 		 * Sets \a tag's value to \a value.
@@ -194,20 +281,40 @@ class LIB_EXPORT PgnGame
 		 */
 		void setTagReceiver(QObject* receiver);
 
+		/*!
+		 * Enables or disables incremental ECO classification.
+		 *
+		 * If \a wants is true, the "ECO", "Opening" and "Variation"
+		 * tags are updated as new moves are added to the game.
+		 */
 		void setWantsEcoClassification(bool wants);
-		/*! Use pgn-extract to derive ECO info for this game */
+		/*!
+		 * Derives ECO info for this game from its current moves
+		 * by walking the ECO tree.
+		 *
+		 * If the moves leave the tree, the positions of the game
+		 * are looked up instead, so that transpositions into a
+		 * known line are classified by the position.
+		 *
+		 * \note Only standard games from the default starting
+		 * position can be classified.
+		 */
 		void classifyEco();
 		/*! Returns the ECO information for this game, if available */
 		const struct EcoInfo eco() const;
 
 	private:
 		bool parseMove(PgnStream& in);
+		void advanceEco(const MoveData& data, int ply);
+		void setEcoTags(const EcoNode* node);
 
 		Chess::Side m_startingSide;
 		QMap<QString, QString> m_tags;
 		QVector<MoveData> m_moves;
 		QObject* m_tagReceiver;
 		bool m_wantsEcoClassification;
+		bool m_isEcoClassified;
+		const EcoNode* m_ecoNode;
 		QString m_gameComment;
 };
 
@@ -0,0 +1,272 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pgnindex.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QCryptographicHash>
+#if QT_VERSION >= 0x050100
+#include <QSaveFile>
+#else
+#include <QTemporaryFile>
+#endif
+#include "pgnstream.h"
+#include "pgngameentry.h"
+#include "parallelpgnreader.h"
+
+namespace {
+
+const quint32 s_indexMagic = 0x43434958;	// "CCIX"
+const quint32 s_indexVersion = 1;
+
+// Number of bytes at both ends of the indexed part of the PGN file
+// that are used to check that the file has only been appended to.
+const qint64 s_checksumSize = 4096;
+
+} // anonymous namespace
+
+PgnIndex::PgnIndex(const QString& fileName)
+	: m_fileName(fileName),
+	  m_scanPos(0),
+	  m_scanLineNumber(1),
+	  m_modified(false)
+{
+}
+
+PgnIndex::~PgnIndex()
+{
+	qDeleteAll(m_entries);
+}
+
+QString PgnIndex::fileName() const
+{
+	return m_fileName;
+}
+
+QString PgnIndex::indexFileName() const
+{
+	return m_fileName + ".cidx";
+}
+
+void PgnIndex::clear()
+{
+	qDeleteAll(m_entries);
+	m_entries.clear();
+	m_scanPos = 0;
+	m_scanLineNumber = 1;
+	m_modified = true;
+}
+
+QByteArray PgnIndex::checksum(qint64 size) const
+{
+	QFile file(m_fileName);
+	if (!file.open(QIODevice::ReadOnly))
+		return QByteArray();
+
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	hash.addData(file.read(qMin(size, s_checksumSize)));
+	if (!file.seek(qMax(qint64(0), size - s_checksumSize)))
+		return QByteArray();
+	hash.addData(file.read(qMin(size, s_checksumSize)));
+
+	return hash.result();
+}
+
+bool PgnIndex::load()
+{
+	clear();
+
+	QFile indexFile(indexFileName());
+	if (!indexFile.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream in(&indexFile);
+	in.setVersion(QDataStream::Qt_4_6);
+
+	quint32 magic = 0;
+	quint32 version = 0;
+	in >> magic >> version;
+	if (magic != s_indexMagic || version != s_indexVersion)
+		return false;
+
+	qint64 size = 0;
+	qint64 lineNumber = 1;
+	QDateTime lastModified;
+	QByteArray sum;
+	qint32 count = 0;
+	in >> size >> lineNumber >> lastModified >> sum >> count;
+	if (in.status() != QDataStream::Ok || count < 0)
+		return false;
+
+	QFileInfo fileInfo(m_fileName);
+	bool upToDate = (fileInfo.size() == size
+			 && fileInfo.lastModified() == lastModified);
+	if (!upToDate
+	&&  (fileInfo.size() <= size || checksum(size) != sum))
+		return false;
+
+	for (int i = 0; i < count; i++)
+	{
+		PgnGameEntry* entry = new PgnGameEntry;
+		if (!entry->read(in))
+		{
+			delete entry;
+			clear();
+			return false;
+		}
+		m_entries.append(entry);
+	}
+
+	m_modified = false;
+	if (upToDate)
+	{
+		m_scanPos = size;
+		m_scanLineNumber = lineNumber;
+	}
+	else if (!m_entries.isEmpty())
+	{
+		// The last game may have been incomplete when it was
+		// indexed, so it's read again.
+		const PgnGameEntry* last = m_entries.takeLast();
+		m_scanPos = last->pos();
+		m_scanLineNumber = last->lineNumber();
+		delete last;
+		m_modified = true;
+	}
+
+	return true;
+}
+
+bool PgnIndex::save(qint64 size, qint64 lineNumber)
+{
+	QFileInfo fileInfo(m_fileName);
+
+	// Replace the old index only when the new one is complete
+#if QT_VERSION >= 0x050100
+	QSaveFile indexFile(indexFileName());
+	if (!indexFile.open(QIODevice::WriteOnly))
+		return false;
+#else
+	// Concurrent writers each get their own temporary file
+	QTemporaryFile indexFile(indexFileName() + ".XXXXXX");
+	if (!indexFile.open())
+		return false;
+#endif
+
+	QDataStream out(&indexFile);
+	out.setVersion(QDataStream::Qt_4_6);
+
+	out << s_indexMagic << s_indexVersion;
+	out << size << lineNumber << fileInfo.lastModified() << checksum(size);
+	out << qint32(m_entries.size());
+	foreach (const PgnGameEntry* entry, m_entries)
+		entry->write(out);
+
+	if (out.status() != QDataStream::Ok)
+		return false;
+#if QT_VERSION >= 0x050100
+	if (!indexFile.commit())
+		return false;
+#else
+	indexFile.close();
+	if (indexFile.error() != QFile::NoError)
+		return false;
+	QFile::remove(indexFileName());
+	if (!indexFile.rename(indexFileName()))
+		return false;
+	indexFile.setAutoRemove(false);
+#endif
+
+	m_modified = false;
+	return true;
+}
+
+bool PgnIndex::update()
+{
+	load();
+
+	QFile file(m_fileName);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	if (m_scanPos >= file.size())
+		return true;
+
+	PgnStream stream(&file);
+	if (!stream.seek(m_scanPos, m_scanLineNumber))
+		return false;
+
+	// The reader reads ahead, so the stream may already be past
+	// the last game that was indexed
+	qint64 pos;
+	qint64 lineNumber;
+	{
+		ParallelPgnReader reader(stream, ParallelPgnReader::GameEntries);
+		forever
+		{
+			PgnGameEntry* entry = new PgnGameEntry;
+			if (!reader.readEntry(*entry))
+			{
+				delete entry;
+				break;
+			}
+			addEntry(entry);
+		}
+		pos = reader.pos();
+		lineNumber = reader.lineNumber();
+	}
+
+	if (m_modified)
+		save(pos, lineNumber);
+	return true;
+}
+
+qint64 PgnIndex::scanPos() const
+{
+	return m_scanPos;
+}
+
+qint64 PgnIndex::scanLineNumber() const
+{
+	return m_scanLineNumber;
+}
+
+int PgnIndex::count() const
+{
+	return m_entries.size();
+}
+
+const PgnGameEntry* PgnIndex::entry(int index) const
+{
+	return m_entries.at(index);
+}
+
+void PgnIndex::addEntry(PgnGameEntry* entry)
+{
+	Q_ASSERT(entry != 0);
+
+	m_entries.append(entry);
+	m_modified = true;
+}
+
+QList<const PgnGameEntry*> PgnIndex::takeEntries()
+{
+	QList<const PgnGameEntry*> entries(m_entries);
+	m_entries.clear();
+
+	return entries;
+}
@@ -0,0 +1,119 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PGNINDEX_H
+#define PGNINDEX_H
+
+#include <QString>
+#include <QList>
+#include <QDateTime>
+class PgnGameEntry;
+
+
+/*!
+ * \brief A persistent index of the games in a PGN file.
+ *
+ * PgnIndex keeps the stream position, line number and the seven-tag
+ * roster of every game in a PGN file in a binary index file next
+ * to the PGN file. The index file is validated by the size and the
+ * modification time of the PGN file. If games have been appended to
+ * the PGN file since the index was written, only the new games have
+ * to be read.
+ *
+ * \sa PgnGameEntry
+ */
+class LIB_EXPORT PgnIndex
+{
+	public:
+		/*! Creates a new empty index for PGN file \a fileName. */
+		explicit PgnIndex(const QString& fileName);
+		/*! Destroys the index and its entries. */
+		~PgnIndex();
+
+		/*! Returns the name of the PGN file. */
+		QString fileName() const;
+		/*! Returns the name of the index file. */
+		QString indexFileName() const;
+
+		/*!
+		 * Reads the index file.
+		 *
+		 * Returns true if the index file matches the PGN file, or if
+		 * games have only been appended to the PGN file. In the latter
+		 * case the games that start at scanPos() still have to be read
+		 * and added with addEntry().
+		 *
+		 * Returns false if there's no valid index file. The index is
+		 * then empty and the whole PGN file has to be read.
+		 */
+		bool load();
+		/*!
+		 * Writes the index file.
+		 *
+		 * \a size is the number of bytes of the PGN file that have
+		 * been indexed, and \a lineNumber is the line number at
+		 * position \a size.
+		 *
+		 * Returns true if successful; otherwise returns false.
+		 */
+		bool save(qint64 size, qint64 lineNumber);
+		/*!
+		 * Brings the index up to date with the PGN file.
+		 *
+		 * This function loads the index file, reads the games that
+		 * aren't indexed yet, and writes the index file if it
+		 * changed. Returns false if the PGN file can't be read.
+		 */
+		bool update();
+
+		/*!
+		 * Returns the stream position of the first game that isn't
+		 * in the index.
+		 */
+		qint64 scanPos() const;
+		/*! Returns the line number at scanPos(). */
+		qint64 scanLineNumber() const;
+
+		/*! Returns the number of games in the index. */
+		int count() const;
+		/*! Returns the entry of game \a index. */
+		const PgnGameEntry* entry(int index) const;
+		/*!
+		 * Appends \a entry to the index.
+		 *
+		 * The index takes ownership of \a entry.
+		 */
+		void addEntry(PgnGameEntry* entry);
+		/*!
+		 * Returns the entries and empties the index.
+		 *
+		 * The caller takes ownership of the entries.
+		 */
+		QList<const PgnGameEntry*> takeEntries();
+
+	private:
+		QByteArray checksum(qint64 size) const;
+		void clear();
+
+		QString m_fileName;
+		qint64 m_scanPos;
+		qint64 m_scanLineNumber;
+		bool m_modified;
+		QList<const PgnGameEntry*> m_entries;
+};
+
+#endif // PGNINDEX_H
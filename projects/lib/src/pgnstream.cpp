@@ -18,32 +18,35 @@
 #include "pgnstream.h"
 #include <cctype>
 #include <cstring>
-#include <QIODevice>
+#include <QFile>
 #include "board/boardfactory.h"
 
 
+namespace {
+
+const int s_blockSize = 1024 * 1024;
+
+} // anonymous namespace
+
 PgnStream::PgnStream(const QString& variant)
 	: m_board(0),
-	  m_pos(0),
-	  m_lineNumber(1),
-	  m_tokenType(NoToken),
-	  m_device(0),
-	  m_string(0),
-	  m_status(Ok),
-	  m_phase(OutOfGame)
+	  m_readMode(BlockRead)
 {
+	reset();
 	setVariant(variant);
 }
 
 PgnStream::PgnStream(QIODevice* device, const QString& variant)
-	: m_board(0)
+	: m_board(0),
+	  m_readMode(BlockRead)
 {
 	setVariant(variant);
 	setDevice(device);
 }
 
 PgnStream::PgnStream(const QByteArray* string, const QString& variant)
-	: m_board(0)
+	: m_board(0),
+	  m_readMode(BlockRead)
 {
 	setVariant(variant);
 	setString(string);
@@ -51,12 +54,20 @@ PgnStream::PgnStream(const QByteArray* string, const QString& variant)
 
 PgnStream::~PgnStream()
 {
+	unmap();
 	delete m_board;
 }
 
 void PgnStream::reset()
 {
-	m_pos = 0;
+	unmap();
+
+	m_data = 0;
+	m_dataSize = 0;
+	m_dataPos = 0;
+	m_readPos = 0;
+	m_buffer.clear();
+	m_capture = 0;
 	m_lineNumber = 1;
 	m_tokenString.clear();
 	m_tagName.clear();
@@ -68,6 +79,13 @@ void PgnStream::reset()
 	m_phase = OutOfGame;
 }
 
+void PgnStream::unmap()
+{
+	if (m_mappedFile && m_data != 0)
+		m_mappedFile->unmap((uchar*)m_data);
+	m_mappedFile = 0;
+}
+
 Chess::Board* PgnStream::board()
 {
 	return m_board;
@@ -78,12 +96,36 @@ QIODevice* PgnStream::device() const
 	return m_device;
 }
 
-void PgnStream::setDevice(QIODevice* device)
+void PgnStream::setDevice(QIODevice* device, ReadMode mode)
 {
 	Q_ASSERT(device != 0);
 
 	reset();
 	m_device = device;
+	m_readMode = BlockRead;
+	if (!device->isSequential())
+		m_dataPos = device->pos();
+
+	QFile* file = qobject_cast<QFile*>(device);
+	if (mode == MappedRead && file != 0 && file->size() > 0)
+	{
+		uchar* data = file->map(0, file->size());
+		if (data != 0)
+		{
+			m_mappedFile = file;
+			m_readMode = MappedRead;
+			m_data = (const char*)data;
+			m_dataSize = file->size();
+			m_readPos = m_dataPos;
+			m_dataPos = 0;
+			return;
+		}
+	}
+
+	// The stream handles CR LF line endings by itself, and text mode
+	// translation would make the buffer offsets differ from the
+	// device positions.
+	device->setTextModeEnabled(false);
 }
 
 const QByteArray* PgnStream::string() const
@@ -91,11 +133,24 @@ const QByteArray* PgnStream::string() const
 	return m_string;
 }
 
-void PgnStream::setString(const QByteArray* string)
+void PgnStream::setString(const QByteArray* string,
+			  qint64 pos,
+			  qint64 lineNumber)
 {
 	Q_ASSERT(string != 0);
+	Q_ASSERT(pos >= 0);
+
 	reset();
 	m_string = string;
+	m_data = string->constData();
+	m_dataSize = string->size();
+	m_dataPos = pos;
+	m_lineNumber = lineNumber;
+}
+
+PgnStream::ReadMode PgnStream::readMode() const
+{
+	return m_readMode;
 }
 
 QString PgnStream::variant() const
@@ -125,9 +180,7 @@ bool PgnStream::isOpen() const
 
 qint64 PgnStream::pos() const
 {
-	if (m_device)
-		return m_device->pos();
-	return m_pos;
+	return m_dataPos + m_readPos;
 }
 
 qint64 PgnStream::lineNumber() const
@@ -135,30 +188,46 @@ qint64 PgnStream::lineNumber() const
 	return m_lineNumber;
 }
 
-char PgnStream::readChar()
+bool PgnStream::fillBuffer()
 {
-	char c;
-	if (m_device)
-	{
-		if (!m_device->getChar(&m_lastChar))
-		{
-			m_status = ReadPastEnd;
-			return 0;
-		}
-		c = m_lastChar;
-	}
-	else if (m_string && m_pos < m_string->size())
+	if (m_device == 0 || m_mappedFile)
+		return false;
+
+	// Keep the last character of the previous block in the buffer
+	// so that rewindChar() works across block boundaries.
+	int keep = 0;
+	if (m_dataSize > 0)
 	{
-		c = m_string->at(m_pos++);
+		m_buffer[0] = m_data[m_dataSize - 1];
+		m_dataPos += m_dataSize - 1;
+		keep = 1;
 	}
-	else
+	m_buffer.resize(keep + s_blockSize);
+	m_data = m_buffer.constData();
+	m_dataSize = keep;
+	m_readPos = keep;
+
+	qint64 n = m_device->read(m_buffer.data() + keep, s_blockSize);
+	if (n <= 0)
+		return false;
+
+	m_dataSize += n;
+	return true;
+}
+
+char PgnStream::readChar()
+{
+	if (m_readPos >= m_dataSize && !fillBuffer())
 	{
 		m_status = ReadPastEnd;
 		return 0;
 	}
 
+	char c = m_data[m_readPos++];
 	if (c == '\n')
 		m_lineNumber++;
+	if (m_capture != 0)
+		m_capture->append(c);
 
 	return c;
 }
@@ -170,22 +239,14 @@ void PgnStream::rewind()
 
 void PgnStream::rewindChar()
 {
-	Q_ASSERT(pos() > 0);
-
-	char c;
-	if (m_device)
-	{
-		c = m_lastChar;
-		m_device->ungetChar(m_lastChar);
-		m_lastChar = 0;
-	}
-	else if (m_string)
-		c = m_string->at(m_pos--);
-	else
+	Q_ASSERT(m_readPos > 0);
+	if (m_readPos <= 0)
 		return;
 
-	if (c == '\n')
+	if (m_data[--m_readPos] == '\n')
 		m_lineNumber--;
+	if (m_capture != 0)
+		m_capture->chop(1);
 }
 
 bool PgnStream::seek(qint64 pos, qint64 lineNumber)
@@ -193,23 +254,37 @@ bool PgnStream::seek(qint64 pos, qint64 lineNumber)
 	if (pos < 0)
 		return false;
 
-	bool ok = false;
-	if (m_device)
+	if (m_string)
 	{
-		ok = m_device->seek(pos);
-		m_pos = 0;
+		if (pos < m_dataPos || pos >= m_dataPos + m_dataSize)
+			return false;
+		m_readPos = pos - m_dataPos;
 	}
-	else if (m_string)
+	else if (m_mappedFile)
 	{
-		ok = pos < m_string->size();
-		m_pos = pos;
+		if (pos > m_dataSize)
+			return false;
+		m_readPos = pos;
 	}
-	if (!ok)
+	else if (m_device)
+	{
+		// Seek inside the buffer if possible
+		if (pos >= m_dataPos && pos <= m_dataPos + m_dataSize)
+			m_readPos = pos - m_dataPos;
+		else
+		{
+			if (!m_device->seek(pos))
+				return false;
+			m_dataPos = pos;
+			m_dataSize = 0;
+			m_readPos = 0;
+		}
+	}
+	else
 		return false;
 
 	m_status = Ok;
 	m_lineNumber = lineNumber;
-	m_lastChar = 0;
 	m_phase = OutOfGame;
 
 	return true;
@@ -362,6 +437,20 @@ bool PgnStream::nextGame()
 	return false;
 }
 
+QByteArray PgnStream::readGameText()
+{
+	QByteArray text;
+	if (m_phase == OutOfGame)
+		return text;
+
+	m_capture = &text;
+	while (readNext() != NoToken)
+		;
+	m_capture = 0;
+
+	return text;
+}
+
 PgnStream::TokenType PgnStream::readNext()
 {
 	if (m_phase == OutOfGame)
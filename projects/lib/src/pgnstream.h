@@ -20,7 +20,9 @@
 
 #include <QtGlobal>
 #include <QString>
+#include <QPointer>
 class QIODevice;
+class QFile;
 namespace Chess { class Board; }
 
 
@@ -35,6 +37,10 @@ namespace Chess { class Board; }
  * be changed at any time, so it's possible to read PGN streams that
  * contain games of multiple variants.
  *
+ * Devices are not read one character at a time. Files are memory-mapped
+ * when possible, and other devices are read in large blocks, so the
+ * stream's position can be ahead of the device's position.
+ *
  * \sa PgnGame
  * \sa OpeningBook
  */
@@ -47,6 +53,17 @@ class LIB_EXPORT PgnStream
 			Ok,         //!< The stream is operating normally.
 			ReadPastEnd //!< The stream has read past the end of the data.
 		};
+		/*! The way the data is read from a device. */
+		enum ReadMode
+		{
+			/*!
+			 * The file is mapped into memory. Devices that can't
+			 * be mapped are read in blocks.
+			 */
+			MappedRead,
+			/*! The device is read in large blocks. */
+			BlockRead
+		};
 		/*! The type of a PGN token. */
 		enum TokenType
 		{
@@ -103,13 +120,34 @@ class LIB_EXPORT PgnStream
 
 		/*! Returns the assigned device, or 0 if no device is in use. */
 		QIODevice* device() const;
-		/*! Sets the current device to \a device. */
-		void setDevice(QIODevice* device);
+		/*!
+		 * Sets the current device to \a device.
+		 *
+		 * Reading starts from the current position of \a device.
+		 * \a mode is the preferred way to read the data.
+		 */
+		void setDevice(QIODevice* device, ReadMode mode = MappedRead);
 
 		/*! Returns the assigned string, or 0 if no string is in use. */
 		const QByteArray* string() const;
-		/*! Sets the current string to \a string. */
-		void setString(const QByteArray* string);
+		/*!
+		 * Sets the current string to \a string.
+		 *
+		 * \a pos and \a lineNumber are the stream position and line
+		 * number of the first character of \a string. They can be
+		 * used when \a string is an excerpt of a larger PGN file.
+		 */
+		void setString(const QByteArray* string,
+			       qint64 pos = 0,
+			       qint64 lineNumber = 1);
+
+		/*!
+		 * Returns the way the current device is read.
+		 *
+		 * This is BlockRead if the device couldn't be mapped into
+		 * memory, even if MappedRead was requested.
+		 */
+		ReadMode readMode() const;
 
 		/*! Returns the chess variant. */
 		QString variant() const;
@@ -138,9 +176,9 @@ class LIB_EXPORT PgnStream
 		 * the next time readChar() is called, nothing is read and the
 		 * buffer character is returned.
 		 *
-		 * \note Only one character is kept in the buffer, so calling
-		 * this method multiple times in a row has the same effect as
-		 * calling it just once.
+		 * \note Only the last character read is guaranteed to be
+		 * available, so this method shouldn't be called multiple
+		 * times in a row.
 		 */
 		void rewindChar();
 		/*!
@@ -168,6 +206,15 @@ class LIB_EXPORT PgnStream
 		 * \sa readNext()
 		 */
 		bool nextGame();
+		/*!
+		 * Reads the rest of the current game without parsing the moves
+		 * and returns it as raw text.
+		 *
+		 * This function should be called after nextGame(). It can be
+		 * used to split a PGN stream into games that are parsed
+		 * elsewhere, eg. in other threads.
+		 */
+		QByteArray readGameText();
 		/*!
 		 * Reads the next token and returns its type.
 		 *
@@ -199,14 +246,22 @@ class LIB_EXPORT PgnStream
 			InGame
 		};
 
+		bool fillBuffer();
+		void unmap();
 		void parseUntil(const char* chars);
 		void parseTag();
 		void parseComment(char opBracket);
 
 		Chess::Board* m_board;
-		qint64 m_pos;
+		const char* m_data;
+		qint64 m_dataSize;
+		qint64 m_dataPos;
+		qint64 m_readPos;
+		QByteArray m_buffer;
+		QPointer<QFile> m_mappedFile;
+		QByteArray* m_capture;
+		ReadMode m_readMode;
 		qint64 m_lineNumber;
-		char m_lastChar;
 		QByteArray m_tokenString;
 		QByteArray m_tagName;
 		QByteArray m_tagValue;
@@ -0,0 +1,142 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pgnwriter.h"
+#include <QTimer>
+#include <QTextStream>
+#include <QTextCodec>
+
+namespace {
+
+const int s_bufferSize = 64 * 1024;
+
+} // anonymous namespace
+
+PgnWriter::PgnWriter(const QString& fileName,
+		     PgnGame::PgnMode mode,
+		     QObject* parent)
+	: QObject(parent),
+	  m_file(fileName),
+	  m_mode(mode),
+	  m_flushTimer(new QTimer(this)),
+	  m_flushInterval(0),
+	  m_reorderWindow(256),
+	  m_nextNumber(1)
+{
+	m_flushTimer->setSingleShot(true);
+	connect(m_flushTimer, SIGNAL(timeout()), this, SLOT(onFlushTimeout()));
+}
+
+PgnWriter::~PgnWriter()
+{
+	if (!flush())
+		qWarning("Can't write to PGN file %s",
+			 qPrintable(m_file.fileName()));
+}
+
+QString PgnWriter::fileName() const
+{
+	return m_file.fileName();
+}
+
+int PgnWriter::flushInterval() const
+{
+	return m_flushInterval;
+}
+
+void PgnWriter::setFlushInterval(int msecs)
+{
+	m_flushInterval = qMax(0, msecs);
+}
+
+int PgnWriter::reorderWindow() const
+{
+	return m_reorderWindow;
+}
+
+void PgnWriter::setReorderWindow(int size)
+{
+	m_reorderWindow = qMax(0, size);
+}
+
+int PgnWriter::nextGameNumber() const
+{
+	return m_nextNumber;
+}
+
+void PgnWriter::setNextGameNumber(int number)
+{
+	m_nextNumber = number;
+	m_pending.clear();
+}
+
+bool PgnWriter::addGame(int number, const PgnGame& game)
+{
+	QByteArray data;
+	QTextStream out(&data, QIODevice::WriteOnly);
+	out.setCodec(QTextCodec::codecForName("latin1"));
+	game.write(out, m_mode);
+	out.flush();
+
+	if (number < m_nextNumber)
+	{
+		// A late game whose place was given up by the reorder window
+		m_buffer.append(data);
+	}
+	else
+	{
+		m_pending.insert(number, data);
+
+		while (!m_pending.isEmpty()
+		&&     (m_pending.constBegin().key() == m_nextNumber
+		||      m_pending.size() > m_reorderWindow))
+		{
+			m_nextNumber = m_pending.constBegin().key() + 1;
+			m_buffer.append(m_pending.take(m_pending.constBegin().key()));
+		}
+	}
+
+	if (m_flushInterval == 0 || m_buffer.size() >= s_bufferSize)
+		return flush();
+	if (!m_buffer.isEmpty() && !m_flushTimer->isActive())
+		m_flushTimer->start(m_flushInterval);
+	return true;
+}
+
+bool PgnWriter::flush()
+{
+	m_flushTimer->stop();
+	if (m_buffer.isEmpty())
+		return true;
+
+	if (!m_file.isOpen()
+	&&  !m_file.open(QIODevice::WriteOnly | QIODevice::Append))
+		return false;
+
+	bool ok = (m_file.write(m_buffer) == m_buffer.size()
+		   && m_file.flush());
+	m_buffer.clear();
+
+	return ok;
+}
+
+void PgnWriter::onFlushTimeout()
+{
+	if (!flush())
+		qWarning("Can't write to PGN file %s",
+			 qPrintable(m_file.fileName()));
+}
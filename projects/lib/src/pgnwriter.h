@@ -0,0 +1,128 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PGNWRITER_H
+#define PGNWRITER_H
+
+#include <QObject>
+#include <QFile>
+#include <QMap>
+#include <QByteArray>
+#include "pgngame.h"
+class QTimer;
+
+
+/*!
+ * \brief A buffered output sink for PGN games.
+ *
+ * PgnWriter keeps its PGN file open for as long as it lives and
+ * collects the formatted games in a buffer which is written to the
+ * file according to a flush policy: after every game (the default),
+ * or at most every N milliseconds.
+ *
+ * The games are numbered, and they're written to the file in order
+ * of their numbers even if they're added in a different order. The
+ * games that arrive too early are kept in a reorder window, as
+ * formatted text. If the window gets full the lowest numbered game in
+ * it is written without waiting for the missing games, which are then
+ * written as soon as they arrive.
+ */
+class LIB_EXPORT PgnWriter : public QObject
+{
+	Q_OBJECT
+
+	public:
+		/*!
+		 * Creates a new PGN writer for file \a fileName.
+		 *
+		 * The games are appended to the file in \a mode mode.
+		 */
+		PgnWriter(const QString& fileName,
+			  PgnGame::PgnMode mode = PgnGame::Verbose,
+			  QObject* parent = 0);
+		/*!
+		 * Flushes the buffered games and closes the file.
+		 *
+		 * Games in the reorder window are discarded.
+		 */
+		virtual ~PgnWriter();
+
+		/*! Returns the name of the PGN file. */
+		QString fileName() const;
+
+		/*!
+		 * Returns the maximum number of milliseconds the games are
+		 * buffered before they're written to the file.
+		 */
+		int flushInterval() const;
+		/*!
+		 * Sets the flush interval to \a msecs milliseconds.
+		 *
+		 * If \a msecs is 0 (the default) the file is flushed
+		 * after every game.
+		 */
+		void setFlushInterval(int msecs);
+
+		/*!
+		 * Returns the maximum number of games that are kept
+		 * in the reorder window.
+		 */
+		int reorderWindow() const;
+		/*! Sets the size of the reorder window to \a size games. */
+		void setReorderWindow(int size);
+
+		/*! Returns the number of the next game to write. */
+		int nextGameNumber() const;
+		/*!
+		 * Sets the number of the next game to write to \a number.
+		 *
+		 * Any games in the reorder window are discarded.
+		 */
+		void setNextGameNumber(int number);
+
+		/*!
+		 * Adds \a game with game number \a number to the output.
+		 *
+		 * Returns false if writing to the file failed;
+		 * otherwise returns true.
+		 */
+		bool addGame(int number, const PgnGame& game);
+
+	public slots:
+		/*!
+		 * Writes the buffered games to the file.
+		 *
+		 * Returns false if writing to the file failed;
+		 * otherwise returns true.
+		 */
+		bool flush();
+
+	private slots:
+		void onFlushTimeout();
+
+	private:
+		QFile m_file;
+		PgnGame::PgnMode m_mode;
+		QTimer* m_flushTimer;
+		int m_flushInterval;
+		int m_reorderWindow;
+		int m_nextNumber;
+		QMap<int, QByteArray> m_pending;
+		QByteArray m_buffer;
+};
+
+#endif // PGNWRITER_H
@@ -2,12 +2,14 @@ include(board/board.pri)
 INCLUDEPATH += $$PWD
 DEPENDPATH += $$PWD
 HEADERS += $$PWD/chessengine.h \
+    $$PWD/enginetoken.h \
     $$PWD/chessgame.h \
     $$PWD/chessplayer.h \
     $$PWD/engineconfiguration.h \
     $$PWD/openingbook.h \
     $$PWD/pgnstream.h \
     $$PWD/pgngame.h \
+    $$PWD/parallelpgnreader.h \
     $$PWD/polyglotbook.h \
     $$PWD/timecontrol.h \
     $$PWD/uciengine.h \
@@ -22,6 +24,9 @@ HEADERS += $$PWD/chessengine.h \
     $$PWD/enginetextoption.h \
     $$PWD/enginebuttonoption.h \
     $$PWD/pgngameentry.h \
+    $$PWD/pgnindex.h \
+    $$PWD/livepgnwriter.h \
+    $$PWD/pgnwriter.h \
     $$PWD/gamemanager.h \
     $$PWD/playerbuilder.h \
     $$PWD/enginebuilder.h \
@@ -41,12 +46,14 @@ HEADERS += $$PWD/chessengine.h \
     $$PWD/sprt.h \
     $$PWD/gameadjudicator.h
 SOURCES += $$PWD/chessengine.cpp \
+    $$PWD/enginetoken.cpp \
     $$PWD/chessgame.cpp \
     $$PWD/chessplayer.cpp \
     $$PWD/engineconfiguration.cpp \
     $$PWD/openingbook.cpp \
     $$PWD/pgnstream.cpp \
     $$PWD/pgngame.cpp \
+    $$PWD/parallelpgnreader.cpp \
     $$PWD/polyglotbook.cpp \
     $$PWD/timecontrol.cpp \
     $$PWD/uciengine.cpp \
@@ -61,6 +68,9 @@ SOURCES += $$PWD/chessengine.cpp \
     $$PWD/enginetextoption.cpp \
     $$PWD/enginebuttonoption.cpp \
     $$PWD/pgngameentry.cpp \
+    $$PWD/pgnindex.cpp \
+    $$PWD/livepgnwriter.cpp \
+    $$PWD/pgnwriter.cpp \
     $$PWD/gamemanager.cpp \
     $$PWD/playerbuilder.cpp \
     $$PWD/enginebuilder.cpp \
@@ -17,7 +17,6 @@
 
 
 #include "tournament.h"
-#include <QFile>
 #include "gamemanager.h"
 #include "playerbuilder.h"
 #include "board/boardfactory.h"
@@ -26,6 +25,9 @@
 #include "pgnstream.h"
 #include "openingsuite.h"
 #include "sprt.h"
+#include "board/tablebasecache.h"
+#include "livepgnwriter.h"
+#include "pgnwriter.h"
 
 Tournament::Tournament(GameManager* gameManager, QObject *parent)
 	: QObject(parent),
@@ -35,7 +37,6 @@ Tournament::Tournament(GameManager* gameManager, QObject *parent)
 	  m_round(0),
 	  m_nextGameNumber(0),
 	  m_finishedGameCount(0),
-	  m_savedGameCount(0),
 	  m_finalGameCount(0),
 	  m_gamesPerEncounter(1),
 	  m_roundMultiplier(1),
@@ -48,9 +49,11 @@ Tournament::Tournament(GameManager* gameManager, QObject *parent)
 	  m_finished(false),
 	  m_openingSuite(0),
 	  m_sprt(new Sprt),
-	  m_pgnOutMode(PgnGame::Verbose),
+	  m_tbCache(new TablebaseCache),
+	  m_pgnWriter(0),
+	  m_pgnFlushInterval(0),
 	  m_pair(QPair<int, int>(-1, -1)),
-	  m_livePgnOutMode(PgnGame::Verbose),
+	  m_livePgnWriter(0),
 	  m_resumeGameNumber(0)
 {
 	Q_ASSERT(gameManager != 0);
@@ -67,6 +70,9 @@ Tournament::~Tournament()
 
 	delete m_openingSuite;
 	delete m_sprt;
+	delete m_tbCache;
+	delete m_livePgnWriter;
+	delete m_pgnWriter;
 }
 
 GameManager* Tournament::gameManager() const
@@ -139,6 +145,11 @@ Sprt* Tournament::sprt() const
 	return m_sprt;
 }
 
+TablebaseCache* Tournament::tablebaseCache() const
+{
+	return m_tbCache;
+}
+
 void Tournament::setName(const QString& name)
 {
 	m_name = name;
@@ -192,6 +203,7 @@ void Tournament::setRecoveryMode(bool recover)
 void Tournament::setAdjudicator(const GameAdjudicator& adjudicator)
 {
 	m_adjudicator = adjudicator;
+	m_adjudicator.setTablebaseCache(m_tbCache);
 }
 
 void Tournament::setOpeningSuite(OpeningSuite *suite)
@@ -207,14 +219,28 @@ void Tournament::setOpeningDepth(int plies)
 
 void Tournament::setPgnOutput(const QString& fileName, PgnGame::PgnMode mode)
 {
-	m_pgnout = fileName;
-	m_pgnOutMode = mode;
+	delete m_pgnWriter;
+	m_pgnWriter = 0;
+	if (fileName.isEmpty())
+		return;
+
+	m_pgnWriter = new PgnWriter(fileName, mode);
+	m_pgnWriter->setFlushInterval(m_pgnFlushInterval);
+}
+
+void Tournament::setPgnFlushInterval(int msecs)
+{
+	m_pgnFlushInterval = msecs;
+	if (m_pgnWriter != 0)
+		m_pgnWriter->setFlushInterval(msecs);
 }
 
 void Tournament::setLivePgnOutput(const QString& fileName, PgnGame::PgnMode mode)
 {
-	m_livePgnout = fileName;
-	m_livePgnOutMode = mode;
+	delete m_livePgnWriter;
+	m_livePgnWriter = 0;
+	if (!fileName.isEmpty())
+		m_livePgnWriter = new LivePgnWriter(fileName, mode);
 }
 
 void Tournament::setPgnCleanupEnabled(bool enabled)
@@ -367,15 +393,15 @@ void Tournament::onGameStarted(ChessGame* game)
 
 void Tournament::onPgnMove()
 {
-	if (m_livePgnout.isEmpty()) return;
+	if (m_livePgnWriter == 0)
+		return;
 
 	ChessGame* sender = qobject_cast<ChessGame*>(QObject::sender());
 	Q_ASSERT(sender != 0);
 
-	PgnGame* pgn(sender->pgn());
-
-	QFile::resize(m_livePgnout, 0);
-	pgn->write(m_livePgnout, m_livePgnOutMode);
+	if (!m_livePgnWriter->update(*sender->pgn()))
+		qWarning("Can't write to PGN file %s",
+			 qPrintable(m_livePgnWriter->fileName()));
 }
 
 void Tournament::onGameFinished(ChessGame* game)
@@ -414,22 +440,14 @@ void Tournament::onGameFinished(ChessGame* game)
 		break;
 	}
 
-	if (!m_pgnout.isEmpty())
-	{
-		m_pgnGames[gameNumber] = *pgn;
-
-		if (!m_livePgnout.isEmpty()) {
-			QFile::resize(m_livePgnout, 0);
-			pgn->write(m_livePgnout, m_livePgnOutMode); // write the final pgn
-		}
+	// Write the final version of the live PGN
+	if (m_livePgnWriter != 0 && !m_livePgnWriter->finish(*pgn))
+		qWarning("Can't write to PGN file %s",
+			 qPrintable(m_livePgnWriter->fileName()));
 
-		while (m_pgnGames.contains(m_savedGameCount + 1))
-		{
-			PgnGame tmp = m_pgnGames.take(++m_savedGameCount);
-			if (!tmp.write(m_pgnout, m_pgnOutMode))
-				qWarning("Can't write to PGN file %s", qPrintable(m_pgnout));
-		}
-	}
+	if (m_pgnWriter != 0 && !m_pgnWriter->addGame(gameNumber, *pgn))
+		qWarning("Can't write to PGN file %s",
+			 qPrintable(m_pgnWriter->fileName()));
 
 	Chess::Result::Type resultType(game->result().type());
 	bool crashed = (resultType == Chess::Result::Disconnection ||
@@ -469,6 +487,8 @@ void Tournament::onGameDestroyed(ChessGame* game)
 
 	m_lastGame = 0;
 	m_gameManager->cleanupIdleThreads();
+	if (m_pgnWriter != 0)
+		m_pgnWriter->flush();
 	m_finished = true;
 	emit finished();
 }
@@ -491,12 +511,10 @@ void Tournament::start()
 	m_round = 1;
 	m_nextGameNumber = 0;
 	m_finishedGameCount = 0;
-	m_savedGameCount = 0;
 	m_finalGameCount = 0;
 	m_stopping = false;
 
 	m_gameData.clear();
-	m_pgnGames.clear();
 	m_openingHistory.clear();
 
 	connect(m_gameManager, SIGNAL(ready()),
@@ -505,12 +523,11 @@ void Tournament::start()
 	initializePairing();
 	m_finalGameCount = gamesPerCycle() * gamesPerEncounter() * roundMultiplier();
 
+	if (m_pgnWriter != 0)
+		m_pgnWriter->setNextGameNumber(1);
+
 	if (m_resumeGameNumber) {
 		int nextGame = m_resumeGameNumber;
-		OpeningSuite* pgngames = NULL;
-		if (!m_pgnout.isEmpty()) {
-			pgngames = new OpeningSuite(m_pgnout, OpeningSuite::PgnFormat, OpeningSuite::SequentialOrder, 0);
-		}
 
 		while (nextGame--) {
 			if (m_nextGameNumber >= m_finalGameCount)
@@ -526,16 +543,13 @@ void Tournament::start()
 				delete game;
 			}
 
-			if (pgngames) {
-				m_pgnGames[++m_savedGameCount] = pgngames->nextGame(INT_MAX - 1);
-			}
-
 			++m_nextGameNumber;
 			++m_finishedGameCount;
 		}
 
-		if (pgngames)
-			delete pgngames;
+		// The games of the previous session are already in the file
+		if (m_pgnWriter != 0)
+			m_pgnWriter->setNextGameNumber(m_nextGameNumber + 1);
 	}
 	startNextGame();
 }
@@ -551,6 +565,8 @@ void Tournament::stop()
 	if (m_gameData.isEmpty())
 	{
 		m_gameManager->cleanupIdleThreads();
+		if (m_pgnWriter != 0)
+			m_pgnWriter->flush();
 		m_finished = true;
 		emit finished();
 		return;
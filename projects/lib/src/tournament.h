@@ -35,6 +35,9 @@ class ChessGame;
 class OpeningBook;
 class OpeningSuite;
 class Sprt;
+class TablebaseCache;
+class LivePgnWriter;
+class PgnWriter;
 
 /*!
  * \brief Base class for chess tournaments
@@ -131,6 +134,11 @@ class LIB_EXPORT Tournament : public QObject
 		 * stopping criterion.
 		 */
 		Sprt* sprt() const;
+		/*!
+		 * Returns the tablebase probe cache that is shared by the
+		 * games of this tournament.
+		 */
+		TablebaseCache* tablebaseCache() const;
 
 		/*! Sets the tournament's name to \a name. */
 		void setName(const QString& name);
@@ -184,6 +192,15 @@ class LIB_EXPORT Tournament : public QObject
 		 */
 		void setPgnOutput(const QString& fileName,
 				  PgnGame::PgnMode mode = PgnGame::Verbose);
+		/*!
+		 * Sets the maximum time the finished games are buffered
+		 * before they're written to the PGN output file to
+		 * \a msecs milliseconds.
+		 *
+		 * If \a msecs is 0 (the default) each game is written
+		 * to the file as soon as it can be.
+		 */
+		void setPgnFlushInterval(int msecs);
  		/*!
  		 * Sets the live PGN output file for the games to \a fileName.
  		 *
@@ -344,7 +361,6 @@ class LIB_EXPORT Tournament : public QObject
 		int m_round;
 		int m_nextGameNumber;
 		int m_finishedGameCount;
-		int m_savedGameCount;
 		int m_finalGameCount;
 		int m_gamesPerEncounter;
 		int m_roundMultiplier;
@@ -358,14 +374,13 @@ class LIB_EXPORT Tournament : public QObject
 		GameAdjudicator m_adjudicator;
 		OpeningSuite* m_openingSuite;
 		Sprt* m_sprt;
-		QString m_pgnout;
-		PgnGame::PgnMode m_pgnOutMode;
+		TablebaseCache* m_tbCache;
+		PgnWriter* m_pgnWriter;
+		int m_pgnFlushInterval;
 		QPair<int, int> m_pair;
 		QList<PlayerData> m_players;
-		QMap<int, PgnGame> m_pgnGames;
 		QMap<ChessGame*, GameData*> m_gameData;
-		QString m_livePgnout;
-		PgnGame::PgnMode m_livePgnOutMode;
+		LivePgnWriter* m_livePgnWriter;
 		QString m_eventDate;
 		int m_resumeGameNumber;
 		QVariantMap m_openingHistory;
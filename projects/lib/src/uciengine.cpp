@@ -31,12 +31,51 @@
 #include "enginetextoption.h"
 
 
+namespace {
+
+// Initial capacity of the "position" command; enough for long games
+const int s_positionCapacity = 4096;
+
+enum InfoType
+{
+	InfoDepth,
+	InfoSelDepth,
+	InfoTime,
+	InfoNodes,
+	InfoPv,
+	InfoMultiPv,
+	InfoScore,
+	InfoCurrMove,
+	InfoCurrMoveNumber,
+	InfoHashFull,
+	InfoNps,
+	InfoTbHits,
+	InfoCpuLoad,
+	InfoString,
+	InfoRefutation,
+	InfoCurrLine,
+	InfoTypeCount
+};
+
+// The info types that update the evaluation
+const quint32 s_evalInfoTypes =
+	(1 << InfoDepth) | (1 << InfoTime) | (1 << InfoNodes) |
+	(1 << InfoPv) | (1 << InfoScore) | (1 << InfoNps) | (1 << InfoTbHits);
+
+} // anonymous namespace
+
 UciEngine::UciEngine(QObject* parent)
 	: ChessEngine(parent),
-	  m_sendOpponentsName(false)
+	  m_positionMoveCount(0),
+	  m_sendOpponentsName(false),
+	  m_infoLines(InfoTypeCount),
+	  m_infoPending(false)
 {
 	addVariant("standard");
 	setName("UciEngine");
+
+	m_position.reserve(s_positionCapacity);
+	m_infoTimer.start();
 }
 
 void UciEngine::startProtocol()
@@ -45,19 +84,45 @@ void UciEngine::startProtocol()
 	write("uci");
 }
 
-void UciEngine::sendPosition()
+void UciEngine::resetPosition(const QString& fen)
 {
-	QString str("position");
+	// The "position" command is kept in a single preallocated
+	// string which grows by one move at a time
+	m_position.resize(0);
+	m_positionMoveCount = 0;
 
-	if (board()->isRandomVariant() || m_startFen != board()->defaultFenString())
-		str += QString(" fen ") + m_startFen;
+	if (fen.isEmpty())
+		m_position.append("position startpos");
 	else
-		str += " startpos";
+		m_position.append("position fen ").append(fen);
+}
 
-	if (!m_moveStrings.isEmpty())
-		str += QString(" moves") + m_moveStrings;
+void UciEngine::addPositionMove(const Chess::Move& move)
+{
+	Chess::Board* board = this->board();
+	QString moveString(board->moveString(move, Chess::Board::LongAlgebraic));
 
-	write(str);
+	// In FEN mode an irreversible move (by either side) replaces
+	// the moves before it with the position after it
+	if (fenAfterIrreversible())
+	{
+		board->makeMove(move);
+		bool irreversible = (board->reversibleMoveCount() == 0);
+		if (irreversible)
+		{
+			Chess::Board::FenNotation notation = board->isRandomVariant() ?
+				Chess::Board::ShredderFen : Chess::Board::XFen;
+			resetPosition(board->fenString(notation));
+		}
+		board->undoMove();
+
+		if (irreversible)
+			return;
+	}
+
+	if (m_positionMoveCount++ == 0)
+		m_position.append(" moves");
+	m_position.append(' ').append(moveString);
 }
 
 static QString variantFromUci(const QString& str)
@@ -96,11 +161,16 @@ void UciEngine::startGame()
 {
 	Q_ASSERT(supportsVariant(board()->variant()));
 
-	m_moveStrings.clear();
+	QString startFen;
 	if (board()->isRandomVariant())
-		m_startFen = board()->fenString(Chess::Board::ShredderFen);
+		startFen = board()->fenString(Chess::Board::ShredderFen);
 	else
-		m_startFen = board()->fenString(Chess::Board::XFen);
+	{
+		startFen = board()->fenString(Chess::Board::XFen);
+		if (startFen == board()->defaultFenString())
+			startFen.clear();
+	}
+	resetPosition(startFen);
 
 	QString uciVariant(variantToUci(board()->variant()));
 	if (uciVariant != m_variantOption)
@@ -123,19 +193,20 @@ void UciEngine::startGame()
 		sendOption("UCI_Opponent", value);
 	}
 
-	sendPosition();
+	write(m_position);
 }
 
 void UciEngine::endGame(const Chess::Result& result)
 {
+	flushInfo();
 	stopThinking();
 	ChessEngine::endGame(result);
 }
 
 void UciEngine::makeMove(const Chess::Move& move)
 {
-	m_moveStrings += " " + board()->moveString(move, Chess::Board::LongAlgebraic);
-	sendPosition();
+	addPositionMove(move);
+	write(m_position);
 }
 
 void UciEngine::startThinking()
@@ -180,6 +251,11 @@ void UciEngine::startThinking()
 	if (myTc->nodeLimit() > 0)
 		command += QString(" nodes %1").arg(myTc->nodeLimit());
 
+	// The evaluation was cleared when the clock started, so any
+	// info left over from the previous search is obsolete
+	m_infoLines.fill(QByteArray());
+	m_infoPending = false;
+
 	write(command);
 }
 
@@ -204,13 +280,13 @@ void UciEngine::sendQuit()
 	write("quit");
 }
 
-QStringRef UciEngine::parseUciTokens(const QStringRef& first,
-				     const QString* types,
-				     int typeCount,
-				     QVarLengthArray<QStringRef>& tokens,
-				     int& type)
+EngineToken UciEngine::parseUciTokens(const EngineToken& first,
+				      const char* const* types,
+				      int typeCount,
+				      QVarLengthArray<EngineToken>& tokens,
+				      int& type)
 {
-	QStringRef token(first);
+	EngineToken token(first);
 	type = -1;
 	tokens.clear();
 
@@ -236,99 +312,93 @@ QStringRef UciEngine::parseUciTokens(const QStringRef& first,
 	return token;
 }
 
-static QStringRef joinTokens(const QVarLengthArray<QStringRef>& tokens)
+static EngineToken joinTokens(const QVarLengthArray<EngineToken>& tokens)
 {
 	Q_ASSERT(!tokens.isEmpty());
+	return tokens[0].joined(tokens[tokens.size() - 1]);
+}
 
-	const QStringRef& last = tokens[tokens.size() - 1];
-	int start = tokens[0].position();
-	int end = last.position() + last.size();
+static bool isBoundScore(const QVarLengthArray<EngineToken>& tokens)
+{
+	for (int i = 0; i < tokens.size(); i++)
+	{
+		if (tokens[i] == "lowerbound" || tokens[i] == "upperbound")
+			return true;
+	}
 
-	return QStringRef(last.string(), start, end - start);
+	return false;
 }
 
-void UciEngine::parseInfo(const QVarLengthArray<QStringRef>& tokens,
+void UciEngine::parseInfo(const QVarLengthArray<EngineToken>& tokens,
 			  int type)
 {
-	enum Keyword
-	{
-		InfoDepth,
-		InfoSelDepth,
-		InfoTime,
-		InfoNodes,
-		InfoPv,
-		InfoMultiPv,
-		InfoScore,
-		InfoCurrMove,
-		InfoCurrMoveNumber,
-		InfoHashFull,
-		InfoNps,
-		InfoTbHits,
-		InfoCpuLoad,
-		InfoString,
-		InfoRefutation,
-		InfoCurrLine
-	};
-
 	if (tokens.isEmpty())
 		return;
 
 	switch (type)
 	{
 	case InfoDepth:
-		m_eval.setDepth(tokens[0].toString().toInt());
+		m_eval.setDepth(tokens[0].toInt());
 		break;
 	case InfoTime:
-		m_eval.setTime(tokens[0].toString().toInt());
+		m_eval.setTime(tokens[0].toInt());
 		break;
 	case InfoNodes:
-		m_eval.setNodeCount(tokens[0].toString().toULongLong());
+		m_eval.setNodeCount(tokens[0].toULongLong());
 		break;
 	case InfoPv:
-		m_eval.setPv(joinTokens(tokens).toString());
+		// The PV starts from the position on the board only
+		// while the engine is thinking
+		if (state() == Thinking)
+			m_eval.setPv(board()->pvFromString(
+				joinTokens(tokens).toString(),
+				Chess::Board::LongAlgebraic));
 		break;
 	case InfoScore:
 		{
+			// Bound scores are ignored in both info modes
+			if (isBoundScore(tokens))
+				break;
+
 			int score = 0;
 			for (int i = 1; i < tokens.size(); i++)
 			{
 				if (tokens[i - 1] == "cp")
 				{
-					score = tokens[i].toString().toInt();
+					score = tokens[i].toInt();
 					if (whiteEvalPov()
 					&&  side() == Chess::Side::Black)
 						score = -score;
 				}
 				else if (tokens[i - 1] == "mate")
 				{
-					score = tokens[i].toString().toInt();
+					score = tokens[i].toInt();
 					if (score > 0)
 						score = 30001 - score * 2;
 					else if (score < 0)
 						score = -30000 - score * 2;
 				}
-				else if (tokens[i - 1] == "lowerbound"
-				     ||  tokens[i - 1] == "upperbound")
-					return;
 				i++;
 			}
 			m_eval.setScore(score);
 		}
 		break;
 	case InfoNps:
-		m_eval.setNps(tokens[0].toString().toInt());
+		m_eval.setNps(tokens[0].toInt());
 		break;
 	case InfoTbHits:
-		m_eval.setTbHits(tokens[0].toString().toInt());
+		m_eval.setTbHits(tokens[0].toInt());
 		break;
 	default:
 		break;
 	}
 }
 
-void UciEngine::parseInfo(const QStringRef& line)
+void UciEngine::parseInfo(const EngineToken& line,
+			  quint32 types,
+			  bool coalesce)
 {
-	static const QString types[] =
+	static const char* const typeNames[] =
 	{
 		"depth",
 		"seldepth",
@@ -349,17 +419,62 @@ void UciEngine::parseInfo(const QStringRef& line)
 	};
 
 	int type = -1;
-	QStringRef token(nextToken(line));
-	QVarLengthArray<QStringRef> tokens;
+	EngineToken token(nextToken(line));
+	QVarLengthArray<EngineToken> tokens;
+	QByteArray lineCopy;
 
 	while (!token.isNull())
 	{
-		token = parseUciTokens(token, types, 16, tokens, type);
-		parseInfo(tokens, type);
+		token = parseUciTokens(token, typeNames, InfoTypeCount,
+				       tokens, type);
+		if (type == -1 || !(types & (1 << type)))
+			continue;
+
+		if (!coalesce)
+			parseInfo(tokens, type);
+		// Keep only the latest line of each type; a bound score
+		// doesn't replace the previous exact score
+		else if (!tokens.isEmpty()
+		     &&  (type != InfoScore || !isBoundScore(tokens)))
+		{
+			// The types of a line share one copy of it
+			if (lineCopy.isNull())
+				lineCopy = QByteArray(line.line(), line.lineSize());
+			m_infoLines[type] = lineCopy;
+			m_infoPending = true;
+		}
+	}
+}
+
+void UciEngine::flushInfo()
+{
+	if (!m_infoPending)
+		return;
+	m_infoPending = false;
+	m_infoTimer.start();
+
+	for (int i = 0; i < m_infoLines.size(); i++)
+	{
+		if (m_infoLines.at(i).isNull())
+			continue;
+
+		// Parse each line only once for all the types it provides
+		const QByteArray line(m_infoLines.at(i));
+		quint32 types = 0;
+		for (int j = i; j < m_infoLines.size(); j++)
+		{
+			if (m_infoLines.at(j).constData() == line.constData())
+			{
+				types |= 1 << j;
+				m_infoLines[j].clear();
+			}
+		}
+		parseInfo(firstToken(line.constData(), line.size()),
+			  types, false);
 	}
 }
 
-EngineOption* UciEngine::parseOption(const QStringRef& line)
+EngineOption* UciEngine::parseOption(const EngineToken& line)
 {
 	enum Keyword
 	{
@@ -370,7 +485,7 @@ EngineOption* UciEngine::parseOption(const QStringRef& line)
 		OptionMax,
 		OptionVar
 	};
-	static const QString types[] =
+	static const char* const types[] =
 	{
 		"name",
 		"type",
@@ -388,8 +503,8 @@ EngineOption* UciEngine::parseOption(const QStringRef& line)
 	int max = 0;
 
 	int keyword = -1;
-	QStringRef token(nextToken(line));
-	QVarLengthArray<QStringRef> tokens;
+	EngineToken token(nextToken(line));
+	QVarLengthArray<EngineToken> tokens;
 
 	while (!token.isNull())
 	{
@@ -446,13 +561,20 @@ EngineOption* UciEngine::parseOption(const QStringRef& line)
 	return 0;
 }
 
-void UciEngine::parseLine(const QString& line)
+void UciEngine::parseLine(const char* line, int size)
 {
-	const QStringRef command(firstToken(line));
+	const EngineToken command(firstToken(line, size));
 
 	if (command == "info")
 	{
-		parseInfo(command);
+		if (infoInterval() > 0)
+		{
+			parseInfo(command, s_evalInfoTypes, true);
+			if (m_infoTimer.hasExpired(infoInterval()))
+				flushInfo();
+		}
+		else
+			parseInfo(command, ~0u, false);
 	}
 	else if (command == "bestmove")
 	{
@@ -465,12 +587,15 @@ void UciEngine::parseLine(const QString& line)
 			return;
 		}
 
+		flushInfo();
 		QString moveString(nextToken(command).toString());
-		m_moveStrings += " " + moveString;
 		Chess::Move move = board()->moveFromString(moveString);
 
 		if (!move.isNull())
+		{
+			addPositionMove(move);
 			emitMove(move);
+		}
 		else
 			forfeit(Chess::Result::IllegalMove, moveString);
 	}
@@ -488,7 +613,7 @@ void UciEngine::parseLine(const QString& line)
 	}
 	else if (command == "id")
 	{
-		QStringRef tag(nextToken(command));
+		EngineToken tag(nextToken(command));
 		if (tag == "name" && name() == "UciEngine")
 			setName(nextToken(tag, true).toString());
 	}
@@ -507,7 +632,8 @@ void UciEngine::parseLine(const QString& line)
 
 		if (option == 0 || !option->isValid())
 			qDebug("Invalid UCI option from %s: %s",
-				qPrintable(name()), qPrintable(line));
+				qPrintable(name()),
+				qPrintable(QString::fromUtf8(line, size)));
 		else if (!(variant = variantFromUci(option->name())).isEmpty())
 			addVariant(variant);
 		else if (option->name() == "UCI_Opponent")
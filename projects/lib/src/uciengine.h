@@ -20,6 +20,8 @@
 
 #include "chessengine.h"
 #include <QVarLengthArray>
+#include <QVector>
+#include <QElapsedTimer>
 
 
 /*!
@@ -48,25 +50,32 @@ class LIB_EXPORT UciEngine : public ChessEngine
 		virtual void startProtocol();
 		virtual void startGame();
 		virtual void startThinking();
-		virtual void parseLine(const QString& line);
+		virtual void parseLine(const char* line, int size);
 		virtual void sendOption(const QString& name, const QVariant& value);
 		
 	private:
-		static QStringRef parseUciTokens(const QStringRef& first,
-						 const QString* types,
-						 int typeCount,
-						 QVarLengthArray<QStringRef>& tokens,
-						 int& type);
-		void parseInfo(const QVarLengthArray<QStringRef>& tokens,
+		static EngineToken parseUciTokens(const EngineToken& first,
+						  const char* const* types,
+						  int typeCount,
+						  QVarLengthArray<EngineToken>& tokens,
+						  int& type);
+		void parseInfo(const QVarLengthArray<EngineToken>& tokens,
 			       int type);
-		void parseInfo(const QStringRef& line);
-		EngineOption* parseOption(const QStringRef& line);
-		void sendPosition();
+		void parseInfo(const EngineToken& line,
+			       quint32 types,
+			       bool coalesce);
+		void flushInfo();
+		EngineOption* parseOption(const EngineToken& line);
+		void resetPosition(const QString& fen);
+		void addPositionMove(const Chess::Move& move);
 		
 		QString m_variantOption;
-		QString m_startFen;
-		QString m_moveStrings;
+		QString m_position;
+		int m_positionMoveCount;
 		bool m_sendOpponentsName;
+		QVector<QByteArray> m_infoLines;
+		bool m_infoPending;
+		QElapsedTimer m_infoTimer;
 };
 
 #endif // UCIENGINE_H
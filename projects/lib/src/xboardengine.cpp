@@ -22,6 +22,7 @@
 #include <QStringList>
 #include <QTimer>
 
+#include <cctype>
 #include <climits>
 
 #include "timecontrol.h"
@@ -512,9 +513,9 @@ void XboardEngine::setFeature(const QString& name, const QString& val)
 	write("accepted " + name, Unbuffered);
 }
 
-void XboardEngine::parseLine(const QString& line)
+void XboardEngine::parseLine(const char* line, int size)
 {
-	const QStringRef command(firstToken(line));
+	const EngineToken command(firstToken(line, size));
 	if (command.isEmpty())
 		return;
 
@@ -558,22 +559,23 @@ void XboardEngine::parseLine(const QString& line)
 
 		return;
 	}
-	else if (command.at(0).isDigit()) // principal variation
+	else if (isdigit((unsigned char)command.at(0))) // principal variation
 	{
 		bool ok = false;
 		int val = 0;
-		QStringRef ref(command);
+		EngineToken ref(command);
 
 		// Search depth
-		QString depth(ref.toString());
-		if (!(depth.end() - 1)->isDigit())
-			depth.chop(1);
+		EngineToken depth(ref);
+		if (!isdigit((unsigned char)depth.at(depth.size() - 1)))
+			depth = EngineToken(depth.line(), depth.lineSize(),
+					    depth.position(), depth.size() - 1);
 		m_eval.setDepth(depth.toInt());
 
 		// Evaluation
 		if ((ref = nextToken(ref)).isNull())
 			return;
-		val = ref.toString().toInt(&ok);
+		val = ref.toInt(&ok);
 		if (ok)
 		{
 			if (whiteEvalPov() && side() == Chess::Side::Black)
@@ -584,29 +586,32 @@ void XboardEngine::parseLine(const QString& line)
 		// Search time
 		if ((ref = nextToken(ref)).isNull())
 			return;
-		val = ref.toString().toInt(&ok);
+		val = ref.toInt(&ok);
 		if (ok)
 			m_eval.setTime(val * 10);
 
 		// Node count
 		if ((ref = nextToken(ref)).isNull())
 			return;
-		qulonglong uval = ref.toString().toULongLong(&ok);
+		quint64 uval = ref.toULongLong(&ok);
 		if (ok)
 			m_eval.setNodeCount(uval);
 
 		// Principal variation
-		if ((ref = nextToken(ref, true)).isNull())
+		if ((ref = nextToken(ref, true)).isNull() || state() != Thinking)
 			return;
-		m_eval.setPv(ref.toString());
+		m_eval.setPv(board()->pvFromString(ref.toString(),
+						   Chess::Board::StandardAlgebraic));
 
 		return;
 	}
 
-	const QString args(nextToken(command, true).toString());
+	// The arguments are converted only for the commands that use them
+	const EngineToken argsToken(nextToken(command, true));
 
 	if (command == "move")
 	{
+		const QString args(argsToken.toString());
 		if (state() != Thinking)
 		{
 			if (state() == FinishingGame)
@@ -644,11 +649,12 @@ void XboardEngine::parseLine(const QString& line)
 	}
 	else if (command == "pong")
 	{
-		if (args.toInt() == m_lastPing)
+		if (argsToken.toInt() == m_lastPing)
 			pong();
 	}
 	else if (command == "feature")
 	{
+		const QString args(argsToken.toString());
 		QRegExp rx("\\w+\\s*=\\s*(\"[^\"]*\"|\\d+)");
 
 		int pos = 0;
@@ -673,7 +679,7 @@ void XboardEngine::parseLine(const QString& line)
 	{
 		// If the engine complains about an unknown result command,
 		// we can assume that it's safe to finish the game.
-		QString str = args.section(':', 1).trimmed();
+		QString str = argsToken.toString().section(':', 1).trimmed();
 		if (str.startsWith("result"))
 			finishGame();
 	}
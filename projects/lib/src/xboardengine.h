@@ -47,7 +47,7 @@ class LIB_EXPORT XboardEngine : public ChessEngine
 		virtual void startProtocol();
 		virtual void startGame();
 		virtual void startThinking();
-		virtual void parseLine(const QString& line);
+		virtual void parseLine(const char* line, int size);
 		virtual void sendOption(const QString& name, const QVariant& value);
 		virtual bool restartsBetweenGames() const;
 
@@ -18,6 +18,12 @@ class tst_Board: public QObject
 		void moveStrings_data() const;
 		void moveStrings();
 		
+		void pvStrings_data() const;
+		void pvStrings();
+
+		void repeatCount_data() const;
+		void repeatCount();
+
 		void perft_data() const;
 		void perft();
 
@@ -186,6 +192,8 @@ void tst_Board::moveStrings()
 
 	setVariant(variant);
 	QVERIFY(m_board->setFenString(startfen));
+	const quint64 startMaterialKey = m_board->materialKey();
+	QCOMPARE(m_board->pieceCount(), 32);
 
 	QStringList moveList = moves.split(' ');
 	foreach (const QString& moveStr, moveList)
@@ -195,10 +203,116 @@ void tst_Board::moveStrings()
 		m_board->makeMove(move);
 	}
 	QCOMPARE(m_board->fenString(), endfen);
+	const quint64 endMaterialKey = m_board->materialKey();
+	QVERIFY(endMaterialKey != startMaterialKey);
+	QCOMPARE(m_board->pieceCount(), 20);
+	QCOMPARE(m_board->pieceCount(Chess::Side::White), 11);
+	QCOMPARE(m_board->pieceCount(Chess::Side::Black, Chess::Piece::NoPiece), 9);
 
 	for (int i = 0; i < moveList.size(); i++)
 		m_board->undoMove();
 	QCOMPARE(m_board->fenString(), startfen);
+	QCOMPARE(m_board->materialKey(), startMaterialKey);
+	QCOMPARE(m_board->pieceCount(), 32);
+
+	// The counters must match a board set up directly from the FEN
+	QVERIFY(m_board->setFenString(endfen));
+	QCOMPARE(m_board->materialKey(), endMaterialKey);
+	QCOMPARE(m_board->pieceCount(), 20);
+}
+
+void tst_Board::pvStrings_data() const
+{
+	QTest::addColumn<QString>("fen");
+	QTest::addColumn<QString>("pv");
+	QTest::addColumn<QString>("san");
+
+	const QString startFen(
+		"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+	QTest::newRow("legal")
+		<< startFen
+		<< "e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 e1g1"
+		<< "e4 e5 Nf3 Nc6 Bb5 a6 O-O";
+	QTest::newRow("illegal")
+		<< startFen
+		<< "e2e4 e7e5 e1g1 b8c6"
+		<< "e4 e5";
+	QTest::newRow("promotion")
+		<< "8/P6k/8/8/8/8/8/K7 w - - 0 1"
+		<< "a7a8q h7g6 a8g8"
+		<< "a8=Q Kg6 Qg8+";
+	QTest::newRow("empty")
+		<< startFen
+		<< ""
+		<< "";
+}
+
+void tst_Board::pvStrings()
+{
+	QFETCH(QString, fen);
+	QFETCH(QString, pv);
+	QFETCH(QString, san);
+
+	setVariant("standard");
+	QVERIFY(m_board->setFenString(fen));
+
+	QVector<Chess::Move> moves(m_board->pvFromString(
+		pv, Chess::Board::LongAlgebraic));
+	QCOMPARE(m_board->fenString(), fen);
+
+	QStringList strings(m_board->pvStrings(
+		moves, Chess::Board::StandardAlgebraic));
+	QCOMPARE(strings.join(" "), san);
+	QCOMPARE(m_board->fenString(), fen);
+}
+
+void tst_Board::repeatCount_data() const
+{
+	QTest::addColumn<QString>("variant");
+	QTest::addColumn<QString>("fen");
+	QTest::addColumn<QString>("moves");
+	QTest::addColumn<int>("repeatCount");
+
+	QTest::newRow("standard")
+		<< "standard"
+		<< "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+		<< "Nf3 Nf6 Ng1 Ng8 Nf3 Nf6 Ng1 Ng8"
+		<< 2;
+	QTest::newRow("standard irreversible")
+		<< "standard"
+		<< "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+		<< "Nf3 Nf6 Ng1 Ng8 e4 e5 Nf3 Nf6 Ng1 Ng8"
+		<< 1;
+	QTest::newRow("standard no repetition")
+		<< "standard"
+		<< "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
+		<< "Nf3 Nf6 Nc3 Nc6"
+		<< 0;
+	QTest::newRow("crazyhouse drops")
+		<< "crazyhouse"
+		<< "r1bqkb1r/pppppppp/5n2/3n4/8/2N5/PPPPPPPP/R1BQKBNR w - KQkq - 0 1"
+		<< "Nxd5 Nxd5 N@c3 N@f6 Nxd5 Nxd5 N@c3 N@f6"
+		<< 2;
+}
+
+void tst_Board::repeatCount()
+{
+	QFETCH(QString, variant);
+	QFETCH(QString, fen);
+	QFETCH(QString, moves);
+	QFETCH(int, repeatCount);
+
+	setVariant(variant);
+	QVERIFY(m_board->setFenString(fen));
+
+	foreach (const QString& moveStr, moves.split(' '))
+	{
+		Chess::Move move = m_board->moveFromString(moveStr);
+		QVERIFY(m_board->isLegalMove(move));
+		m_board->makeMove(move);
+	}
+	QCOMPARE(m_board->repeatCount(), repeatCount);
 }
 
 void tst_Board::perft_data() const
@@ -230,6 +344,16 @@ void tst_Board::perft_data() const
 		<< "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -"
 		<< 6
 		<< Q_UINT64_C(11030083);
+	QTest::newRow("pos5")
+		<< variant
+		<< "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"
+		<< 3
+		<< Q_UINT64_C(62379);
+	QTest::newRow("pos6")
+		<< variant
+		<< "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"
+		<< 3
+		<< Q_UINT64_C(89890);
 	
 	variant = "capablanca";
 	QTest::newRow("gothic startpos")
@@ -0,0 +1,4 @@
+include(../tests.pri)
+
+TARGET = tst_eco
+SOURCES += tst_eco.cpp
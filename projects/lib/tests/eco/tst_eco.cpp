@@ -0,0 +1,170 @@
+#include <QtTest/QtTest>
+#include <pgngame.h>
+#include <econode.h>
+#include <board/board.h>
+#include <board/boardfactory.h>
+
+
+class tst_Eco: public QObject
+{
+	Q_OBJECT
+
+	private slots:
+		void initTestCase();
+
+		void incremental_data() const;
+		void incremental();
+
+		void customPosition();
+};
+
+
+static PgnGame::MoveData sanMove(const QString& san)
+{
+	PgnGame::MoveData md = { 0, Chess::GenericMove(), san, QString() };
+	return md;
+}
+
+// Returns the moves of a standard game with the position keys that
+// are needed for classifying transpositions.
+static QVector<PgnGame::MoveData> gameMoves(const QString& moves)
+{
+	QVector<PgnGame::MoveData> vec;
+	Chess::Board* board = Chess::BoardFactory::create("standard");
+	board->reset();
+
+	foreach (const QString& san, moves.split(' ', QString::SkipEmptyParts))
+	{
+		Chess::Move move(board->moveFromString(san));
+		if (move.isNull())
+			break;
+
+		PgnGame::MoveData md = { board->key(), board->genericMove(move),
+					 san, QString() };
+		vec.append(md);
+		board->makeMove(move);
+	}
+
+	delete board;
+	return vec;
+}
+
+void tst_Eco::initTestCase()
+{
+	QVERIFY(EcoNode::root() != 0);
+}
+
+void tst_Eco::incremental_data() const
+{
+	QTest::addColumn<QString>("moves");
+	QTest::addColumn<QString>("eco");
+	QTest::addColumn<QString>("opening");
+	QTest::addColumn<QString>("variation");
+
+	QTest::newRow("sicilian")
+		<< "e4 c5 Nf3 d6"
+		<< "B50"
+		<< "Sicilian"
+		<< "";
+	QTest::newRow("najdorf")
+		<< "e4 c5 Nf3 d6 d4 cxd4 Nxd4 Nf6 Nc3 a6 Bg5 e6 f4 Qb6"
+		<< "B97"
+		<< "Sicilian"
+		<< "Najdorf, 7...Qb6";
+	QTest::newRow("qgd orthodox")
+		<< "d4 d5 c4 e6 Nc3 Nf6 Bg5 Be7 e3 O-O Nf3 Nbd7 Rc1 c6"
+		<< "D63"
+		<< "QGD"
+		<< "Orthodox defense";
+	QTest::newRow("ruy lopez chigorin, out of book")
+		<< "e4 e5 Nf3 Nc6 Bb5 a6 Ba4 Nf6 O-O Be7 Re1 b5 Bb3 O-O c3 d6 "
+		   "h3 Na5 Bc2 c5 d4 Qc7 a4"
+		<< "C97"
+		<< "Ruy Lopez"
+		<< "Closed, Chigorin defense";
+	QTest::newRow("ruy lopez chigorin, transposed")
+		<< "e4 e5 Nf3 Nc6 Bb5 a6 Ba4 Nf6 O-O Be7 Re1 b5 Bb3 d6 c3 O-O "
+		   "h3 Na5 Bc2 c5 d4 Qc7 a4"
+		<< "C97"
+		<< "Ruy Lopez"
+		<< "Closed, Chigorin defense";
+	QTest::newRow("nimzo-indian from english")
+		<< "c4 e6 d4 Nf6 Nc3 Bb4 a3"
+		<< "E20"
+		<< "Nimzo-Indian defense"
+		<< "";
+	QTest::newRow("qgd from reti")
+		<< "Nf3 d5 d4 Nf6 c4 e6 Nc3 Be7 Bg5 h6"
+		<< "D37"
+		<< "QGD"
+		<< "4.Nf3";
+	QTest::newRow("caro-kann panov")
+		<< "e4 c6 d4 d5 exd5 cxd5 c4 Nf6 Nc3 e6 Nf3 Bb4"
+		<< "B14"
+		<< "Caro-Kann"
+		<< "Panov-Botvinnik attack, 5...e6";
+	QTest::newRow("english")
+		<< "c4 e5 Nc3 Nf6 g3"
+		<< "A22"
+		<< "English"
+		<< "Carls' Bremen system";
+	QTest::newRow("two knights")
+		<< "e4 e5 Nf3 Nc6 Bc4 Nf6 Ng5 d5 exd5 Na5 Kf1"
+		<< "C58"
+		<< "Two knights defense"
+		<< "";
+	QTest::newRow("amar, out of book")
+		<< "Nh3 Nh6 Ng1 Ng8"
+		<< "A00"
+		<< "Amar (Paris) Opening"
+		<< "";
+}
+
+void tst_Eco::incremental()
+{
+	QFETCH(QString, moves);
+	QFETCH(QString, eco);
+	QFETCH(QString, opening);
+	QFETCH(QString, variation);
+
+	PgnGame game;
+	game.setTag("Event", "?");
+	game.setWantsEcoClassification(true);
+
+	const QVector<PgnGame::MoveData> mdList(gameMoves(moves));
+	QCOMPARE(mdList.size(), moves.split(' ', QString::SkipEmptyParts).size());
+	foreach (const PgnGame::MoveData& md, mdList)
+		game.addMove(md);
+
+	QCOMPARE(game.tagValue("ECO"), eco);
+	QCOMPARE(game.tagValue("Opening"), opening);
+	QCOMPARE(game.tagValue("Variation"), variation);
+
+	// Classifying the whole game at once must give the same result
+	PgnGame batch;
+	batch.setTag("Event", "?");
+	foreach (const PgnGame::MoveData& md, mdList)
+		batch.addMove(md);
+	batch.classifyEco();
+
+	QCOMPARE(batch.tagValue("ECO"), eco);
+	QCOMPARE(batch.tagValue("Opening"), opening);
+	QCOMPARE(batch.tagValue("Variation"), variation);
+}
+
+void tst_Eco::customPosition()
+{
+	PgnGame game;
+	game.setStartingFenString(Chess::Side::White,
+		"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+	game.setWantsEcoClassification(true);
+
+	game.addMove(sanMove("e4"));
+	game.addMove(sanMove("e6"));
+
+	QVERIFY(game.tagValue("ECO").isEmpty());
+	QVERIFY(game.tagValue("Opening").isEmpty());
+}
+
+QTEST_MAIN(tst_Eco)
+#include "tst_eco.moc"
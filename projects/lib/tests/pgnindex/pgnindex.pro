@@ -0,0 +1,4 @@
+include(../tests.pri)
+
+TARGET = tst_pgnindex
+SOURCES += tst_pgnindex.cpp
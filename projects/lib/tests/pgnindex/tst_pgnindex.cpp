@@ -0,0 +1,85 @@
+#include <QtTest/QtTest>
+#include <pgnindex.h>
+
+
+class tst_PgnIndex: public QObject
+{
+	Q_OBJECT
+
+	private slots:
+		void init();
+		void cleanup();
+
+		void trailingNewline();
+
+	private:
+		QString m_fileName;
+};
+
+
+static const char s_pgn[] =
+	"[Event \"?\"]\n"
+	"[Site \"?\"]\n"
+	"[Date \"????.??.??\"]\n"
+	"[Round \"1\"]\n"
+	"[White \"A\"]\n"
+	"[Black \"B\"]\n"
+	"[Result \"1-0\"]\n"
+	"\n"
+	"1. e4 e5 2. Qh5 Nc6 3. Bc4 Nf6 4. Qxf7# 1-0\n"
+	"\n"
+	"[Event \"?\"]\n"
+	"[Site \"?\"]\n"
+	"[Date \"????.??.??\"]\n"
+	"[Round \"2\"]\n"
+	"[White \"B\"]\n"
+	"[Black \"A\"]\n"
+	"[Result \"0-1\"]\n"
+	"\n"
+	"1. f3 e5 2. g4 Qh4# 0-1\n"
+	"\n";
+
+void tst_PgnIndex::init()
+{
+	m_fileName = QDir::tempPath() + QString("/tst_pgnindex_%1.pgn")
+		.arg(QCoreApplication::applicationPid());
+
+	QFile file(m_fileName);
+	QVERIFY(file.open(QIODevice::WriteOnly));
+	QVERIFY(file.write(s_pgn) == qint64(sizeof(s_pgn) - 1));
+}
+
+void tst_PgnIndex::cleanup()
+{
+	PgnIndex index(m_fileName);
+	QFile::remove(index.indexFileName());
+	QFile::remove(m_fileName);
+}
+
+void tst_PgnIndex::trailingNewline()
+{
+	PgnIndex index(m_fileName);
+	QVERIFY(index.update());
+	QCOMPARE(index.count(), 2);
+
+	QFileInfo indexInfo(index.indexFileName());
+	QVERIFY(indexInfo.exists());
+	QDateTime indexModified(indexInfo.lastModified());
+
+	// Make sure a rewrite would change the modification time
+	QTest::qSleep(1100);
+
+	PgnIndex index2(m_fileName);
+	QVERIFY(index2.load());
+	QCOMPARE(index2.count(), 2);
+	QCOMPARE(index2.scanPos(), QFileInfo(m_fileName).size());
+	QCOMPARE(index2.scanLineNumber(), qint64(21));
+
+	QVERIFY(index2.update());
+	QCOMPARE(index2.count(), 2);
+	indexInfo.refresh();
+	QCOMPARE(indexInfo.lastModified(), indexModified);
+}
+
+QTEST_MAIN(tst_PgnIndex)
+#include "tst_pgnindex.moc"
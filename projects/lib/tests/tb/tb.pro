@@ -1,4 +1,6 @@
 include(../tests.pri)
 
+greaterThan(QT_MAJOR_VERSION, 4):QT += concurrent
+
 TARGET = tst_tb
 SOURCES += tst_tb.cpp
@@ -1,6 +1,8 @@
 #include <QtTest/QtTest>
+#include <QtConcurrent/QtConcurrent>
 #include <board/standardboard.h>
 #include <board/syzygytablebase.h>
+#include <board/tablebasecache.h>
 
 
 class tst_Tb: public QObject
@@ -14,6 +16,9 @@ class tst_Tb: public QObject
 		
 		void positions_data() const;
 		void positions();
+
+		void probeThroughput_data() const;
+		void probeThroughput();
 		
 		void cleanupTestCase();
 		
@@ -110,6 +115,83 @@ void tst_Tb::positions()
 	unsigned int tbDtz = 0;
 	QCOMPARE(m_board.tablebaseResult(&tbDtz).toShortString(), result);
 	QCOMPARE(int(tbDtz), dtz);
+
+	// The WDL-first adjudication probe must agree with the root probe,
+	// both when the position is probed and when it's found in the cache.
+	TablebaseCache cache;
+	QCOMPARE(m_board.tablebaseResult(0, &cache).toShortString(), result);
+	QCOMPARE(m_board.tablebaseResult(0, &cache).toShortString(), result);
+	const quint64 probes = (result == "*") ? 0 : 1;
+	QCOMPARE(cache.misses(), probes);
+	QCOMPARE(cache.hits(), probes);
+}
+
+static const char* s_probeFens[] = {
+	"7k/8/8/8/5KP1/8/8/8 w - - 0 1",
+	"8/2k5/8/6N1/5K2/1r6/8/8 w - - 0 1",
+	"1n6/8/8/8/8/8/6R1/2K1k3 w - - 0 1",
+	"8/8/3n4/8/8/8/4R3/2K2k2 w - - 0 1",
+	"2B5/8/8/8/8/2K2k2/6p1/8 b - - 0 1",
+	"2K4N/8/8/8/7p/5k2/8/8 w - - 0 1",
+	"K5Q1/8/8/8/5bb1/6k1/8/8 b - - 0 72",
+	0
+};
+
+static int probePositions(int rounds)
+{
+	Chess::StandardBoard board;
+	int probes = 0;
+
+	for (int i = 0; i < rounds; i++)
+	{
+		for (int j = 0; s_probeFens[j] != 0; j++)
+		{
+			if (!board.setFenString(s_probeFens[j]))
+				continue;
+			if (!board.tablebaseResult().isNone())
+				probes++;
+		}
+	}
+
+	return probes;
+}
+
+void tst_Tb::probeThroughput_data() const
+{
+	QTest::addColumn<int>("threads");
+
+	QTest::newRow("1 thread") << 1;
+	QTest::newRow("2 threads") << 2;
+	QTest::newRow("4 threads") << 4;
+	QTest::newRow("8 threads") << 8;
+	QTest::newRow("16 threads") << 16;
+}
+
+/*
+ * Every thread does the same amount of work, so with lock-free probing
+ * the time per iteration stays flat as long as there are enough cores.
+ */
+void tst_Tb::probeThroughput()
+{
+	QFETCH(int, threads);
+
+	const int rounds = 50;
+	int expected = probePositions(1) * rounds * threads;
+
+	QThreadPool pool;
+	pool.setMaxThreadCount(threads);
+
+	QBENCHMARK
+	{
+		QVector< QFuture<int> > futures;
+		for (int i = 0; i < threads; i++)
+			futures << QtConcurrent::run(&pool, probePositions, rounds);
+
+		int probes = 0;
+		foreach (const QFuture<int>& future, futures)
+			probes += future.result();
+		QCOMPARE(probes, expected);
+	}
 }
 
 QTEST_MAIN(tst_Tb)
@@ -1,2 +1,2 @@
 TEMPLATE = subdirs
-SUBDIRS = chessboard tb
+SUBDIRS = chessboard tb eco uciengine pgnindex
@@ -0,0 +1,146 @@
+#include <QtTest/QtTest>
+#include <uciengine.h>
+#include <engineconfiguration.h>
+#include <timecontrol.h>
+#include <board/board.h>
+#include <board/boardfactory.h>
+
+
+/*!
+ * A device that plays the part of an UCI engine. It completes the
+ * handshake, and replay() feeds recorded output to the engine.
+ */
+class UciDevice : public QIODevice
+{
+	Q_OBJECT
+
+	public:
+		UciDevice()
+		{
+			open(QIODevice::ReadWrite);
+		}
+
+		void replay(const QByteArray& data)
+		{
+			m_output.append(data);
+			QMetaObject::invokeMethod(this, "readyRead",
+						  Qt::QueuedConnection);
+		}
+
+		virtual bool isSequential() const
+		{
+			return true;
+		}
+		virtual qint64 bytesAvailable() const
+		{
+			return m_output.size() + QIODevice::bytesAvailable();
+		}
+		virtual bool canReadLine() const
+		{
+			return m_output.contains('\n') || QIODevice::canReadLine();
+		}
+
+	protected:
+		virtual qint64 readData(char* data, qint64 maxSize)
+		{
+			qint64 size = qMin(maxSize, qint64(m_output.size()));
+			memcpy(data, m_output.constData(), size);
+			m_output.remove(0, size);
+			return size;
+		}
+		virtual qint64 writeData(const char* data, qint64 maxSize)
+		{
+			QByteArray line(data, maxSize);
+			if (line == "uci\n")
+				replay("uciok\n");
+			else if (line == "isready\n")
+				replay("readyok\n");
+			return maxSize;
+		}
+
+	private:
+		QByteArray m_output;
+};
+
+class tst_UciEngine: public QObject
+{
+	Q_OBJECT
+
+	private slots:
+		void score_data() const;
+		void score();
+};
+
+void tst_UciEngine::score_data() const
+{
+	QTest::addColumn<int>("infoInterval");
+	QTest::addColumn<QByteArray>("info");
+	QTest::addColumn<int>("score");
+
+	QList<int> intervals;
+	intervals << 0 << 1000;
+
+	foreach (int interval, intervals)
+	{
+		QByteArray mode(interval > 0 ? "coalesced " : "eager ");
+
+		QTest::newRow((mode + "cp").constData())
+			<< interval
+			<< QByteArray("info depth 10 score cp 31 pv e2e4\n")
+			<< 31;
+		QTest::newRow((mode + "mate").constData())
+			<< interval
+			<< QByteArray("info depth 10 score mate 3 pv e2e4\n")
+			<< 29995;
+		QTest::newRow((mode + "trailing lowerbound").constData())
+			<< interval
+			<< QByteArray("info depth 10 score cp 25 pv e2e4\n"
+				      "info depth 11 score cp 31 lowerbound "
+				      "nodes 5092342 pv e2e4\n")
+			<< 25;
+		QTest::newRow((mode + "trailing upperbound").constData())
+			<< interval
+			<< QByteArray("info depth 10 score cp 25 pv e2e4\n"
+				      "info depth 11 score cp 12 upperbound\n")
+			<< 25;
+	}
+}
+
+void tst_UciEngine::score()
+{
+	QFETCH(int, infoInterval);
+	QFETCH(QByteArray, info);
+	QFETCH(int, score);
+
+	EngineConfiguration config("Mock", "mock", "uci");
+	config.setInfoInterval(infoInterval);
+
+	UciEngine engine;
+	UciEngine opponent;
+	UciDevice* device = new UciDevice;
+	engine.setDevice(device);
+	engine.applyConfiguration(config);
+	engine.setTimeControl(TimeControl("inf"));
+	engine.start();
+	QTRY_VERIFY(engine.state() == ChessPlayer::Idle && engine.isReady());
+
+	Chess::Board* board = Chess::BoardFactory::create("standard");
+	QVERIFY(board != 0);
+	QVERIFY(board->setFenString(board->defaultFenString()));
+
+	engine.newGame(Chess::Side::White, &opponent, board);
+	engine.go();
+	QTRY_VERIFY(engine.state() == ChessPlayer::Thinking
+		    && engine.isReady());
+
+	device->replay(info + "bestmove e2e4\n");
+	QTRY_VERIFY(engine.state() != ChessPlayer::Thinking);
+	QCOMPARE(engine.evaluation().score(), score);
+
+	engine.endGame(Chess::Result());
+	QTRY_VERIFY(engine.state() == ChessPlayer::Idle);
+	delete board;
+}
+
+QTEST_MAIN(tst_UciEngine)
+#include "tst_uciengine.moc"
@@ -0,0 +1,4 @@
+include(../tests.pri)
+
+TARGET = tst_uciengine
+SOURCES += tst_uciengine.cpp
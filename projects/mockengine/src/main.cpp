@@ -0,0 +1,107 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <ctime>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+#include <mersenne.h>
+#include "mockengine.h"
+
+static void printUsage()
+{
+	QTextStream out(stdout);
+	out << "Usage: cutechess-mockengine [-info N] [-seed N] [-cpulog FILE]\n"
+	       "  -info N\tSend N info lines before each move\n"
+	       "  -seed N\tSet the seed for choosing moves to N\n"
+	       "  -cpulog FILE\tAppend the used CPU time in seconds and the\n"
+	       "\t\tnumber of moves played to FILE on exit\n";
+}
+
+int main(int argc, char* argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	int infoLines = 0;
+	uint seed = QDateTime::currentDateTime().toTime_t()
+		  ^ uint(QCoreApplication::applicationPid());
+	QString cpuLogFile;
+
+	QStringList args(app.arguments());
+	args.removeFirst();
+	for (int i = 0; i < args.size(); i++)
+	{
+		const QString& name = args.at(i);
+		bool ok = (i + 1 < args.size());
+		const QString value(args.value(++i));
+
+		if (ok && name == "-info")
+			infoLines = value.toInt(&ok);
+		else if (ok && name == "-seed")
+			seed = value.toUInt(&ok);
+		else if (ok && name == "-cpulog")
+			cpuLogFile = value;
+		else
+			ok = false;
+
+		if (!ok)
+		{
+			printUsage();
+			return 1;
+		}
+	}
+	Mersenne::initialize(int(seed));
+
+	QFile input;
+	QFile output;
+	if (!input.open(stdin, QIODevice::ReadOnly | QIODevice::Unbuffered)
+	||  !output.open(stdout, QIODevice::WriteOnly))
+		return 1;
+
+	MockEngine engine(&output);
+	engine.setInfoLineCount(infoLines);
+
+	forever
+	{
+		const QByteArray line(input.readLine());
+		if (line.isEmpty())
+			break;
+
+		bool ok = engine.processCommand(line);
+		engine.flush();
+		if (!ok)
+			break;
+	}
+
+	if (!cpuLogFile.isEmpty())
+	{
+		// Written with a single call so that concurrent engines
+		// don't mix up their lines
+		QFile log(cpuLogFile);
+		if (log.open(QIODevice::WriteOnly | QIODevice::Append
+			   | QIODevice::Text | QIODevice::Unbuffered))
+		{
+			const double cpu = double(std::clock()) / CLOCKS_PER_SEC;
+			log.write(QString("%1 %2\n").arg(cpu, 0, 'f', 4)
+				  .arg(engine.moveCount()).toLatin1());
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,266 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "mockengine.h"
+#include <QFile>
+#include <QStringList>
+#include <mersenne.h>
+#include <board/board.h>
+#include <board/boardfactory.h>
+
+MockEngine::MockEngine(QFile* output)
+	: m_protocol(NoProtocol),
+	  m_infoLineCount(0),
+	  m_moveCount(0),
+	  m_force(false),
+	  m_post(false),
+	  m_side(Chess::Side::Black),
+	  m_board(Chess::BoardFactory::create("standard")),
+	  m_output(output)
+{
+	Q_ASSERT(m_board != 0);
+	Q_ASSERT(m_output != 0);
+
+	resetBoard();
+}
+
+MockEngine::~MockEngine()
+{
+	delete m_board;
+}
+
+void MockEngine::setInfoLineCount(int count)
+{
+	m_infoLineCount = count;
+}
+
+int MockEngine::moveCount() const
+{
+	return m_moveCount;
+}
+
+void MockEngine::write(const QString& line)
+{
+	m_buffer += line.toLatin1();
+	m_buffer += '\n';
+}
+
+void MockEngine::flush()
+{
+	if (m_buffer.isEmpty())
+		return;
+
+	m_output->write(m_buffer);
+	m_output->flush();
+	m_buffer.clear();
+}
+
+bool MockEngine::resetBoard(const QString& fen)
+{
+	m_position.clear();
+	return m_board->setFenString(fen.isEmpty() ?
+				     m_board->defaultFenString() : fen);
+}
+
+bool MockEngine::makeMove(const QString& moveString)
+{
+	Chess::Move move(m_board->moveFromString(moveString));
+	if (move.isNull() || !m_board->isLegalMove(move))
+		return false;
+
+	m_board->makeMove(move);
+	return true;
+}
+
+void MockEngine::setPosition(const QString& line)
+{
+	QStringList moves;
+
+	// Usually the new position is the previous one plus a move or
+	// two, so only the new moves are played on the board.
+	if (!m_position.isEmpty() && line.startsWith(m_position + ' '))
+	{
+		moves = line.mid(m_position.size() + 1).split(' ', QString::SkipEmptyParts);
+		if (!moves.isEmpty() && moves.first() == "moves")
+			moves.removeFirst();
+	}
+	else
+	{
+		const QStringList args(line.split(' ', QString::SkipEmptyParts));
+		int movesIndex = args.indexOf("moves");
+		if (movesIndex == -1)
+			movesIndex = args.size();
+
+		QString fen;
+		if (args.value(1) == "fen")
+			fen = QStringList(args.mid(2, movesIndex - 2)).join(" ");
+		if (!resetBoard(fen))
+			return;
+		moves = args.mid(movesIndex + 1);
+	}
+
+	m_position = line;
+	foreach (const QString& move, moves)
+	{
+		if (!makeMove(move))
+			break;
+	}
+}
+
+void MockEngine::go()
+{
+	const QVector<Chess::Move> moves(m_board->legalMoves());
+	if (moves.isEmpty())
+	{
+		if (m_protocol == Uci)
+			write("bestmove 0000");
+		return;
+	}
+
+	const Chess::Move move(moves.at(Mersenne::random() % moves.size()));
+	const QString str(m_board->moveString(move, Chess::Board::LongAlgebraic));
+
+	for (int i = 1; i <= m_infoLineCount; i++)
+	{
+		if (m_protocol == Uci)
+			write(QString("info depth %1 score cp %2 nodes %3 time %4 pv %5")
+			      .arg(i).arg(i % 50).arg(i * 1000).arg(i).arg(str));
+		else if (m_post)
+			write(QString("%1 %2 %3 %4 %5")
+			      .arg(i).arg(i % 50).arg(i / 10).arg(i * 1000).arg(str));
+	}
+
+	m_moveCount++;
+	if (m_protocol == Uci)
+		write("bestmove " + str);
+	else
+	{
+		m_board->makeMove(move);
+		write("move " + str);
+	}
+}
+
+bool MockEngine::processCommand(const QByteArray& line)
+{
+	const QString str(QString::fromLatin1(line).trimmed());
+	QStringList args(str.split(' ', QString::SkipEmptyParts));
+	if (args.isEmpty())
+		return true;
+
+	const QString command(args.takeFirst());
+	if (command == "quit")
+		return false;
+
+	if (m_protocol == NoProtocol)
+	{
+		if (command == "uci")
+			m_protocol = Uci;
+		else if (command == "xboard")
+			m_protocol = Xboard;
+		else
+			return true;
+	}
+
+	if (m_protocol == Uci)
+	{
+		if (command == "position")
+			setPosition(str);
+		else
+			return processUciCommand(command, args);
+	}
+	else
+		return processXboardCommand(command, args);
+
+	return true;
+}
+
+bool MockEngine::processUciCommand(const QString& command,
+				   const QStringList& args)
+{
+	if (command == "uci")
+	{
+		write("id name Cute Chess Mock Engine");
+		write("id author Cute Chess developers");
+		write(QString("option name InfoLines type spin default %1 min 0 max 100000")
+		      .arg(m_infoLineCount));
+		write("uciok");
+	}
+	else if (command == "isready")
+		write("readyok");
+	else if (command == "go")
+		go();
+	else if (command == "ucinewgame")
+		resetBoard();
+	else if (command == "setoption")
+	{
+		// setoption name InfoLines value N
+		if (args.size() == 4 && args.at(1) == "InfoLines")
+			setInfoLineCount(qMax(0, args.at(3).toInt()));
+	}
+
+	return true;
+}
+
+bool MockEngine::processXboardCommand(const QString& command,
+				      const QStringList& args)
+{
+	if (command == "protover")
+	{
+		write("feature ping=1 setboard=1 usermove=1 colors=0 "
+		      "sigint=0 sigterm=0 reuse=1 name=0 "
+		      "myname=\"Cute Chess Mock Engine\" variants=\"normal\"");
+		write("feature done=1");
+	}
+	else if (command == "ping")
+		write("pong " + args.value(0));
+	else if (command == "new")
+	{
+		resetBoard();
+		m_force = false;
+		m_side = Chess::Side::Black;
+	}
+	else if (command == "setboard")
+		resetBoard(args.join(" "));
+	else if (command == "force")
+		m_force = true;
+	else if (command == "go")
+	{
+		m_force = false;
+		m_side = m_board->sideToMove();
+		go();
+	}
+	else if (command == "usermove")
+	{
+		if (makeMove(args.value(0))
+		&&  !m_force
+		&&  m_board->sideToMove() == m_side)
+			go();
+	}
+	else if (command == "undo")
+		m_board->undoMove();
+	else if (command == "remove")
+	{
+		m_board->undoMove();
+		m_board->undoMove();
+	}
+	else if (command == "post")
+		m_post = true;
+	else if (command == "nopost")
+		m_post = false;
+
+	return true;
+}
@@ -0,0 +1,96 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MOCKENGINE_H
+#define MOCKENGINE_H
+
+#include <QByteArray>
+#include <QString>
+#include <board/side.h>
+
+class QFile;
+class QStringList;
+namespace Chess { class Board; }
+
+/*!
+ * \brief A UCI and Xboard engine that replies instantly.
+ *
+ * MockEngine picks a random legal move as soon as it's asked to
+ * move and answers pings and readiness checks immediately. It's
+ * meant for measuring the overhead of the GUI or cutechess-cli
+ * apart from the thinking time of real engines.
+ *
+ * The protocol is chosen by the first command: "uci" or "xboard".
+ * Replies are buffered until flush() is called.
+ */
+class MockEngine
+{
+	public:
+		/*! Creates a new engine that writes its replies to \a output. */
+		MockEngine(QFile* output);
+		/*! Destroys the engine. */
+		~MockEngine();
+
+		/*!
+		 * Sets the number of "info" lines (or thinking output
+		 * lines in Xboard mode) sent before each move to \a count.
+		 */
+		void setInfoLineCount(int count);
+		/*! Returns the number of moves the engine has played. */
+		int moveCount() const;
+
+		/*!
+		 * Processes the command in \a line.
+		 *
+		 * Returns false if the command was "quit"; otherwise
+		 * returns true.
+		 */
+		bool processCommand(const QByteArray& line);
+		/*! Writes the buffered replies to the output device. */
+		void flush();
+
+	private:
+		enum Protocol
+		{
+			NoProtocol,
+			Uci,
+			Xboard
+		};
+
+		bool processUciCommand(const QString& command,
+				       const QStringList& args);
+		bool processXboardCommand(const QString& command,
+					  const QStringList& args);
+		void setPosition(const QString& line);
+		bool resetBoard(const QString& fen = QString());
+		bool makeMove(const QString& moveString);
+		void go();
+		void write(const QString& line);
+
+		Protocol m_protocol;
+		int m_infoLineCount;
+		int m_moveCount;
+		bool m_force;
+		bool m_post;
+		Chess::Side m_side;
+		QString m_position;
+		Chess::Board* m_board;
+		QFile* m_output;
+		QByteArray m_buffer;
+};
+
+#endif // MOCKENGINE_H
@@ -0,0 +1,4 @@
+DEPENDPATH += $$PWD
+HEADERS += $$PWD/mockengine.h
+SOURCES += $$PWD/main.cpp \
+    $$PWD/mockengine.cpp
@@ -0,0 +1,22 @@
+TARGET = cutechess-perft
+DESTDIR = $$PWD
+
+include(../lib/lib.pri)
+
+OBJECTS_DIR = .obj/
+MOC_DIR = .moc/
+
+win32 {
+    CONFIG += console
+}
+
+mac {
+    CONFIG -= app_bundle
+}
+
+CONFIG += c++11
+
+QT = core
+
+# Code
+include(src/src.pri)
@@ -0,0 +1,256 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+#include <QVariant>
+#include <board/board.h>
+#include <board/boardfactory.h>
+#include <jsonserializer.h>
+#include "perft.h"
+#include "perfthash.h"
+#include "perftsuite.h"
+
+static void printUsage()
+{
+	QTextStream out(stdout);
+	out << "Usage: cutechess-perft [options]\n"
+	       "  -variant VARIANT\tUse VARIANT (default: standard)\n"
+	       "  -fen FEN\t\tCount the nodes of FEN instead of the\n"
+	       "\t\t\tvariant's starting position\n"
+	       "  -depth N\t\tCount the nodes to depth N (default: 4)\n"
+	       "  -suite [VARIANT]\tRun the built-in positions of VARIANT,\n"
+	       "\t\t\tor of all variants, and verify the node counts\n"
+	       "  -maxdepth N\t\tLimit the depth of the suite positions to N\n"
+	       "  -divide\t\tPrint the node count of each root move\n"
+	       "  -threads N\t\tUse N threads (default: all cores)\n"
+	       "  -split N\t\tSplit the top N plies into tasks (default: 2)\n"
+	       "  -hash MB\t\tUse a perft hash table of MB megabytes\n"
+	       "  -json\t\t\tPrint the results in JSON format\n";
+}
+
+int main(int argc, char* argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	QString variant("standard");
+	QString fen;
+	int depth = 4;
+	bool runSuite = false;
+	QString suiteVariant;
+	int maxDepth = 0;
+	bool divide = false;
+	int threads = 0;
+	int splitPlies = 2;
+	int hashSize = 0;
+	bool json = false;
+
+	QStringList args(app.arguments());
+	args.removeFirst();
+	for (int i = 0; i < args.size(); i++)
+	{
+		const QString& name = args.at(i);
+		bool ok = true;
+
+		if (name == "-divide")
+			divide = true;
+		else if (name == "-json")
+			json = true;
+		else if (name == "-suite")
+		{
+			runSuite = true;
+			if (i + 1 < args.size() && !args.at(i + 1).startsWith('-'))
+				suiteVariant = args.at(++i);
+		}
+		else if (i + 1 >= args.size())
+			ok = false;
+		else
+		{
+			const QString value(args.at(++i));
+			int number = value.toInt();
+
+			if (name == "-variant")
+				variant = value;
+			else if (name == "-fen")
+				fen = value;
+			else if (name == "-depth")
+				ok = (depth = number) > 0;
+			else if (name == "-maxdepth")
+				ok = (maxDepth = number) > 0;
+			else if (name == "-threads")
+				ok = (threads = number) > 0;
+			else if (name == "-split")
+				ok = (splitPlies = number) > 0;
+			else if (name == "-hash")
+			{
+				hashSize = value.toInt(&ok);
+				ok = ok && hashSize >= 0;
+			}
+			else
+				ok = false;
+		}
+
+		if (!ok)
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	QList<PerftPosition> positions;
+	if (runSuite)
+	{
+		positions = perftSuite(suiteVariant);
+		if (positions.isEmpty())
+		{
+			qWarning("No suite positions for variant %s",
+				 qPrintable(suiteVariant));
+			return 1;
+		}
+	}
+	else
+	{
+		PerftPosition pos;
+		pos.name = fen.isEmpty() ? "startpos" : "custom";
+		pos.variant = variant;
+		pos.fen = fen;
+		pos.depth = depth;
+		pos.nodes = 0;
+		positions.append(pos);
+	}
+
+	if (threads <= 0)
+		threads = qMax(1, QThread::idealThreadCount());
+
+	PerftHash* hash = 0;
+	if (hashSize > 0)
+		hash = new PerftHash(hashSize);
+
+	QTextStream out(stdout);
+	QVariantList results;
+	int failures = 0;
+
+	foreach (PerftPosition pos, positions)
+	{
+		Chess::Board* board = Chess::BoardFactory::create(pos.variant);
+		if (board == 0)
+		{
+			qWarning("Unknown variant: %s", qPrintable(pos.variant));
+			return 1;
+		}
+		if (pos.fen.isEmpty())
+			pos.fen = board->defaultFenString();
+		if (!board->setFenString(pos.fen))
+		{
+			qWarning("Invalid FEN string: %s", qPrintable(pos.fen));
+			delete board;
+			return 1;
+		}
+
+		// The expected node count is unknown below the suite depth
+		bool verify = runSuite;
+		if (maxDepth > 0 && pos.depth > maxDepth)
+		{
+			pos.depth = maxDepth;
+			verify = false;
+		}
+
+		// Keys of different variants aren't comparable
+		if (hash != 0)
+			hash->clear();
+
+		Perft perft(board, threads, hash);
+		perft.setSplitPlies(splitPlies);
+		delete board;
+
+		QElapsedTimer timer;
+		timer.start();
+		quint64 nodes = perft.run(pos.depth);
+		qint64 msecs = timer.elapsed();
+		double nps = double(nodes) * 1000.0 / qMax(msecs, qint64(1));
+
+		bool passed = !verify || nodes == pos.nodes;
+		if (!passed)
+			failures++;
+
+		if (json)
+		{
+			QVariantMap result;
+			result["name"] = pos.name;
+			result["variant"] = pos.variant;
+			result["fen"] = pos.fen;
+			result["depth"] = pos.depth;
+			result["nodes"] = nodes;
+			result["msecs"] = msecs;
+			result["nps"] = qRound64(nps);
+			if (verify)
+			{
+				result["expected"] = pos.nodes;
+				result["passed"] = passed;
+			}
+			if (divide)
+			{
+				QVariantList rootMoves;
+				foreach (const Perft::RootMove& move, perft.rootMoves())
+				{
+					QVariantMap map;
+					map["move"] = move.move;
+					map["nodes"] = move.nodes;
+					rootMoves.append(map);
+				}
+				result["divide"] = rootMoves;
+			}
+			results.append(result);
+			continue;
+		}
+
+		if (divide)
+		{
+			foreach (const Perft::RootMove& move, perft.rootMoves())
+				out << move.move << ' ' << move.nodes << '\n';
+			out << '\n';
+		}
+		out << pos.name << " (" << pos.variant << ") depth " << pos.depth
+		    << ": " << nodes << " nodes, " << msecs << " ms, "
+		    << qRound64(nps) << " nodes/s";
+		if (verify && passed)
+			out << ", passed";
+		else if (verify)
+			out << ", FAILED, expected " << pos.nodes;
+		out << '\n';
+		out.flush();
+	}
+
+	if (json)
+	{
+		QVariantMap data;
+		data["threads"] = threads;
+		data["hash"] = hashSize;
+		data["split"] = splitPlies;
+		data["results"] = results;
+
+		JsonSerializer serializer(data);
+		serializer.serialize(out);
+	}
+
+	delete hash;
+	return failures > 0 ? 1 : 0;
+}
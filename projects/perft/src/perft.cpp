@@ -0,0 +1,192 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "perft.h"
+#include <QThread>
+#include <board/board.h>
+#include "perfthash.h"
+
+class Perft::WorkerThread : public QThread
+{
+	public:
+		WorkerThread(Perft* perft)
+			: m_perft(perft) {}
+
+	protected:
+		virtual void run() { m_perft->work(); }
+
+	private:
+		Perft* m_perft;
+};
+
+Perft::Perft(const Chess::Board* board, int threadCount, PerftHash* hash)
+	: m_board(board->copy()),
+	  m_hash(hash),
+	  m_threadCount(threadCount),
+	  m_splitPlies(2),
+	  m_depth(0)
+{
+	Q_ASSERT(m_board != 0);
+
+	if (m_threadCount <= 0)
+		m_threadCount = qMax(1, QThread::idealThreadCount());
+}
+
+Perft::~Perft()
+{
+	delete m_board;
+}
+
+void Perft::setSplitPlies(int plies)
+{
+	m_splitPlies = qMax(1, plies);
+}
+
+int Perft::threadCount() const
+{
+	return m_threadCount;
+}
+
+QList<Perft::RootMove> Perft::rootMoves() const
+{
+	return m_rootMoves;
+}
+
+quint64 Perft::perft(Chess::Board* board, int depth)
+{
+	quint64 nodes = 0;
+	if (depth >= 2 && m_hash != 0 && m_hash->probe(board->key(), depth, &nodes))
+		return nodes;
+
+	QVector<Chess::Move> moves(board->legalMoves());
+	if (depth == 1 || moves.isEmpty())
+		return moves.size();
+
+	foreach (const Chess::Move& move, moves)
+	{
+		board->makeMove(move);
+		nodes += perft(board, depth - 1);
+		board->undoMove();
+	}
+
+	if (m_hash != 0)
+		m_hash->store(board->key(), depth, nodes);
+	return nodes;
+}
+
+void Perft::addTasks(Chess::Board* board,
+		     int rootIndex,
+		     QVector<Chess::Move>& moves,
+		     int plies)
+{
+	QVector<Chess::Move> legalMoves;
+	if (plies > 0)
+		legalMoves = board->legalMoves();
+
+	if (legalMoves.isEmpty())
+	{
+		Task task = { rootIndex, moves, 0 };
+		m_tasks.append(task);
+		return;
+	}
+
+	foreach (const Chess::Move& move, legalMoves)
+	{
+		moves.append(move);
+		board->makeMove(move);
+		addTasks(board, rootIndex, moves, plies - 1);
+		board->undoMove();
+		moves.pop_back();
+	}
+}
+
+void Perft::work()
+{
+	Chess::Board* board = m_board->copy();
+
+	forever
+	{
+		int i = m_nextTask.fetchAndAddOrdered(1);
+		if (i >= m_tasks.size())
+			break;
+
+		Task& task = m_tasks[i];
+		foreach (const Chess::Move& move, task.moves)
+			board->makeMove(move);
+
+		int depth = m_depth - task.moves.size();
+		if (depth > 0)
+			task.nodes = perft(board, depth);
+		else
+			task.nodes = 1;
+
+		for (int j = 0; j < task.moves.size(); j++)
+			board->undoMove();
+	}
+
+	delete board;
+}
+
+quint64 Perft::run(int depth)
+{
+	Q_ASSERT(depth > 0);
+
+	m_depth = depth;
+	m_tasks.clear();
+	m_rootMoves.clear();
+
+	// The last ply is never split because the leaf nodes are
+	// counted without making the moves. The root moves are always
+	// split, so at depth 1 each task is a single leaf node.
+	int splitPlies = qMin(m_splitPlies, depth - 1);
+	QVector<Chess::Move> rootMoves(m_board->legalMoves());
+	for (int i = 0; i < rootMoves.size(); i++)
+	{
+		const Chess::Move& move = rootMoves.at(i);
+		RootMove rootMove =
+			{ m_board->moveString(move, Chess::Board::LongAlgebraic), 0 };
+		m_rootMoves.append(rootMove);
+
+		QVector<Chess::Move> moves;
+		moves.append(move);
+		m_board->makeMove(move);
+		addTasks(m_board, i, moves, splitPlies - 1);
+		m_board->undoMove();
+	}
+
+	m_nextTask.fetchAndStoreOrdered(0);
+	QList<WorkerThread*> workers;
+	for (int i = 0; i < m_threadCount; i++)
+	{
+		WorkerThread* worker = new WorkerThread(this);
+		workers.append(worker);
+		worker->start();
+	}
+	foreach (WorkerThread* worker, workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+
+	quint64 nodes = 0;
+	foreach (const Task& task, m_tasks)
+	{
+		m_rootMoves[task.rootIndex].nodes += task.nodes;
+		nodes += task.nodes;
+	}
+	return nodes;
+}
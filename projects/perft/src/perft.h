@@ -0,0 +1,106 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QAtomicInt>
+#include <board/move.h>
+
+namespace Chess { class Board; }
+class PerftHash;
+
+/*!
+ * \brief A multi-threaded perft (move path enumeration) counter.
+ *
+ * Perft counts the leaf nodes of the legal move tree of a position
+ * to a fixed depth. It's used for verifying and benchmarking the
+ * move generators of the Chess::Board classes.
+ *
+ * The tree is split into tasks at the top plies: each task is a
+ * sequence of moves from the root position. Worker threads take the
+ * next unfinished task from a shared queue, so threads that finish
+ * small subtrees early keep taking work from the others.
+ */
+class Perft
+{
+	public:
+		/*! The node count of a root move. */
+		struct RootMove
+		{
+			/*! The move in long algebraic notation. */
+			QString move;
+			/*! The number of leaf nodes after the move. */
+			quint64 nodes;
+		};
+
+		/*!
+		 * Creates a new Perft object for the position of \a board.
+		 *
+		 * \a threadCount is the number of worker threads; if it's
+		 * zero or less, QThread::idealThreadCount() is used.
+		 * \a hash is an optional hash table shared by the workers.
+		 */
+		Perft(const Chess::Board* board,
+		      int threadCount = 0,
+		      PerftHash* hash = 0);
+		/*! Destroys the Perft object. */
+		~Perft();
+
+		/*!
+		 * Sets the number of plies that are split into tasks
+		 * to \a plies. The default is 2.
+		 */
+		void setSplitPlies(int plies);
+		/*! Returns the number of worker threads. */
+		int threadCount() const;
+
+		/*! Counts the leaf nodes at \a depth and returns the count. */
+		quint64 run(int depth);
+		/*! Returns the node counts of the root moves of the last run. */
+		QList<RootMove> rootMoves() const;
+
+	private:
+		struct Task
+		{
+			int rootIndex;
+			QVector<Chess::Move> moves;
+			quint64 nodes;
+		};
+		class WorkerThread;
+
+		void addTasks(Chess::Board* board,
+			      int rootIndex,
+			      QVector<Chess::Move>& moves,
+			      int plies);
+		void work();
+		quint64 perft(Chess::Board* board, int depth);
+
+		Chess::Board* m_board;
+		PerftHash* m_hash;
+		int m_threadCount;
+		int m_splitPlies;
+		int m_depth;
+		QVector<Task> m_tasks;
+		QAtomicInt m_nextTask;
+		QList<RootMove> m_rootMoves;
+};
+
+#endif // PERFT_H
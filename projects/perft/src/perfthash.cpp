@@ -0,0 +1,82 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "perfthash.h"
+#include <QMutexLocker>
+
+PerftHash::PerftHash(int sizeMb)
+	: m_mask(0)
+{
+	Q_ASSERT(sizeMb > 0);
+
+	// Use the largest power of two that fits in the given size
+	quint64 bytes = quint64(sizeMb) * 1024 * 1024;
+	quint64 count = 1;
+	while (count * 2 * sizeof(Entry) <= bytes)
+		count *= 2;
+
+	m_mask = count - 1;
+	m_entries.resize(int(count));
+	clear();
+}
+
+int PerftHash::size() const
+{
+	return m_entries.size();
+}
+
+QMutex* PerftHash::lock(int index)
+{
+	return &m_locks[index % StripeCount];
+}
+
+bool PerftHash::probe(quint64 key, int depth, quint64* nodes)
+{
+	Q_ASSERT(nodes != 0);
+
+	int index = int(key & m_mask);
+	QMutexLocker locker(lock(index));
+
+	const Entry& entry = m_entries.at(index);
+	if (entry.key != key || entry.depth != depth)
+		return false;
+
+	*nodes = entry.nodes;
+	return true;
+}
+
+void PerftHash::store(quint64 key, int depth, quint64 nodes)
+{
+	int index = int(key & m_mask);
+	QMutexLocker locker(lock(index));
+
+	Entry& entry = m_entries[index];
+	entry.key = key;
+	entry.nodes = nodes;
+	entry.depth = depth;
+}
+
+void PerftHash::clear()
+{
+	for (int i = 0; i < m_entries.size(); i++)
+	{
+		Entry& entry = m_entries[i];
+		entry.key = 0;
+		entry.nodes = 0;
+		entry.depth = 0;
+	}
+}
@@ -0,0 +1,76 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PERFTHASH_H
+#define PERFTHASH_H
+
+#include <QVector>
+#include <QMutex>
+
+/*!
+ * \brief A hash table for perft node counts.
+ *
+ * PerftHash stores the node counts of subtrees by the Zobrist key of
+ * the position and the remaining depth, so that transpositions are
+ * only counted once. The table can be shared by several threads; it
+ * is divided into stripes that each have their own lock.
+ *
+ * Entries are always replaced, so the table never needs clearing
+ * between runs of the same variant.
+ */
+class PerftHash
+{
+	public:
+		/*!
+		 * Creates a new hash table that uses at most \a sizeMb
+		 * megabytes of memory.
+		 */
+		explicit PerftHash(int sizeMb);
+
+		/*! Returns the number of entries in the table. */
+		int size() const;
+		/*!
+		 * Looks up the node count of the position with key \a key
+		 * at depth \a depth.
+		 *
+		 * Returns true and sets \a nodes if the entry is found;
+		 * otherwise returns false.
+		 */
+		bool probe(quint64 key, int depth, quint64* nodes);
+		/*! Stores \a nodes for the position \a key at \a depth. */
+		void store(quint64 key, int depth, quint64 nodes);
+		/*! Removes all entries from the table. */
+		void clear();
+
+	private:
+		enum { StripeCount = 256 };
+
+		struct Entry
+		{
+			quint64 key;
+			quint64 nodes;
+			int depth;
+		};
+
+		QMutex* lock(int index);
+
+		quint64 m_mask;
+		QVector<Entry> m_entries;
+		QMutex m_locks[StripeCount];
+};
+
+#endif // PERFTHASH_H
@@ -0,0 +1,98 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "perftsuite.h"
+
+namespace {
+
+struct SuiteEntry
+{
+	const char* name;
+	const char* variant;
+	const char* fen;
+	int depth;
+	quint64 nodes;
+};
+
+// Keep in sync with tst_Board::perft_data()
+const SuiteEntry s_suite[] =
+{
+	{ "startpos", "standard",
+	  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+	  5, Q_UINT64_C(4865609) },
+	{ "pos2", "standard",
+	  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+	  4, Q_UINT64_C(4085603) },
+	{ "pos3", "standard",
+	  "8/3K4/2p5/p2b2r1/5k2/8/8/1q6 b - -",
+	  2, Q_UINT64_C(279) },
+	{ "pos4", "standard",
+	  "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+	  6, Q_UINT64_C(11030083) },
+	{ "pos5", "standard",
+	  "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+	  3, Q_UINT64_C(62379) },
+	{ "pos6", "standard",
+	  "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+	  3, Q_UINT64_C(89890) },
+	{ "gothic startpos", "capablanca",
+	  "rnbqckabnr/pppppppppp/10/10/10/10/PPPPPPPPPP/RNBQCKABNR w KQkq - 0 1",
+	  4, Q_UINT64_C(808984) },
+	{ "goth2", "capablanca",
+	  "r1b1c2rk1/p4a1ppp/1ppq2pn2/3p1p4/3A1Pn3/1PN3PN2/P1PQP1BPPP/3RC2RK1 w - -",
+	  4, Q_UINT64_C(7917813) },
+	{ "goth3", "capablanca",
+	  "r1b2k2nr/p1ppq1ppbp/n1Pcpa2p1/5p4/5P4/1p1PBCPN2/PP1QP1BPPP/RN3KA2R w KQkq -",
+	  4, Q_UINT64_C(4869569) },
+	{ "frc1", "fischerandom",
+	  "1rk3r1/8/8/8/8/8/8/1RK1R3 w EBgb -",
+	  2, Q_UINT64_C(464) },
+	{ "frc2", "fischerandom",
+	  "bnrbnkrq/pppppppp/8/8/8/8/PPPPPPPP/BNRBNKRQ w KQkq - 0 1",
+	  4, Q_UINT64_C(233585) },
+	{ "frc3", "fischerandom",
+	  "2rkr3/5PP1/8/5Q2/5q2/8/5pp1/2RKR3 w KQkq - 0 1",
+	  3, Q_UINT64_C(71005) },
+	{ "crazyhouse startpos", "crazyhouse",
+	  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - KQkq - 0 1",
+	  5, Q_UINT64_C(4888832) }
+};
+
+} // anonymous namespace
+
+QList<PerftPosition> perftSuite(const QString& variant)
+{
+	QList<PerftPosition> positions;
+	int count = int(sizeof(s_suite) / sizeof(s_suite[0]));
+
+	for (int i = 0; i < count; i++)
+	{
+		const SuiteEntry& entry = s_suite[i];
+		if (!variant.isEmpty() && variant != entry.variant)
+			continue;
+
+		PerftPosition pos;
+		pos.name = entry.name;
+		pos.variant = entry.variant;
+		pos.fen = entry.fen;
+		pos.depth = entry.depth;
+		pos.nodes = entry.nodes;
+		positions.append(pos);
+	}
+
+	return positions;
+}
@@ -0,0 +1,49 @@
+/*
+    This file is part of Cute Chess.
+
+    Cute Chess is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Cute Chess is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Cute Chess.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PERFTSUITE_H
+#define PERFTSUITE_H
+
+#include <QList>
+#include <QString>
+
+/*!
+ * \brief A perft test position with a known node count.
+ *
+ * The positions are the same ones that the board unit tests use.
+ */
+struct PerftPosition
+{
+	/*! The name of the position. */
+	QString name;
+	/*! The chess variant. */
+	QString variant;
+	/*! The position in FEN notation. */
+	QString fen;
+	/*! The depth of the perft run. */
+	int depth;
+	/*! The correct node count at \a depth. */
+	quint64 nodes;
+};
+
+/*!
+ * Returns the built-in perft positions of \a variant, or all
+ * positions if \a variant is empty.
+ */
+QList<PerftPosition> perftSuite(const QString& variant = QString());
+
+#endif // PERFTSUITE_H
@@ -0,0 +1,8 @@
+DEPENDPATH += $$PWD
+HEADERS += $$PWD/perft.h \
+    $$PWD/perfthash.h \
+    $$PWD/perftsuite.h
+SOURCES += $$PWD/main.cpp \
+    $$PWD/perft.cpp \
+    $$PWD/perfthash.cpp \
+    $$PWD/perftsuite.cpp
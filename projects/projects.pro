@@ -1,4 +1,4 @@
 CONFIG += ordered
 
 TEMPLATE = subdirs
-SUBDIRS = lib gui cli
+SUBDIRS = lib gui cli mockengine perft
@@ -0,0 +1,98 @@
+#!/usr/bin/python
+# -*- coding: utf-8 -*-
+
+"""
+Usage: mockbench.py [options]
+Measure the overhead of cutechess-cli with instantly moving engines.
+
+The script plays a match between two cutechess-mockengine instances at
+each of the given concurrency levels and prints a table with:
+  games/s	Games played per second of wall-clock time
+  moves/s	Moves played per second of wall-clock time
+  us/move	CPU time used by cutechess-cli itself per move, in microseconds
+
+The CPU time of cutechess-cli is the total CPU time of the run minus the
+time the mock engines report in their CPU logs. Run with --help for the
+list of options.
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import subprocess
+import tempfile
+import time
+
+
+def run_match(args, concurrency):
+	fd, cpulog = tempfile.mkstemp(prefix='mockbench', suffix='.log')
+	os.close(fd)
+
+	engine = ['cmd=' + args.engine,
+		  'arg=-info', 'arg=%d' % args.info,
+		  'arg=-cpulog', 'arg=' + cpulog]
+	command = [args.cli,
+		   '-engine', 'name=Mock1'] + engine + [
+		   '-engine', 'name=Mock2'] + engine + [
+		   '-each', 'proto=' + args.protocol, 'tc=' + args.tc,
+		   '-games', str(args.games),
+		   '-concurrency', str(concurrency)]
+	if args.threadpool > 0:
+		command += ['-threadpool', str(args.threadpool)]
+
+	start = time.time()
+	devnull = open(os.devnull, 'w')
+	process = subprocess.Popen(command, stdout=devnull)
+	rusage = os.wait4(process.pid, 0)[2]
+	elapsed = time.time() - start
+	devnull.close()
+
+	engine_cpu = 0.0
+	moves = 0
+	with open(cpulog) as f:
+		for line in f:
+			fields = line.split()
+			if len(fields) == 2:
+				engine_cpu += float(fields[0])
+				moves += int(fields[1])
+	os.remove(cpulog)
+
+	# The rusage of cutechess-cli includes the engines it has waited for
+	cli_cpu = rusage.ru_utime + rusage.ru_stime - engine_cpu
+	return elapsed, moves, cli_cpu
+
+
+def main():
+	parser = argparse.ArgumentParser(
+		description='Measure the overhead of cutechess-cli.')
+	parser.add_argument('--cli', default='cutechess-cli',
+			    help='path to cutechess-cli')
+	parser.add_argument('--engine', default='cutechess-mockengine',
+			    help='path to cutechess-mockengine')
+	parser.add_argument('--protocol', default='uci',
+			    choices=['uci', 'xboard'])
+	parser.add_argument('--games', type=int, default=200,
+			    help='number of games per concurrency level')
+	parser.add_argument('--concurrency', default='1,2,4,8,16',
+			    help='comma-separated list of concurrency levels')
+	parser.add_argument('--threadpool', type=int, default=0,
+			    help='size of the thread pool (0: thread per game)')
+	parser.add_argument('--info', type=int, default=0,
+			    help='number of info lines per move')
+	parser.add_argument('--tc', default='10+0.1',
+			    help='time control of the games')
+	args = parser.parse_args()
+
+	print('concurrency\tgames/s\tmoves/s\tus/move')
+	for level in args.concurrency.split(','):
+		elapsed, moves, cli_cpu = run_match(args, int(level))
+		print('%s\t\t%.1f\t%.0f\t%.1f' % (
+		      level,
+		      args.games / elapsed,
+		      moves / elapsed,
+		      cli_cpu * 1e6 / moves if moves else 0.0))
+
+
+if __name__ == '__main__':
+	main()